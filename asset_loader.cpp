@@ -0,0 +1,128 @@
+#include "asset_loader.h"
+#include "model.h"
+#include "texture_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<std::shared_ptr<Model>> importQueue;     // waiting for a worker
+    std::deque<std::shared_ptr<Model>> uploadQueue;     // imported, waiting for the GL thread
+    std::shared_ptr<Model> uploading;                   // render thread only
+    std::vector<std::thread> workers;
+    unsigned int importing = 0;
+    bool stopping = false;
+}
+
+void AssetLoader::start() {
+    // ObjLoader already fans out across cores for each file, so a couple of
+    // workers is enough to keep several files in flight
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int count = std::max(1u, std::min(2u, cores - 1));
+
+    stopping = false;
+    for (unsigned int i = 0; i < count; i++) {
+        workers.emplace_back(workerLoop);
+    }
+}
+
+void AssetLoader::workerLoop() {
+    while (true) {
+        std::shared_ptr<Model> model;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [] { return stopping || !importQueue.empty(); });
+            if (stopping) {
+                return;
+            }
+            model = importQueue.front();
+            importQueue.pop_front();
+            importing++;
+        }
+
+        model->import();
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        importing--;
+        uploadQueue.push_back(model);
+    }
+}
+
+void AssetLoader::enqueue(const std::shared_ptr<Model>& model) {
+    if (workers.empty()) {
+        start();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        importQueue.push_back(model);
+    }
+    queueCondition.notify_one();
+}
+
+void AssetLoader::update(double budgetMs) {
+    auto start = std::chrono::high_resolution_clock::now();
+    bool first = true;
+
+    // Textures dropped by models that were released since the last frame
+    TextureCache::deleteReleased();
+
+    while (first || std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count() < budgetMs) {
+        first = false;
+
+        if (!uploading) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (uploadQueue.empty()) {
+                return;
+            }
+            uploading = uploadQueue.front();
+            uploadQueue.pop_front();
+        }
+
+        if (uploading->uploadStep()) {
+            if (uploading->hasFailed()) {
+                std::cout << "Streaming failed: " << uploading->getPath() << std::endl;
+            }
+            else {
+                std::cout << "Streamed in: " << uploading->getPath()
+                    << " (" << pendingCount() << " still loading)" << std::endl;
+            }
+            uploading.reset();
+
+            if (pendingCount() == 0) {
+                TextureCache::printStats();
+            }
+        }
+    }
+}
+
+unsigned int AssetLoader::pendingCount() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return static_cast<unsigned int>(importQueue.size() + uploadQueue.size()) + importing;
+}
+
+void AssetLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+
+    // A worker in the middle of import() finishes that model first
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    importQueue.clear();
+    uploadQueue.clear();
+    uploading.reset();
+}
\ No newline at end of file
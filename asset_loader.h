@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+
+class Model;
+
+// Background model streaming.
+// Worker threads run Model::import() (file parsing, texture decoding); the
+// finished models queue up for the render thread, which calls update() once
+// per frame to create their GL buffers and textures within a time budget.
+// Anything drawing a Model checks Model::isReady() and shows a placeholder
+// (or nothing) until then.
+class AssetLoader {
+public:
+    // Queues a model created with deferLoad. Starts the workers on first use.
+    static void enqueue(const std::shared_ptr<Model>& model);
+
+    // Render thread only: uploads queued meshes until budgetMs is spent
+    // (always at least one mesh, so loading never stalls completely)
+    static void update(double budgetMs = 4.0);
+
+    // Models still importing or waiting for upload
+    static unsigned int pendingCount();
+
+    // Stops the workers; models that were still importing are dropped
+    static void shutdown();
+
+private:
+    static void start();
+    static void workerLoop();
+};
\ No newline at end of file
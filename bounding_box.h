@@ -0,0 +1,66 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cfloat>
+
+// Axis-aligned box. Built from local-space bounds, then update() moves it to
+// world space for a given transform.
+struct BoundingBox {
+    glm::vec3 min;
+    glm::vec3 max;
+    glm::vec3 center;
+    glm::vec3 size;
+
+    BoundingBox() : min(0.0f), max(0.0f), center(0.0f), size(0.0f) {}
+    BoundingBox(glm::vec3 min, glm::vec3 max) : min(min), max(max) {
+        center = (min + max) * 0.5f;
+        size = max - min;
+    }
+
+    void update(const glm::mat4& transform) {
+        // Transform all 8 corners of the box
+        glm::vec3 corners[8] = {
+            glm::vec3(min.x, min.y, min.z),
+            glm::vec3(max.x, min.y, min.z),
+            glm::vec3(min.x, max.y, min.z),
+            glm::vec3(max.x, max.y, min.z),
+            glm::vec3(min.x, min.y, max.z),
+            glm::vec3(max.x, min.y, max.z),
+            glm::vec3(min.x, max.y, max.z),
+            glm::vec3(max.x, max.y, max.z)
+        };
+
+        // Initialize transformed min/max
+        glm::vec3 transformedMin(FLT_MAX);
+        glm::vec3 transformedMax(-FLT_MAX);
+
+        // Transform each corner and find new bounds
+        for (int i = 0; i < 8; i++) {
+            glm::vec4 transformed = transform * glm::vec4(corners[i], 1.0f);
+            transformedMin = glm::min(transformedMin, glm::vec3(transformed));
+            transformedMax = glm::max(transformedMax, glm::vec3(transformed));
+        }
+
+        min = transformedMin;
+        max = transformedMax;
+        center = (min + max) * 0.5f;
+        size = max - min;
+    }
+
+    // Copy of a local-space box moved by transform
+    BoundingBox transformed(const glm::mat4& transform) const {
+        BoundingBox box = *this;
+        box.update(transform);
+        return box;
+    }
+
+    bool intersects(const BoundingBox& other) const {
+        return (min.x <= other.max.x && max.x >= other.min.x) &&
+            (min.y <= other.max.y && max.y >= other.min.y) &&
+            (min.z <= other.max.z && max.z >= other.min.z);
+    }
+
+    void draw() const {
+        // For debugging - draw wireframe box
+        // This is optional but useful for debugging collisions
+    }
+};
\ No newline at end of file
@@ -0,0 +1,469 @@
+#include "bvh.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace {
+    const float FAT_MARGIN = 0.25f;                 // Metres added on every side of a leaf
+    const float DISPLACEMENT_MULTIPLIER = 4.0f;     // Extra room ahead of a moving leaf, in frames of motion
+    const float REFIT_GROWTH_LIMIT = 1.5f;          // Parent area growth up to which a move refits instead of re-inserting
+
+    BoundingBox merge(const BoundingBox& a, const BoundingBox& b) {
+        return BoundingBox(glm::min(a.min, b.min), glm::max(a.max, b.max));
+    }
+
+    bool contains(const BoundingBox& outer, const BoundingBox& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+            outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+    }
+
+    // -1 entirely outside a plane, 1 entirely inside all of them, 0 straddling
+    int classifyFrustum(const BoundingBox& box, const glm::vec4* planes) {
+        int result = 1;
+        for (int i = 0; i < 6; i++) {
+            glm::vec3 normal(planes[i]);
+            glm::vec3 positive(normal.x >= 0.0f ? box.max.x : box.min.x,
+                normal.y >= 0.0f ? box.max.y : box.min.y,
+                normal.z >= 0.0f ? box.max.z : box.min.z);
+            if (glm::dot(normal, positive) + planes[i].w < 0.0f) {
+                return -1;
+            }
+            glm::vec3 negative(normal.x >= 0.0f ? box.min.x : box.max.x,
+                normal.y >= 0.0f ? box.min.y : box.max.y,
+                normal.z >= 0.0f ? box.min.z : box.max.z);
+            if (glm::dot(normal, negative) + planes[i].w < 0.0f) {
+                result = 0;
+            }
+        }
+        return result;
+    }
+
+    // Slab test; entry distance in tEnter
+    bool intersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection,
+        float maxDistance, float& tEnter) {
+        glm::vec3 t1 = (box.min - origin) * inverseDirection;
+        glm::vec3 t2 = (box.max - origin) * inverseDirection;
+        glm::vec3 tMin = glm::min(t1, t2);
+        glm::vec3 tMax = glm::max(t1, t2);
+        float enter = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+        float exit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+        tEnter = enter;
+        return enter <= exit;
+    }
+
+    glm::vec3 inverse(const glm::vec3& direction) {
+        // Axis-parallel rays get a huge rather than infinite reciprocal so 0 * inf can't make a NaN
+        return glm::vec3(direction.x != 0.0f ? 1.0f / direction.x : 1e30f,
+            direction.y != 0.0f ? 1.0f / direction.y : 1e30f,
+            direction.z != 0.0f ? 1.0f / direction.z : 1e30f);
+    }
+}
+
+Bvh::Bvh() : root(NULL_NODE), freeList(NULL_NODE), leafCount(0), refits(0), reinserts(0) {
+}
+
+float Bvh::surfaceArea(const BoundingBox& box) {
+    glm::vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+int Bvh::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.push_back(Node());
+        freeList = static_cast<int>(nodes.size()) - 1;
+        nodes[freeList].parent = NULL_NODE;
+    }
+    int index = freeList;
+    freeList = nodes[index].parent;
+
+    Node& node = nodes[index];
+    node.userData = nullptr;
+    node.category = 0;
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    return index;
+}
+
+void Bvh::freeNode(int index) {
+    nodes[index].parent = freeList;
+    nodes[index].height = -1;
+    freeList = index;
+}
+
+void Bvh::clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    leafCount = 0;
+}
+
+int Bvh::insert(const BoundingBox& box, void* userData, unsigned int category) {
+    int leaf = allocateNode();
+    nodes[leaf].tight = box;
+    nodes[leaf].box = BoundingBox(box.min - glm::vec3(FAT_MARGIN), box.max + glm::vec3(FAT_MARGIN));
+    nodes[leaf].userData = userData;
+    nodes[leaf].category = category;
+    insertLeaf(leaf);
+    leafCount++;
+    return leaf;
+}
+
+void Bvh::remove(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leafCount--;
+}
+
+bool Bvh::update(int proxy, const BoundingBox& box) {
+    glm::vec3 displacement = box.center - nodes[proxy].tight.center;
+    nodes[proxy].tight = box;
+    if (contains(nodes[proxy].box, box)) {
+        return false;
+    }
+
+    // Leave room in the direction of travel so a steadily moving car isn't
+    // updated again next frame
+    BoundingBox fat(box.min - glm::vec3(FAT_MARGIN), box.max + glm::vec3(FAT_MARGIN));
+    glm::vec3 lead = displacement * DISPLACEMENT_MULTIPLIER;
+    fat = BoundingBox(fat.min + glm::min(lead, glm::vec3(0.0f)), fat.max + glm::max(lead, glm::vec3(0.0f)));
+
+    // Close to where it was: grow the ancestors in place. Far away it would
+    // bloat every box up to the root, so it goes back in through the SAH.
+    int parent = nodes[proxy].parent;
+    if (parent != NULL_NODE &&
+        surfaceArea(merge(nodes[parent].box, fat)) > REFIT_GROWTH_LIMIT * surfaceArea(nodes[parent].box)) {
+        removeLeaf(proxy);
+        nodes[proxy].box = fat;
+        insertLeaf(proxy);
+        reinserts++;
+    }
+    else {
+        nodes[proxy].box = fat;
+        refitAncestors(parent);
+        refits++;
+    }
+    return true;
+}
+
+int Bvh::findBestSibling(const BoundingBox& box) const {
+    // Cost of pairing with a node: the new parent's area plus how much every
+    // ancestor grows. Subtrees whose lower bound can't beat the best are pruned.
+    float area = surfaceArea(box);
+    int best = root;
+    float bestCost = surfaceArea(merge(nodes[root].box, box));
+
+    std::vector<std::pair<int, float>> stack;
+    stack.push_back(std::make_pair(root, 0.0f));
+    while (!stack.empty()) {
+        int index = stack.back().first;
+        float inherited = stack.back().second;
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+        float direct = surfaceArea(merge(node.box, box));
+        float cost = direct + inherited;
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = index;
+        }
+
+        if (!node.isLeaf()) {
+            float childInherited = inherited + direct - surfaceArea(node.box);
+            if (area + childInherited < bestCost) {
+                stack.push_back(std::make_pair(node.child1, childInherited));
+                stack.push_back(std::make_pair(node.child2, childInherited));
+            }
+        }
+    }
+    return best;
+}
+
+void Bvh::insertLeaf(int leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    int sibling = findBestSibling(nodes[leaf].box);
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = merge(nodes[sibling].box, nodes[leaf].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    }
+    else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    }
+    else {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(oldParent);
+}
+
+void Bvh::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    }
+    else {
+        nodes[grandParent].child2 = sibling;
+    }
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+    refitAncestors(grandParent);
+}
+
+void Bvh::refitAncestors(int index) {
+    while (index != NULL_NODE) {
+        Node& node = nodes[index];
+        node.box = merge(nodes[node.child1].box, nodes[node.child2].box);
+        node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+        rotate(index);
+        index = nodes[index].parent;
+    }
+}
+
+void Bvh::rotate(int index) {
+    int b = nodes[index].child1;
+    int c = nodes[index].child2;
+    if (nodes[b].isLeaf() && nodes[c].isLeaf()) {
+        return;
+    }
+
+    // Swapping a child with one of its sibling's children only changes that
+    // sibling's box; take the swap that shrinks it the most
+    enum { NONE, B_F, B_G, C_D, C_E } bestRotation = NONE;
+    float bestDiff = 0.0f;
+
+    if (!nodes[c].isLeaf()) {
+        float areaC = surfaceArea(nodes[c].box);
+        int f = nodes[c].child1;
+        int g = nodes[c].child2;
+        float diff = surfaceArea(merge(nodes[b].box, nodes[g].box)) - areaC;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            bestRotation = B_F;
+        }
+        diff = surfaceArea(merge(nodes[b].box, nodes[f].box)) - areaC;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            bestRotation = B_G;
+        }
+    }
+    if (!nodes[b].isLeaf()) {
+        float areaB = surfaceArea(nodes[b].box);
+        int d = nodes[b].child1;
+        int e = nodes[b].child2;
+        float diff = surfaceArea(merge(nodes[c].box, nodes[e].box)) - areaB;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            bestRotation = C_D;
+        }
+        diff = surfaceArea(merge(nodes[c].box, nodes[d].box)) - areaB;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            bestRotation = C_E;
+        }
+    }
+
+    // (outer, inner-parent, inner): outer swaps places with inner
+    int outer, innerParent, inner;
+    switch (bestRotation) {
+    case B_F: outer = b; innerParent = c; inner = nodes[c].child1; break;
+    case B_G: outer = b; innerParent = c; inner = nodes[c].child2; break;
+    case C_D: outer = c; innerParent = b; inner = nodes[b].child1; break;
+    case C_E: outer = c; innerParent = b; inner = nodes[b].child2; break;
+    default: return;
+    }
+
+    if (nodes[index].child1 == outer) {
+        nodes[index].child1 = inner;
+    }
+    else {
+        nodes[index].child2 = inner;
+    }
+    if (nodes[innerParent].child1 == inner) {
+        nodes[innerParent].child1 = outer;
+    }
+    else {
+        nodes[innerParent].child2 = outer;
+    }
+    nodes[inner].parent = index;
+    nodes[outer].parent = innerParent;
+
+    Node& changed = nodes[innerParent];
+    changed.box = merge(nodes[changed.child1].box, nodes[changed.child2].box);
+    changed.height = 1 + std::max(nodes[changed.child1].height, nodes[changed.child2].height);
+    nodes[index].height = 1 + std::max(nodes[nodes[index].child1].height, nodes[nodes[index].child2].height);
+}
+
+void Bvh::collectLeaves(int index, std::vector<int>& results) const {
+    std::vector<int> stack(1, index);
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[current];
+        if (node.isLeaf()) {
+            results.push_back(current);
+        }
+        else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void Bvh::queryFrustum(const glm::vec4* planes, std::vector<int>& results) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+    std::vector<int> stack(1, root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+
+        if (node.isLeaf()) {
+            if (classifyFrustum(node.tight, planes) >= 0) {
+                results.push_back(index);
+            }
+            continue;
+        }
+
+        int side = classifyFrustum(node.box, planes);
+        if (side > 0) {
+            // Wholly inside: everything below is visible without more tests
+            collectLeaves(index, results);
+        }
+        else if (side == 0) {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void Bvh::queryOverlap(const BoundingBox& box, std::vector<int>& results) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+    std::vector<int> stack(1, root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        if (!node.box.intersects(box)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (node.tight.intersects(box)) {
+                results.push_back(index);
+            }
+        }
+        else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void Bvh::queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+    std::vector<int>& results) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+    glm::vec3 inverseDirection = inverse(direction);
+    std::vector<int> stack(1, root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        float t;
+        if (node.isLeaf()) {
+            if (intersectRay(node.tight, origin, inverseDirection, maxDistance, t)) {
+                results.push_back(index);
+            }
+        }
+        else if (intersectRay(node.box, origin, inverseDirection, maxDistance, t)) {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+int Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* hitDistance,
+    unsigned int categoryMask) const {
+    int best = NULL_NODE;
+    if (root == NULL_NODE) {
+        return best;
+    }
+    glm::vec3 inverseDirection = inverse(direction);
+    float bestDistance = maxDistance;
+
+    std::vector<int> stack(1, root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        float t;
+        if (node.isLeaf()) {
+            if ((categoryMask & (1u << node.category)) &&
+                intersectRay(node.tight, origin, inverseDirection, bestDistance, t)) {
+                best = index;
+                bestDistance = t;
+            }
+            continue;
+        }
+        // Anything entering beyond the current hit can't be nearer
+        if (intersectRay(node.box, origin, inverseDirection, bestDistance, t)) {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+
+    if (hitDistance && best != NULL_NODE) {
+        *hitDistance = bestDistance;
+    }
+    return best;
+}
+
+float Bvh::getSahCost() const {
+    if (root == NULL_NODE || nodes[root].isLeaf()) {
+        return 0.0f;
+    }
+    float rootArea = surfaceArea(nodes[root].box);
+    if (rootArea <= 0.0f) {
+        return 0.0f;
+    }
+    float total = 0.0f;
+    for (const auto& node : nodes) {
+        if (node.height > 0) {
+            total += surfaceArea(node.box);
+        }
+    }
+    return total / rootArea;
+}
\ No newline at end of file
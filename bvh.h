@@ -0,0 +1,81 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include "bounding_box.h"
+
+// Dynamic bounding-volume hierarchy over world-space boxes.
+// Leaves are inserted next to the sibling that adds the least surface area to
+// the tree (SAH branch and bound, Bittner et al.), and every node touched on
+// the way back up is rotated if that lowers the cost (Kopta et al.), so the
+// tree stays good however objects arrive and move. Leaves keep a slightly
+// enlarged box: small moves cost nothing, bigger ones refit the ancestors in
+// place and only moves far outside the old neighbourhood re-insert.
+class Bvh {
+public:
+    static const int NULL_NODE = -1;
+
+    Bvh();
+
+    // Returns the leaf's proxy id, stable until remove()
+    int insert(const BoundingBox& box, void* userData, unsigned int category = 0);
+    void remove(int proxy);
+    // Returns true if the tree had to change
+    bool update(int proxy, const BoundingBox& box);
+    void clear();
+
+    const BoundingBox& getBounds(int proxy) const { return nodes[proxy].tight; }
+    void* getUserData(int proxy) const { return nodes[proxy].userData; }
+    unsigned int getCategory(int proxy) const { return nodes[proxy].category; }
+
+    // Queries append leaf proxies to results. Leaves are tested with their
+    // exact box, not the enlarged one.
+    void queryFrustum(const glm::vec4* planes, std::vector<int>& results) const;   // 6 planes, xyz inward normal
+    void queryOverlap(const BoundingBox& box, std::vector<int>& results) const;
+    void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+        std::vector<int>& results) const;
+    // Nearest leaf box along the ray, or NULL_NODE. Only leaves whose
+    // category bit is set in categoryMask count.
+    int raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+        float* hitDistance = nullptr, unsigned int categoryMask = ~0u) const;
+
+    size_t getLeafCount() const { return leafCount; }
+    int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+    // Summed surface area of the internal nodes relative to the root's; lower is better
+    float getSahCost() const;
+    // Refits and re-inserts since the last reset
+    size_t getRefitCount() const { return refits; }
+    size_t getReinsertCount() const { return reinserts; }
+    void resetCounters() { refits = reinserts = 0; }
+
+    static float surfaceArea(const BoundingBox& box);
+
+private:
+    struct Node {
+        BoundingBox box;        // Leaves: enlarged
+        BoundingBox tight;      // Leaves only
+        void* userData;
+        unsigned int category;
+        int parent;             // Next free node while on the free list
+        int child1;
+        int child2;
+        int height;             // Leaves 0, free nodes -1
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int root;
+    int freeList;
+    size_t leafCount;
+    size_t refits;
+    size_t reinserts;
+
+    int allocateNode();
+    void freeNode(int index);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int findBestSibling(const BoundingBox& box) const;
+    void refitAncestors(int index);
+    void rotate(int index);
+    void collectLeaves(int index, std::vector<int>& results) const;
+};
\ No newline at end of file
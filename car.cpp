@@ -1,16 +1,20 @@
 #include "car.h"
 #include "model.h"  // Include model.h here, not in car.h
+#include "model_cache.h"
+#include "frustum_culler.h"
+#include "scene.h"
 #include <iostream>
 
 // Initialize with default color and no override
 Car::Car(const std::string& modelPath, glm::vec3 position)
     : position(position), rotationAngle(0.0f),
-    rotationAxis(0.0f, 1.0f, 0.0f), scale(1.0f),
+    rotationAxis(0.0f, 1.0f, 0.0f), scale(1.0f), worldBounds(position, position), boundsDirty(true), sceneProxy(-1),
     colorOverride(1.0f, 1.0f, 1.0f), useColorOverride(false) {  // ADD THIS
 
     try {
-        model = new Model(modelPath);
-        std::cout << "Car model loaded successfully from: " << modelPath << std::endl;
+        // Streams in the background; Draw() shows nothing until it is ready
+        model = ModelCache::acquireAsync(modelPath);
+        std::cout << "Car model queued from: " << modelPath << std::endl;
     }
     catch (const std::exception& e) {
         std::cout << "Failed to load car model: " << e.what() << std::endl;
@@ -19,8 +23,9 @@ Car::Car(const std::string& modelPath, glm::vec3 position)
 }
 
 Car::~Car() {
-    if (model) {
-        delete model;
+    // Model is released by the shared_ptr; ModelCache frees it with the last owner
+    if (sceneProxy >= 0) {
+        Scene::remove(sceneProxy);
     }
 }
 
@@ -41,9 +46,30 @@ void Car::EnableColorOverride(bool enable) {
     useColorOverride = enable;
 }
 
+bool Car::IsReady() const {
+    return model && model->isReady();
+}
+
+int Car::UpdateSceneProxy() {
+    if (boundsDirty && IsReady()) {
+        worldBounds = BoundingBox(model->getBoundsMin(), model->getBoundsMax());
+        worldBounds.update(GetModelMatrix());
+        boundsDirty = false;
+
+        if (sceneProxy < 0) {
+            sceneProxy = Scene::add(worldBounds, SCENE_CAR, this);
+        }
+        else {
+            Scene::move(sceneProxy, worldBounds);
+        }
+    }
+    return sceneProxy;
+}
+
 void Car::Draw(Shader& shader) {
-    if (model) {
-        shader.setMat4("model", GetModelMatrix());
+    if (IsReady() && FrustumCuller::isVisible(UpdateSceneProxy())) {
+        glm::mat4 modelMatrix = GetModelMatrix();
+        shader.setMat4("model", modelMatrix);
 
         // Pass color override to shader if enabled
         if (useColorOverride) {
@@ -54,21 +80,24 @@ void Car::Draw(Shader& shader) {
             shader.setBool("useColorOverride", false);
         }
 
-        model->Draw(shader);
+        model->Draw(shader, lod.select(*model, modelMatrix));
     }
 }
 
 void Car::SetPosition(glm::vec3 newPosition) {
     position = newPosition;
+    boundsDirty = true;
 }
 
 void Car::SetRotation(float angle, glm::vec3 axis) {
     rotationAngle = angle;
     rotationAxis = axis;
+    boundsDirty = true;
 }
 
 void Car::SetScale(glm::vec3 newScale) {
     scale = newScale;
+    boundsDirty = true;
 }
 
 glm::mat4 Car::GetModelMatrix() const {
@@ -1,7 +1,10 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <memory>
 #include "shader.h"
+#include "lod_selector.h"
+#include "bounding_box.h"
 
 // Forward declaration - don't include model.h if we only use pointer
 class Model;
@@ -10,6 +13,7 @@ class Car {
 public:
     Car(const std::string& modelPath, glm::vec3 position = glm::vec3(0.0f));
     ~Car();  // Add destructor!
+    // Skipped when the car is outside the view frustum (see FrustumCuller)
     void Draw(Shader& shader);
     void SetPosition(glm::vec3 position);
     void SetRotation(float angle, glm::vec3 axis = glm::vec3(0.0f, 1.0f, 0.0f));
@@ -17,6 +21,15 @@ public:
     float GetRotationAngle() const { return rotationAngle; }
     glm::vec3 GetPosition() const { return position; }
     glm::mat4 GetModelMatrix() const;
+    bool IsReady() const;  // False while the model is still streaming in
+
+    // World-space box of the model; empty (at the car's position) until the
+    // model is ready
+    const BoundingBox& GetWorldBounds() const { return worldBounds; }
+
+    // Recomputes the box after a transform change and adds or moves the car
+    // in the Scene. Returns the Scene proxy, -1 while the model is loading.
+    int UpdateSceneProxy();
 
     // ADD THESE METHODS FOR COLOR CONTROL
     void SetColor(glm::vec3 color);
@@ -26,11 +39,15 @@ public:
     bool IsColorOverrideEnabled() const { return useColorOverride; }
 
 private:
-    Model* model;  // Use pointer since Model is incomplete type here
+    std::shared_ptr<Model> model;  // Shared through ModelCache with every other user of the same file
     glm::vec3 position;
     glm::vec3 rotationAxis;
     float rotationAngle;
     glm::vec3 scale;
+    LodSelector lod;
+    BoundingBox worldBounds;
+    bool boundsDirty;
+    int sceneProxy;
 
     // ADD THESE FOR COLOR CONTROL
     glm::vec3 colorOverride;
@@ -0,0 +1,337 @@
+#include "cooked_mesh.h"
+#include <cfloat>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+static_assert(sizeof(CookedMesh::Header) == 88, "CookedMesh::Header layout changed");
+static_assert(sizeof(CookedMesh::MeshEntry) == 80, "CookedMesh::MeshEntry layout changed");
+static_assert(sizeof(CookedMesh::TextureRef) == 16, "CookedMesh::TextureRef layout changed");
+
+namespace {
+    const char COOKED_MAGIC[4] = { 'C', 'M', 'S', 'H' };
+
+    uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+CookedMesh::CookedMesh() : header(nullptr) {
+}
+
+std::string CookedMesh::cachePathFor(const std::string& sourcePath) {
+    return sourcePath + ".cmesh";
+}
+
+bool CookedMesh::describeSource(const std::string& sourcePath, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, ec));
+    if (ec) return false;
+
+    auto writeTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+
+    mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+uint64_t CookedMesh::hashFile(const std::string& path) {
+    MappedFile source;
+    if (!source.open(path)) {
+        return 0;
+    }
+    return fnv1a(source.data(), source.size());
+}
+
+bool CookedMesh::open(const std::string& sourcePath) {
+    close();
+
+    std::string cookedPath = cachePathFor(sourcePath);
+    if (!file.open(cookedPath)) {
+        return false;
+    }
+
+    if (file.size() < sizeof(Header)) {
+        std::cout << "Cooked mesh too small, ignoring: " << cookedPath << std::endl;
+        close();
+        return false;
+    }
+
+    header = reinterpret_cast<const Header*>(file.data());
+
+    if (!validate(sourcePath)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void CookedMesh::close() {
+    header = nullptr;
+    file.close();
+}
+
+bool CookedMesh::validate(const std::string& sourcePath) const {
+    if (std::memcmp(header->magic, COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0 ||
+        header->version != FORMAT_VERSION ||
+        header->vertexStride != sizeof(Vertex)) {
+        std::cout << "Cooked mesh has an old format, re-importing: " << sourcePath << std::endl;
+        return false;
+    }
+
+    // Every table and blob must lie inside the file
+    uint64_t tablesEnd = sizeof(Header) +
+        uint64_t(header->meshCount) * sizeof(MeshEntry) +
+        uint64_t(header->textureRefCount) * sizeof(TextureRef);
+    if (tablesEnd > file.size() ||
+        header->stringTableOffset + header->stringTableSize > file.size()) {
+        std::cout << "Cooked mesh is truncated, re-importing: " << sourcePath << std::endl;
+        return false;
+    }
+    for (unsigned int i = 0; i < header->meshCount; i++) {
+        const MeshEntry& entry = getMeshEntry(i);
+        if (entry.vertexOffset + uint64_t(entry.vertexCount) * sizeof(Vertex) > file.size() ||
+            entry.indexOffset + uint64_t(entry.indexCount) * sizeof(unsigned int) > file.size() ||
+            entry.firstTexture + entry.textureCount > header->textureRefCount ||
+            entry.lodCount < 1 || entry.lodCount > MAX_LOD_LEVELS) {
+            std::cout << "Cooked mesh is truncated, re-importing: " << sourcePath << std::endl;
+            return false;
+        }
+        uint64_t lodIndexTotal = 0;
+        for (uint32_t level = 1; level < entry.lodCount; level++) {
+            lodIndexTotal += entry.lodIndexCounts[level - 1];
+        }
+        if (entry.lodIndexOffset + lodIndexTotal * sizeof(unsigned int) > file.size()) {
+            std::cout << "Cooked mesh is truncated, re-importing: " << sourcePath << std::endl;
+            return false;
+        }
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!describeSource(sourcePath, sourceSize, sourceMtime)) {
+        // Source is gone - the cooked file is all we have, so trust it
+        return true;
+    }
+
+    if (sourceSize != header->sourceSize) {
+        std::cout << "Source model changed size, re-importing: " << sourcePath << std::endl;
+        return false;
+    }
+
+    // Same size and timestamp: assume unchanged without reading the source.
+    // A different timestamp (fresh checkout, copied folder) falls back to the content hash.
+    if (sourceMtime != header->sourceMtime && hashFile(sourcePath) != header->sourceHash) {
+        std::cout << "Source model changed, re-importing: " << sourcePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+unsigned int CookedMesh::getMeshCount() const {
+    return header ? header->meshCount : 0;
+}
+
+const CookedMesh::MeshEntry& CookedMesh::getMeshEntry(unsigned int index) const {
+    const MeshEntry* entries = reinterpret_cast<const MeshEntry*>(file.data() + sizeof(Header));
+    return entries[index];
+}
+
+const Vertex* CookedMesh::getVertices(unsigned int index) const {
+    return reinterpret_cast<const Vertex*>(file.data() + getMeshEntry(index).vertexOffset);
+}
+
+const unsigned int* CookedMesh::getIndices(unsigned int index) const {
+    return reinterpret_cast<const unsigned int*>(file.data() + getMeshEntry(index).indexOffset);
+}
+
+const unsigned int* CookedMesh::getLodIndices(unsigned int index) const {
+    return reinterpret_cast<const unsigned int*>(file.data() + getMeshEntry(index).lodIndexOffset);
+}
+
+std::string CookedMesh::readString(uint32_t offset, uint32_t length) const {
+    if (uint64_t(offset) + length > header->stringTableSize) {
+        return std::string();
+    }
+    const char* table = reinterpret_cast<const char*>(file.data() + header->stringTableOffset);
+    return std::string(table + offset, length);
+}
+
+std::vector<Texture> CookedMesh::getTextureRefs(unsigned int index) const {
+    const MeshEntry& entry = getMeshEntry(index);
+    const TextureRef* refs = reinterpret_cast<const TextureRef*>(
+        file.data() + sizeof(Header) + header->meshCount * sizeof(MeshEntry));
+
+    std::vector<Texture> textures;
+    for (uint32_t i = 0; i < entry.textureCount; i++) {
+        const TextureRef& ref = refs[entry.firstTexture + i];
+        Texture texture;
+        texture.id = 0;
+        texture.type = readString(ref.typeOffset, ref.typeLength);
+        texture.path = readString(ref.pathOffset, ref.pathLength);
+        textures.push_back(texture);
+    }
+    return textures;
+}
+
+glm::vec3 CookedMesh::getBoundsMin() const {
+    return glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+}
+
+glm::vec3 CookedMesh::getBoundsMax() const {
+    return glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+}
+
+bool CookedMesh::write(const std::string& sourcePath, const std::vector<MeshData>& meshes) {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.vertexStride = sizeof(Vertex);
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+
+    if (!describeSource(sourcePath, header.sourceSize, header.sourceMtime)) {
+        return false;
+    }
+    header.sourceHash = hashFile(sourcePath);
+
+    // Build the mesh table, texture table and string table
+    std::vector<MeshEntry> entries(meshes.size());
+    std::vector<TextureRef> refs;
+    std::string strings;
+
+    glm::vec3 modelMin(FLT_MAX);
+    glm::vec3 modelMax(-FLT_MAX);
+
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const MeshData& mesh = meshes[i];
+        MeshEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+
+        entry.vertexCount = static_cast<uint32_t>(mesh.getVertexCount());
+        entry.indexCount = static_cast<uint32_t>(mesh.getIndexCount());
+        entry.firstTexture = static_cast<uint32_t>(refs.size());
+        entry.textureCount = static_cast<uint32_t>(mesh.textures.size());
+        entry.lodCount = mesh.lodCount;
+        for (uint32_t level = 1; level < mesh.lodCount; level++) {
+            entry.lodIndexCounts[level - 1] = mesh.lodIndexCounts[level - 1];
+        }
+
+        glm::vec3 meshMin(FLT_MAX);
+        glm::vec3 meshMax(-FLT_MAX);
+        const Vertex* vertices = mesh.getVertices();
+        for (size_t v = 0; v < mesh.getVertexCount(); v++) {
+            meshMin = glm::min(meshMin, vertices[v].Position);
+            meshMax = glm::max(meshMax, vertices[v].Position);
+        }
+        if (mesh.getVertexCount() == 0) {
+            meshMin = meshMax = glm::vec3(0.0f);
+        }
+
+        for (int axis = 0; axis < 3; axis++) {
+            entry.boundsMin[axis] = meshMin[axis];
+            entry.boundsMax[axis] = meshMax[axis];
+        }
+        modelMin = glm::min(modelMin, meshMin);
+        modelMax = glm::max(modelMax, meshMax);
+
+        for (const auto& texture : mesh.textures) {
+            TextureRef ref;
+            ref.typeOffset = static_cast<uint32_t>(strings.size());
+            ref.typeLength = static_cast<uint32_t>(texture.type.size());
+            strings += texture.type;
+            ref.pathOffset = static_cast<uint32_t>(strings.size());
+            ref.pathLength = static_cast<uint32_t>(texture.path.size());
+            strings += texture.path;
+            refs.push_back(ref);
+        }
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        header.boundsMin[axis] = meshes.empty() ? 0.0f : modelMin[axis];
+        header.boundsMax[axis] = meshes.empty() ? 0.0f : modelMax[axis];
+    }
+
+    header.textureRefCount = static_cast<uint32_t>(refs.size());
+    header.stringTableOffset = sizeof(Header) + entries.size() * sizeof(MeshEntry) + refs.size() * sizeof(TextureRef);
+    header.stringTableSize = strings.size();
+
+    // Lay out the geometry blobs after the tables
+    uint64_t offset = header.stringTableOffset + header.stringTableSize;
+    for (size_t i = 0; i < meshes.size(); i++) {
+        offset = alignUp(offset, 16);
+        entries[i].vertexOffset = offset;
+        offset += uint64_t(entries[i].vertexCount) * sizeof(Vertex);
+
+        offset = alignUp(offset, 16);
+        entries[i].indexOffset = offset;
+        offset += uint64_t(entries[i].indexCount) * sizeof(unsigned int);
+
+        offset = alignUp(offset, 16);
+        entries[i].lodIndexOffset = offset;
+        offset += uint64_t(meshes[i].getLodIndexTotal()) * sizeof(unsigned int);
+    }
+
+    // Write to a temporary file and rename, so a crash never leaves a half-written cache
+    std::string cookedPath = cachePathFor(sourcePath);
+    std::string tempPath = cookedPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cout << "Could not write cooked mesh: " << cookedPath << std::endl;
+            return false;
+        }
+
+        const char padding[16] = {};
+        auto padTo = [&](uint64_t target) {
+            uint64_t position = static_cast<uint64_t>(out.tellp());
+            if (target > position) {
+                out.write(padding, static_cast<std::streamsize>(target - position));
+            }
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(MeshEntry));
+        out.write(reinterpret_cast<const char*>(refs.data()), refs.size() * sizeof(TextureRef));
+        out.write(strings.data(), strings.size());
+
+        for (size_t i = 0; i < meshes.size(); i++) {
+            padTo(entries[i].vertexOffset);
+            out.write(reinterpret_cast<const char*>(meshes[i].getVertices()),
+                meshes[i].getVertexCount() * sizeof(Vertex));
+            padTo(entries[i].indexOffset);
+            out.write(reinterpret_cast<const char*>(meshes[i].getIndices()),
+                meshes[i].getIndexCount() * sizeof(unsigned int));
+            padTo(entries[i].lodIndexOffset);
+            out.write(reinterpret_cast<const char*>(meshes[i].getLodIndices()),
+                meshes[i].getLodIndexTotal() * sizeof(unsigned int));
+        }
+
+        if (!out) {
+            std::cout << "Could not write cooked mesh: " << cookedPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cookedPath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        std::cout << "Could not write cooked mesh: " << cookedPath << std::endl;
+        return false;
+    }
+
+    std::cout << "Cooked mesh written: " << cookedPath << " (" << offset / 1024 << " KB)" << std::endl;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "model.h"
+
+// Versioned binary mesh container written next to a source model
+// ("Porsche_911_GT2.obj" -> "Porsche_911_GT2.obj.cmesh").
+//
+// Layout:
+//   Header
+//   MeshEntry[meshCount]
+//   TextureRef[textureRefCount]
+//   string table (texture types and paths)
+//   vertex / index blobs, each 16-byte aligned
+//
+// The vertex blobs are raw interleaved Vertex arrays and the index blobs are
+// raw unsigned int arrays, so Model can hand the mapped memory straight to
+// glBufferData without touching Assimp. A mesh's simplified LOD index lists
+// follow its LOD 0 indices as one more blob.
+class CookedMesh {
+public:
+    static const uint32_t FORMAT_VERSION = 3;     // 2: meshes are stored optimised, 3: LOD levels
+
+    struct Header {
+        char magic[4];              // "CMSH"
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceMtime;
+        uint64_t sourceHash;        // FNV-1a of the source file
+        uint32_t meshCount;
+        uint32_t vertexStride;      // sizeof(Vertex) when written
+        uint32_t textureRefCount;
+        uint32_t reserved;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+    };
+
+    struct MeshEntry {
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t firstTexture;
+        uint32_t textureCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint64_t lodIndexOffset;
+        uint32_t lodCount;          // Including LOD 0
+        uint32_t lodIndexCounts[MAX_LOD_LEVELS - 1];
+    };
+
+    struct TextureRef {
+        uint32_t typeOffset;
+        uint32_t typeLength;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+    };
+
+    CookedMesh();
+
+    // Maps the cooked file for this source and checks it is still current.
+    // Returns false (and leaves nothing mapped) if it is missing or stale.
+    bool open(const std::string& sourcePath);
+    void close();
+
+    unsigned int getMeshCount() const;
+    const MeshEntry& getMeshEntry(unsigned int index) const;
+    const Vertex* getVertices(unsigned int index) const;
+    const unsigned int* getIndices(unsigned int index) const;
+    const unsigned int* getLodIndices(unsigned int index) const;   // Levels 1.., back to back
+    std::vector<Texture> getTextureRefs(unsigned int index) const;  // ids are left at 0
+    glm::vec3 getBoundsMin() const;
+    glm::vec3 getBoundsMax() const;
+
+    // Writes the cooked file for sourcePath from freshly imported meshes
+    static bool write(const std::string& sourcePath, const std::vector<MeshData>& meshes);
+
+    static std::string cachePathFor(const std::string& sourcePath);
+
+private:
+    MappedFile file;
+    const Header* header;
+
+    std::string readString(uint32_t offset, uint32_t length) const;
+    bool validate(const std::string& sourcePath) const;
+
+    static bool describeSource(const std::string& sourcePath, uint64_t& size, int64_t& mtime);
+    static uint64_t hashFile(const std::string& path);
+};
\ No newline at end of file
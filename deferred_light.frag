@@ -0,0 +1,124 @@
+#version 460 core
+// Lighting pass of DeferredRenderer: shades each G-buffer pixel with the
+// lights of its cluster (or all of them), the same way shader.frag does for
+// forward draws
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// Same layout as GpuLight in light_buffer.h
+struct Light {
+    vec3 position;
+    float ambient;
+    vec3 color;
+    float diffuse;
+    float specular;
+    float constant;
+    float linear;
+    float quadratic;
+    float radius;       // Attenuation is faded out to 0 here
+};
+
+layout(std430, binding = 0) readonly buffer LightBlock {
+    int numLights;
+    Light lights[];
+};
+
+// Clustered lighting, see LightClusters: the lights touching each view-space
+// cluster, as a range of clusterLights
+layout(std430, binding = 1) readonly buffer ClusterBlock {
+    uvec4 clusterGrid;      // Clusters along x, y and depth
+    vec4 clusterParams;     // Tile size in pixels (xy), depth slice scale and bias (zw)
+    uvec2 clusterRanges[];  // Offset into clusterLights, light count
+};
+layout(std430, binding = 2) readonly buffer ClusterLightBlock {
+    uint clusterLights[];
+};
+
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gMaterial;
+uniform sampler2D gDepth;
+
+uniform mat4 inverseProjection;
+uniform mat4 inverseView;
+uniform vec3 viewPos;
+// Off: every light is evaluated for every pixel, as in shader.frag
+uniform bool clusteredLighting;
+
+vec3 octahedralDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+vec3 calculateLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 objectColor, float shininess) {
+    // Ambient
+    vec3 ambient = light.ambient * light.color * objectColor;
+    
+    // Diffuse
+    vec3 lightDir = normalize(light.position - fragPos);
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = light.diffuse * diff * light.color * objectColor;
+    
+    // Specular
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = light.specular * spec * light.color;
+    
+    // Attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    float fade = clamp(1.0 - pow(distance / light.radius, 4.0), 0.0, 1.0);
+    attenuation *= fade * fade;
+    
+    return (ambient + diffuse + specular) * attenuation;
+}
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    if (depth >= 1.0)
+        discard;    // Sky: nothing was drawn here
+    gl_FragDepth = depth;
+
+    // Back from depth to view and world space
+    vec4 viewPosition = inverseProjection * vec4(vec3(TexCoords, depth) * 2.0 - 1.0, 1.0);
+    viewPosition /= viewPosition.w;
+    vec3 fragPos = vec3(inverseView * viewPosition);
+    float viewDepth = -viewPosition.z;
+
+    vec3 objectColor = texture(gAlbedo, TexCoords).rgb;
+    vec3 norm = octahedralDecode(texture(gNormal, TexCoords).rg);
+    float roughness = max(texture(gMaterial, TexCoords).r, 0.01);
+    float shininess = 2.0 / (roughness * roughness) - 2.0;
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    // Start with a base ambient (dark scene)
+    vec3 result = vec3(0.1, 0.1, 0.15) * objectColor;
+
+    if (clusteredLighting) {
+        // Only the lights binned into this pixel's cluster
+        uvec3 cluster;
+        cluster.xy = min(uvec2(gl_FragCoord.xy / clusterParams.xy), clusterGrid.xy - 1u);
+        cluster.z = uint(clamp(log(viewDepth) * clusterParams.z + clusterParams.w, 0.0, float(clusterGrid.z - 1u)));
+        uvec2 range = clusterRanges[cluster.x + clusterGrid.x * (cluster.y + clusterGrid.y * cluster.z)];
+        for (uint i = 0u; i < range.y; i++) {
+            result += calculateLight(lights[clusterLights[range.x + i]], norm, fragPos, viewDir, objectColor, shininess);
+        }
+    }
+    else {
+        // Calculate all lights
+        for (int i = 0; i < numLights; i++) {
+            result += calculateLight(lights[i], norm, fragPos, viewDir, objectColor, shininess);
+        }
+    }
+
+    // Gamma correction
+    result = pow(result, vec3(1.0/2.2));
+
+    FragColor = vec4(result, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "deferred_renderer.h"
+#include <iostream>
+
+namespace {
+    GLuint createTarget(GLenum internalFormat, GLenum format, GLenum type, int width, int height) {
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+        // Read back one texel per pixel, never filtered
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+}
+
+DeferredRenderer::DeferredRenderer()
+    : framebuffer(0), albedoTexture(0), normalTexture(0), materialTexture(0), depthTexture(0),
+    emptyVAO(0), width(0), height(0) {
+}
+
+void DeferredRenderer::setup() {
+    glGenVertexArrays(1, &emptyVAO);
+    glGenFramebuffers(1, &framebuffer);
+}
+
+void DeferredRenderer::cleanup() {
+    deleteTargets();
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+    }
+    if (emptyVAO) {
+        glDeleteVertexArrays(1, &emptyVAO);
+        emptyVAO = 0;
+    }
+}
+
+void DeferredRenderer::deleteTargets() {
+    if (albedoTexture) {
+        GLuint textures[] = { albedoTexture, normalTexture, materialTexture, depthTexture };
+        glDeleteTextures(4, textures);
+        albedoTexture = normalTexture = materialTexture = depthTexture = 0;
+    }
+    width = height = 0;
+}
+
+void DeferredRenderer::createTargets(int newWidth, int newHeight) {
+    deleteTargets();
+    width = newWidth;
+    height = newHeight;
+
+    albedoTexture = createTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, width, height);
+    normalTexture = createTarget(GL_RG16F, GL_RG, GL_FLOAT, width, height);
+    materialTexture = createTarget(GL_RG8, GL_RG, GL_UNSIGNED_BYTE, width, height);
+    depthTexture = createTarget(GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT, width, height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, materialTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+    glDrawBuffers(3, attachments);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR: G-buffer framebuffer incomplete" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    std::cout << "G-buffer: " << width << "x" << height << ", "
+        << (width * height * 14) / 1024 << " KB" << std::endl;
+}
+
+void DeferredRenderer::beginGeometryPass() {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (viewport[2] != width || viewport[3] != height) {
+        createTargets(viewport[2], viewport[3]);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    // Alpha 0 in the albedo and depth 1 mark pixels nothing was drawn to
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_BLEND);
+}
+
+void DeferredRenderer::lightingPass(Shader& lightShader, const glm::mat4& view, const glm::mat4& projection,
+    const glm::vec3& viewPos, bool clustered) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    lightShader.use();
+    lightShader.setMat4("inverseProjection", glm::inverse(projection));
+    lightShader.setMat4("inverseView", glm::inverse(view));
+    lightShader.setVec3("viewPos", viewPos);
+    lightShader.setBool("clusteredLighting", clustered);
+    lightShader.setInt("gAlbedo", 0);
+    lightShader.setInt("gNormal", 1);
+    lightShader.setInt("gMaterial", 2);
+    lightShader.setInt("gDepth", 3);
+
+    GLuint textures[] = { albedoTexture, normalTexture, materialTexture, depthTexture };
+    for (int i = 0; i < 4; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+    }
+
+    // Every pixel exactly once, over the sky already in the framebuffer.
+    // The shader writes the G-buffer depth as it goes, so the forward passes
+    // after this test against the opaque scene (a blit would need the default
+    // framebuffer to have the same depth format).
+    glDepthFunc(GL_ALWAYS);
+    glBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glDepthFunc(GL_LESS);
+
+    for (int i = 3; i >= 0; i--) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glEnable(GL_BLEND);
+}
\ No newline at end of file
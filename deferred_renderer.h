@@ -0,0 +1,43 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shader.h"
+
+// Deferred shading for the opaque scene (--deferred on the command line).
+// The geometry pass draws with gbuffer.frag into a compact G-buffer:
+//   0: albedo          RGBA8     rgb = surface colour
+//   1: normal          RG16F     octahedral-encoded world-space normal
+//   2: material        RG8       roughness, metalness
+//   depth              DEPTH32F
+// 14 bytes a pixel. The lighting pass is one fullscreen triangle that
+// rebuilds each pixel's position from depth and shades it with the lights
+// of its LightClusters cluster, so every pixel is lit once however much
+// overdraw the geometry had. It also writes the G-buffer depth to the
+// default framebuffer, so forward passes (trees, glass) depth test against it.
+class DeferredRenderer {
+public:
+    DeferredRenderer();
+    void setup();
+    void cleanup();
+
+    // Binds and clears the G-buffer, resized to the current viewport first if needed
+    void beginGeometryPass();
+
+    // Shades the G-buffer into the default framebuffer, leaving sky pixels
+    // alone. The light and cluster buffers must be bound already; clustered
+    // off evaluates every light per pixel, like shader.frag.
+    void lightingPass(Shader& lightShader, const glm::mat4& view, const glm::mat4& projection,
+        const glm::vec3& viewPos, bool clustered);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    GLuint framebuffer;
+    GLuint albedoTexture, normalTexture, materialTexture, depthTexture;
+    GLuint emptyVAO;    // The fullscreen triangle is made from gl_VertexID
+    int width, height;
+
+    void createTargets(int newWidth, int newHeight);
+    void deleteTargets();
+};
\ No newline at end of file
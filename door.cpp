@@ -1,9 +1,11 @@
 #include "door.h"
+#include "frustum_culler.h"
+#include "scene.h"
 #include <iostream>
 #include <vector>
 
 Door::Door(glm::vec3 pos, glm::vec3 sz, bool leftDoor)
-    : position(pos), size(sz), isLeftDoor(leftDoor) {
+    : position(pos), size(sz), isLeftDoor(leftDoor), sceneProxy(-1) {
     rotationAngle = 0.0f;
     isOpen = false;
 
@@ -18,6 +20,9 @@ Door::~Door() {
         glDeleteBuffers(1, &VBO);
         glDeleteBuffers(1, &EBO);
     }
+    if (sceneProxy >= 0) {
+        Scene::remove(sceneProxy);
+    }
 }
 
 void Door::setup() {
@@ -107,9 +112,13 @@ void Door::setup() {
     glEnableVertexAttribArray(2);
 
     glBindVertexArray(0);
+
+    if (sceneProxy < 0) {
+        sceneProxy = Scene::add(getWorldBounds(), SCENE_DOOR, this);
+    }
 }
 
-void Door::draw(Shader& shader) {
+glm::mat4 Door::getModelMatrix() const {
     // Calculate transformation matrix
     glm::mat4 model = glm::mat4(1.0f);
 
@@ -127,8 +136,21 @@ void Door::draw(Shader& shader) {
     else {
         model = glm::translate(model, glm::vec3(-size.x / 2.0f, 0.0f, 0.0f));
     }
+    return model;
+}
+
+BoundingBox Door::getWorldBounds() const {
+    BoundingBox box(-size * 0.5f, size * 0.5f);
+    box.update(getModelMatrix());
+    return box;
+}
+
+void Door::draw(Shader& shader) {
+    if (!FrustumCuller::isVisible(sceneProxy)) {
+        return;
+    }
 
-    shader.setMat4("model", model);
+    shader.setMat4("model", getModelMatrix());
 
     // Draw the door
     glBindVertexArray(VAO);
@@ -137,6 +159,7 @@ void Door::draw(Shader& shader) {
 }
 
 void Door::update(float deltaTime) {
+    float previousAngle = rotationAngle;
     float targetAngle = isOpen ? 90.0f : 0.0f;
     float speed = 60.0f; // degrees per second
 
@@ -148,6 +171,10 @@ void Door::update(float deltaTime) {
         rotationAngle -= speed * deltaTime;
         if (rotationAngle < targetAngle) rotationAngle = targetAngle;
     }
+
+    if (rotationAngle != previousAngle && sceneProxy >= 0) {
+        Scene::move(sceneProxy, getWorldBounds());
+    }
 }
 
 void Door::open() {
@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "shader.h"
+#include "bounding_box.h"
 
 class Door {
 private:
@@ -22,12 +23,16 @@ private:
     glm::vec3 doorColor;
     glm::vec3 handleColor;
 
+    int sceneProxy;     // Added by setup()
+
 public:
     Door(glm::vec3 pos, glm::vec3 sz, bool leftDoor);
     ~Door();
 
     void setup();
+    // Skipped when the door is outside the view frustum (see FrustumCuller)
     void draw(Shader& shader);
+    // Swings towards open/closed; moves the Scene box while it does
     void update(float deltaTime);
 
     // Door controls
@@ -45,6 +50,8 @@ public:
 
     glm::vec3 getPosition() const { return position; }
     glm::vec3 getSize() const { return size; }
+    glm::mat4 getModelMatrix() const;
+    BoundingBox getWorldBounds() const;
 };
 
 #endif
\ No newline at end of file
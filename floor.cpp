@@ -2,7 +2,7 @@
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include "stb_image.h"
+#include "texture_loader.h"
 
 // Define the floor vertices and indices
 const float Floor::floorVertices[] = {
@@ -131,51 +131,33 @@ bool Floor::generateDefaultTexture() {
 }
 
 bool Floor::loadTexture(const std::string& path) {
-    // Delete existing texture
-    if (floorTexture != 0) {
-        glDeleteTextures(1, &floorTexture);
-        floorTexture = 0;
+    // Decoded (flipped, with mips) on the pool and uploaded by TextureLoader::update()
+    pendingTexture = TextureLoader::load(path, true);
+    if (floorTexture == 0) {
+        generateDefaultTexture();
     }
+    return true;
+}
 
-    // Load texture using stb_image
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data) {
-        glGenTextures(1, &floorTexture);
-        glBindTexture(GL_TEXTURE_2D, floorTexture);
-
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Determine format
-        GLenum format = GL_RGB;
-        if (nrChannels == 4)
-            format = GL_RGBA;
-        else if (nrChannels == 1)
-            format = GL_RED;
-
-        // Upload texture data
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(data);
-        glBindTexture(GL_TEXTURE_2D, 0);
+void Floor::adoptPendingTexture() {
+    if (!pendingTexture || !pendingTexture->isDone()) {
+        return;
+    }
 
-        std::cout << "Loaded floor texture: " << path << " (" << width << "x" << height
-            << ", channels: " << nrChannels << ")" << std::endl;
-        useTexture = true;
-        return true;
+    if (pendingTexture->hasFailed()) {
+        std::cout << "Failed to load floor texture: " << pendingTexture->path << std::endl;
+        std::cout << "Keeping default checkerboard pattern" << std::endl;
     }
     else {
-        std::cout << "Failed to load floor texture: " << path << std::endl;
-        std::cout << "Generating default checkerboard pattern..." << std::endl;
-        return generateDefaultTexture();
+        // Delete existing texture
+        if (floorTexture != 0) {
+            glDeleteTextures(1, &floorTexture);
+        }
+        floorTexture = pendingTexture->texture;
+        useTexture = true;
+        std::cout << "Loaded floor texture: " << pendingTexture->path << std::endl;
     }
+    pendingTexture.reset();
 }
 
 void Floor::setTextureRepeat(float repeatX, float repeatY) {
@@ -189,6 +171,7 @@ void Floor::draw(unsigned int shaderProgram) {
         std::cerr << "Floor not initialized! Call setup() first." << std::endl;
         return;
     }
+    adoptPendingTexture();
 
     glUseProgram(shaderProgram);
 
@@ -234,6 +217,7 @@ void Floor::draw() {
         std::cerr << "Floor not initialized! Call setup() first." << std::endl;
         return;
     }
+    adoptPendingTexture();
 
     // Bind texture if available
     if (useTexture && floorTexture != 0) {
@@ -251,6 +235,12 @@ void Floor::draw() {
 }
 
 void Floor::cleanup() {
+    // A texture that finished after the floor stopped drawing still belongs to us
+    if (pendingTexture && pendingTexture->isDone() && pendingTexture->texture != 0) {
+        glDeleteTextures(1, &pendingTexture->texture);
+    }
+    pendingTexture.reset();
+
     if (floorVAO != 0) {
         glDeleteVertexArrays(1, &floorVAO);
         floorVAO = 0;
@@ -4,8 +4,11 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 
+struct TextureRequest;
+
 class Floor {
 private:
     glm::vec3 position;
@@ -17,6 +20,7 @@ private:
     unsigned int floorVBO;
     unsigned int floorTexture;
     bool useTexture;
+    std::shared_ptr<TextureRequest> pendingTexture;    // File texture still loading
 
     // Static vertex data
     static const float floorVertices[44];
@@ -24,6 +28,7 @@ private:
 
     unsigned char* generateCheckerboardPattern(int width, int height, int cellSize);
     bool generateDefaultTexture();
+    void adoptPendingTexture();
 
 public:
     Floor(const glm::vec3& position = glm::vec3(0.0f),
@@ -32,6 +37,7 @@ public:
     ~Floor();
 
     void setup();
+    // Queues the file on TextureLoader; the current texture stays until it arrives
     bool loadTexture(const std::string& path);
     void setTextureRepeat(float repeatX, float repeatY);
 
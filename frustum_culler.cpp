@@ -0,0 +1,73 @@
+#include "frustum_culler.h"
+#include "scene.h"
+
+bool FrustumCuller::enabled = true;
+glm::vec4 FrustumCuller::planes[6];
+std::vector<unsigned int> FrustumCuller::visibleFrame;
+unsigned int FrustumCuller::frame = 0;
+size_t FrustumCuller::drawnCount = 0;
+size_t FrustumCuller::culledCount = 0;
+
+void FrustumCuller::setCamera(const glm::mat4& projection, const glm::mat4& view) {
+    // Gribb & Hartmann: the planes are sums and differences of the rows of
+    // the clip matrix (glm stores columns, so row i is m[0][i] .. m[3][i])
+    glm::mat4 clip = projection * view;
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+    }
+    planes[0] = rows[3] + rows[0];  // Left
+    planes[1] = rows[3] - rows[0];  // Right
+    planes[2] = rows[3] + rows[1];  // Bottom
+    planes[3] = rows[3] - rows[1];  // Top
+    planes[4] = rows[3] + rows[2];  // Near
+    planes[5] = rows[3] - rows[2];  // Far
+
+    for (auto& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    drawnCount = 0;
+    culledCount = 0;
+
+    // Stamping with the frame number means nothing has to be cleared
+    frame++;
+    std::vector<int> visible;
+    Scene::getBvh().queryFrustum(planes, visible);
+    for (int proxy : visible) {
+        if (static_cast<size_t>(proxy) >= visibleFrame.size()) {
+            visibleFrame.resize(proxy + 1, 0);
+        }
+        visibleFrame[proxy] = frame;
+    }
+}
+
+bool FrustumCuller::intersects(const BoundingBox& box) {
+    for (const auto& plane : planes) {
+        // The corner furthest along the plane normal; if even that one is
+        // behind the plane, the whole box is
+        glm::vec3 corner(plane.x >= 0.0f ? box.max.x : box.min.x,
+            plane.y >= 0.0f ? box.max.y : box.min.y,
+            plane.z >= 0.0f ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrustumCuller::refresh(int proxy) {
+    if (static_cast<size_t>(proxy) >= visibleFrame.size()) {
+        visibleFrame.resize(proxy + 1, 0);
+    }
+    visibleFrame[proxy] = intersects(Scene::getBvh().getBounds(proxy)) ? frame : 0;
+}
+
+bool FrustumCuller::isVisible(int proxy) {
+    if (!enabled || proxy < 0 || visibleFrame[proxy] == frame) {
+        drawnCount++;
+        return true;
+    }
+    culledCount++;
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include "bounding_box.h"
+
+// View-frustum culling of the Scene, with per-frame counters.
+// setCamera() runs one frustum query against the Scene BVH; draw call sites
+// then just ask isVisible() for their object's proxy. Like LodSelector it
+// holds the frame's camera statically, so the matrices needn't be passed down.
+class FrustumCuller {
+public:
+    // Once per frame, before drawing. Also resets the counters.
+    static void setCamera(const glm::mat4& projection, const glm::mat4& view);
+
+    // When off everything is visible (and still counted as drawn)
+    static bool enabled;
+
+    // Whether the proxy's box touches this frame's frustum. Objects not in the
+    // Scene yet (proxy -1) are always visible. Counts the object as drawn or
+    // culled for this frame.
+    static bool isVisible(int proxy);
+
+    // Scene calls this when a proxy is added or moved after the frame's query
+    static void refresh(int proxy);
+
+    // Objects tested since setCamera
+    static size_t getDrawnCount() { return drawnCount; }
+    static size_t getCulledCount() { return culledCount; }
+
+private:
+    static glm::vec4 planes[6];     // xyz inward normal, w distance
+    static std::vector<unsigned int> visibleFrame;    // Per proxy: last frame it was inside
+    static unsigned int frame;
+    static size_t drawnCount;
+    static size_t culledCount;
+
+    static bool intersects(const BoundingBox& box);
+};
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 460 core
+// Geometry pass of DeferredRenderer: the same inputs as shader.frag, but
+// the surface is stored for the lighting pass instead of shaded
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec2 gNormal;
+layout (location = 2) out vec2 gMaterial;
+
+in vec3 FragPos;
+in vec3 Color;
+in vec3 Normal;
+flat in vec4 ColorOverride;
+in float ViewDepth;
+
+uniform float shininess = 32.0;
+
+vec2 octahedralEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0) {
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return e;
+}
+
+void main()
+{
+    vec3 objectColor = ColorOverride.a > 0.5 ? ColorOverride.rgb : Color;
+
+    gAlbedo = vec4(objectColor, 1.0);
+    gNormal = octahedralEncode(normalize(Normal));
+    // Blinn-Phong exponent as roughness; nothing in the scene is metal yet
+    gMaterial = vec2(sqrt(2.0 / (shininess + 2.0)), 0.0);
+}
\ No newline at end of file
@@ -85,9 +85,9 @@ void GlassWindow::setupBuffers() {
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    // Texture coordinate attribute (location = 3)
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(9 * sizeof(float)));
-    glEnableVertexAttribArray(3);
+    // Texture coordinate attribute (location = 8, after glass.vert's instance attributes)
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(9 * sizeof(float)));
+    glEnableVertexAttribArray(8);
 
     glBindVertexArray(0);
 }
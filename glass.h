@@ -5,6 +5,7 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include "bounding_box.h"
 
 class GlassWindow {
 private:
@@ -57,6 +58,8 @@ public:
     // Getters and setters
     glm::vec3 getPosition() const { return position; }
     glm::vec3 getSize() const { return size; }
+    // The pane is centred on position and never rotated
+    BoundingBox getWorldBounds() const { return BoundingBox(position - size * 0.5f, position + size * 0.5f); }
     float getTransparency() const { return transparency; }
     float getReflectivity() const { return reflectivity; }
     float getRefractionIndex() const { return refractionIndex; }
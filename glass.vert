@@ -2,21 +2,34 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
-layout (location = 3) in vec2 aTexCoord;
+layout (location = 3) in mat4 aInstanceModel;   // Locations 3-6, see InstanceBatch
+layout (location = 7) in vec4 aInstanceTint;    // rgb tint, a transparency
+layout (location = 8) in vec2 aTexCoord;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 Color;
 out vec2 TexCoord;
+flat out vec4 PaneTint;     // rgb tint, a transparency
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// Glass properties of a single GlassWindow
+uniform float transparency;
+uniform vec3 tintColor;
+
+// GlassBatch draws take the model matrix, tint and transparency per pane instead
+uniform bool instanced;
+
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    mat4 modelMatrix = instanced ? aInstanceModel : model;
+    PaneTint = instanced ? aInstanceTint : vec4(tintColor, transparency);
+
+    FragPos = vec3(modelMatrix * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(modelMatrix))) * aNormal;
     Color = aColor;
     TexCoord = aTexCoord;
     gl_Position = projection * view * vec4(FragPos, 1.0);
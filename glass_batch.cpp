@@ -0,0 +1,126 @@
+#include "glass_batch.h"
+#include "scene.h"
+#include "frustum_culler.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+
+glm::mat4 GlassPane::getModelMatrix() const {
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), center);
+    model = glm::rotate(model, std::atan2(normal.x, normal.z), glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::scale(model, size);
+}
+
+GlassBatch::GlassBatch() : VAO(0), VBO(0), EBO(0), indexCount(0) {
+}
+
+GlassBatch::~GlassBatch() {
+    cleanup();
+}
+
+void GlassBatch::setup() {
+    // Unit box around the origin, front at +Z. Position (3), Normal (3), Color (3)
+    float vertices[] = {
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  1.0f,  1.0f, 1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  1.0f,  1.0f, 1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  1.0f,  1.0f, 1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  1.0f,  1.0f, 1.0f, 1.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  1.0f, 1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  1.0f, 1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  1.0f, 1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  1.0f, 1.0f, 1.0f,
+    };
+
+    // Same faces as GlassWindow: front, back and the four thin edges
+    unsigned int indices[] = {
+        0, 1, 2,  2, 3, 0,
+        4, 5, 6,  6, 7, 4,
+        0, 4, 7,  7, 3, 0,
+        1, 5, 6,  6, 2, 1,
+        0, 1, 5,  5, 4, 0,
+        3, 2, 6,  6, 7, 3
+    };
+    indexCount = sizeof(indices) / sizeof(indices[0]);
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+}
+
+void GlassBatch::cleanup() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+    instances.cleanup();
+
+    for (int proxy : proxies) {
+        Scene::remove(proxy);
+    }
+    proxies.clear();
+    panes.clear();
+}
+
+int GlassBatch::addPane(const GlassPane& pane) {
+    BoundingBox unitBox(glm::vec3(-0.5f), glm::vec3(0.5f));
+    panes.push_back(pane);
+    proxies.push_back(Scene::add(unitBox.transformed(pane.getModelMatrix()), SCENE_GLASS, this));
+    return static_cast<int>(panes.size()) - 1;
+}
+
+void GlassBatch::removePanes(size_t first) {
+    for (size_t i = first; i < proxies.size(); i++) {
+        Scene::remove(proxies[i]);
+    }
+    if (first < panes.size()) {
+        panes.resize(first);
+        proxies.resize(first);
+    }
+}
+
+void GlassBatch::update() {
+    std::vector<InstanceData> data;
+    data.reserve(panes.size());
+    for (size_t i = 0; i < panes.size(); i++) {
+        if (FrustumCuller::isVisible(proxies[i])) {
+            data.push_back({ panes[i].getModelMatrix(), glm::vec4(panes[i].tint, panes[i].transparency) });
+        }
+    }
+
+    unsigned int previous = instances.getBuffer();
+    if (instances.update(data) && instances.getBuffer() != previous) {
+        glBindVertexArray(VAO);
+        InstanceBatch::bindAttributes(instances.getBuffer());
+        glBindVertexArray(0);
+    }
+}
+
+void GlassBatch::draw() {
+    if (instances.getCount() == 0) {
+        return;
+    }
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glBindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0,
+        static_cast<GLsizei>(instances.getCount()));
+    glBindVertexArray(0);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "instance_batch.h"
+#include "bounding_box.h"
+
+// One pane: a unit box scaled to size (width, height, thickness) and turned
+// about Y so its front faces along normal
+struct GlassPane {
+    glm::vec3 center;
+    glm::vec3 size;
+    glm::vec3 normal;
+    glm::vec3 tint;
+    float transparency;
+
+    glm::mat4 getModelMatrix() const;
+};
+
+// Every glass pane of the hall in one instanced draw.
+// The geometry is created once and panes change rarely; tint and transparency are
+// per-instance attributes of glass.vert, so the instance buffer is only
+// rewritten when one of them changes or a pane enters or leaves the view.
+class GlassBatch {
+private:
+    GLuint VAO, VBO, EBO;
+    GLsizei indexCount;
+    InstanceBatch instances;
+    std::vector<GlassPane> panes;
+    std::vector<int> proxies;   // Scene proxy per pane
+
+public:
+    GlassBatch();
+    ~GlassBatch();
+
+    void setup();
+    void cleanup();
+
+    // Adds a pane to the batch and the Scene; returns its index
+    int addPane(const GlassPane& pane);
+    // Drops pane first and every pane after it, from the batch and the Scene
+    void removePanes(size_t first);
+    GlassPane& getPane(int index) { return panes[index]; }
+    size_t getPaneCount() const { return panes.size(); }
+
+    // Keeps the panes inside the view frustum
+    void update();
+    // All of them in one call; set the glass shader's "instanced" uniform first
+    void draw();
+    size_t getDrawnCount() const { return instances.getCount(); }
+};
\ No newline at end of file
@@ -4,11 +4,10 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec3 Color;
+flat in vec4 PaneTint;      // rgb tint, a transparency
 
 // Glass properties
-uniform float transparency;
 uniform float reflectivity;
-uniform vec3 tintColor;
 
 // Scene lighting
 uniform vec3 lightPos;
@@ -40,13 +39,13 @@ void main()
     float edgeOpacity = 0.4 * edgeFactor;
     
     // Base glass color with tint
-    vec3 glassBase = vec3(0.9, 0.95, 1.0) * tintColor;
+    vec3 glassBase = vec3(0.9, 0.95, 1.0) * PaneTint.rgb;
     
     // Combine lighting with glass color
     vec3 litGlass = (ambient + diffuse + specular) * glassBase;
     
     // Final alpha with edge effect
-    float finalAlpha = transparency * (0.6 + 0.4 * edgeFactor);
+    float finalAlpha = PaneTint.a * (0.6 + 0.4 * edgeFactor);
     
     FragColor = vec4(litGlass, finalAlpha);
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 460 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 Tint;
+
+uniform sampler2D atlas;
+
+void main()
+{
+    vec4 texel = texture(atlas, TexCoords);
+    if (texel.a < 0.5)
+        discard;
+
+    // The atlas was baked white and gamma corrected, so tint in the same space
+    FragColor = vec4(texel.rgb * pow(Tint, vec3(1.0 / 2.2)), 1.0);
+}
\ No newline at end of file
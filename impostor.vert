@@ -0,0 +1,31 @@
+#version 460 core
+layout (location = 0) in vec2 aCorner;     // Unit quad, -0.5..0.5
+layout (location = 1) in vec3 aCenter;     // Per tree, world space
+layout (location = 2) in float aSize;
+layout (location = 3) in vec3 aTint;
+
+out vec2 TexCoords;
+out vec3 Tint;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 cameraPos;
+uniform int viewCount;     // Atlas cells, baked around +Y starting at +Z
+
+void main()
+{
+    // Turn about Y only, so the tree stays upright
+    vec3 toCamera = cameraPos - aCenter;
+    toCamera.y = 0.0;
+    toCamera = dot(toCamera, toCamera) > 1e-6 ? normalize(toCamera) : vec3(0.0, 0.0, 1.0);
+    vec3 right = vec3(toCamera.z, 0.0, -toCamera.x);
+    vec3 position = aCenter + (right * aCorner.x + vec3(0.0, aCorner.y, 0.0)) * aSize;
+
+    // Cell baked from the direction nearest the camera's
+    float step = 6.28318531 / float(viewCount);
+    float cell = mod(round(atan(toCamera.x, toCamera.z) / step), float(viewCount));
+    TexCoords = vec2((cell + aCorner.x + 0.5) / float(viewCount), aCorner.y + 0.5);
+    Tint = aTint;
+
+    gl_Position = projection * view * vec4(position, 1.0);
+}
\ No newline at end of file
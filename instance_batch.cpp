@@ -0,0 +1,68 @@
+#include "instance_batch.h"
+#include <cstddef>
+#include <cstring>
+
+namespace {
+    const GLuint INSTANCE_MODEL_LOCATION = 3;  // mat4: locations 3-6
+    const GLuint INSTANCE_TINT_LOCATION = 7;
+}
+
+InstanceBatch::InstanceBatch() : buffer(0), capacity(0), rebuilds(0) {
+}
+
+void InstanceBatch::cleanup() {
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    capacity = 0;
+    uploaded.clear();
+}
+
+bool InstanceBatch::update(const std::vector<InstanceData>& instances) {
+    if (buffer && instances.size() == uploaded.size() &&
+        (instances.empty() || std::memcmp(instances.data(), uploaded.data(), instances.size() * sizeof(InstanceData)) == 0)) {
+        return false;
+    }
+
+    if (!buffer) {
+        glGenBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    if (instances.size() > capacity) {
+        // Grow with headroom so a few more instances don't reallocate again
+        capacity = instances.size() + instances.size() / 2;
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (!instances.empty()) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    uploaded = instances;
+    rebuilds++;
+    return true;
+}
+
+void InstanceBatch::bindAttributes(unsigned int buffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint column = 0; column < 4; column++) {
+        GLuint location = INSTANCE_MODEL_LOCATION + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            (void*)(offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
+    glEnableVertexAttribArray(INSTANCE_TINT_LOCATION);
+    glVertexAttribPointer(INSTANCE_TINT_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+        (void*)offsetof(InstanceData, tint));
+    glVertexAttribDivisor(INSTANCE_TINT_LOCATION, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBatch::unbindAttributes() {
+    for (GLuint location = INSTANCE_MODEL_LOCATION; location <= INSTANCE_TINT_LOCATION; location++) {
+        glDisableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 0);
+    }
+}
\ No newline at end of file
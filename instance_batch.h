@@ -0,0 +1,38 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Per-instance input of shader.vert's instanced path (locations 3-7)
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 tint;     // a = 1: rgb replaces the vertex colour, like colorOverride
+};
+
+// Instance buffer for one mesh drawn many times in a single call.
+// update() compares against what is already on the GPU and only rebuilds the
+// buffer when an instance actually moved, appeared or went away, so static
+// objects cost nothing per frame.
+class InstanceBatch {
+public:
+    InstanceBatch();
+    void cleanup();
+
+    // GL thread. Returns true if the buffer had to be rebuilt.
+    bool update(const std::vector<InstanceData>& instances);
+
+    unsigned int getBuffer() const { return buffer; }
+    size_t getCount() const { return uploaded.size(); }
+    size_t getRebuildCount() const { return rebuilds; }
+
+    // With the mesh's VAO bound: feeds shader.vert's instance attributes from
+    // buffer, one InstanceData per instance
+    static void bindAttributes(unsigned int buffer);
+    static void unbindAttributes();
+
+private:
+    unsigned int buffer;
+    size_t capacity;    // In instances
+    std::vector<InstanceData> uploaded;
+    size_t rebuilds;
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "light_buffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+static_assert(sizeof(GpuLight) == 64, "GpuLight must match the std430 Light struct");
+
+namespace {
+    // Fraction of full strength below which a light no longer counts
+    const float LIGHT_CUTOFF = 0.04f;
+}
+
+LightBuffer::LightBuffer()
+    : block(), buffer(0), dirtyBegin(0), dirtyEnd(0), uploads(0), uploadedBytes(0) {
+}
+
+void LightBuffer::cleanup() {
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
+
+GpuLight LightBuffer::pointLight(const glm::vec3& position, const glm::vec3& color) {
+    GpuLight light;
+    light.position = position;
+    light.color = color;
+    light.ambient = 0.3f;
+    light.diffuse = 0.8f;
+    light.specular = 0.5f;
+    light.constant = 1.0f;
+    light.linear = 0.09f;
+    light.quadratic = 0.032f;
+    light.radius = influenceRadius(light);
+    light.padding[0] = light.padding[1] = light.padding[2] = 0.0f;
+    return light;
+}
+
+float LightBuffer::influenceRadius(const GpuLight& light) {
+    // Solve strength / (constant + linear d + quadratic d^2) = LIGHT_CUTOFF for d
+    float strength = std::max(light.color.r, std::max(light.color.g, light.color.b)) *
+        (light.ambient + light.diffuse + light.specular);
+    float c = light.constant - strength / LIGHT_CUTOFF;
+    if (c >= 0.0f) {
+        return 0.0f;
+    }
+    if (light.quadratic > 0.0f) {
+        return (-light.linear + std::sqrt(light.linear * light.linear - 4.0f * light.quadratic * c)) /
+            (2.0f * light.quadratic);
+    }
+    if (light.linear > 0.0f) {
+        return -c / light.linear;
+    }
+    return std::numeric_limits<float>::max();
+}
+
+void LightBuffer::markDirty(size_t begin, size_t end) {
+    if (dirtyBegin >= dirtyEnd) {
+        dirtyBegin = begin;
+        dirtyEnd = end;
+    }
+    else {
+        dirtyBegin = std::min(dirtyBegin, begin);
+        dirtyEnd = std::max(dirtyEnd, end);
+    }
+}
+
+void LightBuffer::setCount(int count) {
+    count = std::max(0, std::min(count, MAX_LIGHTS));
+    if (count != block.count) {
+        block.count = count;
+        markDirty(offsetof(Block, count), offsetof(Block, count) + sizeof(int));
+    }
+}
+
+void LightBuffer::setLight(int index, const GpuLight& newLight) {
+    GpuLight light = newLight;
+    light.radius = influenceRadius(light);
+    light.padding[0] = light.padding[1] = light.padding[2] = 0.0f;
+    if (index < 0 || index >= MAX_LIGHTS || std::memcmp(&block.lights[index], &light, sizeof(GpuLight)) == 0) {
+        return;
+    }
+    block.lights[index] = light;
+    size_t begin = offsetof(Block, lights) + index * sizeof(GpuLight);
+    markDirty(begin, begin + sizeof(GpuLight));
+}
+
+void LightBuffer::upload() {
+    if (!buffer) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+        // Lights past the count are never read, so only the used part goes up
+        markDirty(0, offsetof(Block, lights) + block.count * sizeof(GpuLight));
+    }
+    if (dirtyBegin >= dirtyEnd) {
+        return;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, dirtyBegin, dirtyEnd - dirtyBegin,
+        reinterpret_cast<const unsigned char*>(&block) + dirtyBegin);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    uploads++;
+    uploadedBytes += dirtyEnd - dirtyBegin;
+    dirtyBegin = dirtyEnd = 0;
+}
+
+void LightBuffer::bind() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, buffer);
+}
\ No newline at end of file
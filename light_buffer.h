@@ -0,0 +1,68 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// One point light as laid out in shader.frag's LightBlock (std430: each
+// vec3 shares its 16 bytes with the float after it)
+struct GpuLight {
+    glm::vec3 position;
+    float ambient;
+    glm::vec3 color;
+    float diffuse;
+    float specular;
+    float constant;
+    float linear;
+    float quadratic;
+    float radius;       // Set by LightBuffer::setLight, see influenceRadius
+    float padding[3];
+};
+
+// CPU copy of shader.frag's LightBlock storage buffer.
+// Setters only mark what actually changed, and upload() writes just that
+// byte range, so lights that never move are sent once and a moving light
+// costs one small glBufferSubData.
+class LightBuffer {
+public:
+    static const GLuint BINDING = 0;    // layout(binding = 0) in shader.frag
+    static const int MAX_LIGHTS = 512;
+
+    LightBuffer();
+    void cleanup();
+
+    // The usual street/hall light: fixed strengths and attenuation
+    static GpuLight pointLight(const glm::vec3& position, const glm::vec3& color);
+
+    // Distance at which the light's attenuated strength falls below
+    // LIGHT_CUTOFF of its full strength; shader.frag fades it to 0 there
+    static float influenceRadius(const GpuLight& light);
+
+    void setCount(int count);
+    void setLight(int index, const GpuLight& light);
+    int getCount() const { return block.count; }
+    const GpuLight& getLight(int index) const { return block.lights[index]; }
+
+    // GL thread: writes the dirty range, if any, then clears it
+    void upload();
+    // GL thread: makes this the LightBlock every program reads
+    void bind() const;
+
+    size_t getUploadCount() const { return uploads; }
+    size_t getUploadedBytes() const { return uploadedBytes; }
+
+private:
+    struct Block {
+        int count;
+        int padding[3];
+        GpuLight lights[MAX_LIGHTS];
+    };
+
+    Block block;
+    GLuint buffer;
+    size_t dirtyBegin;  // Byte range of block still to upload; empty if begin >= end
+    size_t dirtyEnd;
+    size_t uploads;
+    size_t uploadedBytes;
+
+    void markDirty(size_t begin, size_t end);
+};
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "light_clusters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // Tiles along one screen axis covered by a sphere's box of half size
+    // radius around center (view space, that axis) between depths minDepth
+    // and maxDepth. scale is the projection's focal term for the axis.
+    bool tileRange(float center, float radius, float minDepth, float maxDepth, float scale, int tiles,
+        int& first, int& last) {
+        // x / depth is monotonic in both, so the extremes are at the box corners
+        float low = std::min((center - radius) / minDepth, (center - radius) / maxDepth) * scale;
+        float high = std::max((center + radius) / minDepth, (center + radius) / maxDepth) * scale;
+        if (high < -1.0f || low > 1.0f) {
+            return false;
+        }
+        first = std::max(0, static_cast<int>(std::floor((low * 0.5f + 0.5f) * tiles)));
+        last = std::min(tiles - 1, static_cast<int>(std::floor((high * 0.5f + 0.5f) * tiles)));
+        return first <= last;
+    }
+}
+
+LightClusters::LightClusters()
+    : clusterBuffer(0), indexBuffer(0), indexCapacity(0), binnedLights(0), maxClusterLights(0),
+    activeClusters(0), buildMicroseconds(0.0) {
+}
+
+void LightClusters::cleanup() {
+    if (clusterBuffer) {
+        glDeleteBuffers(1, &clusterBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+        clusterBuffer = indexBuffer = 0;
+    }
+    indexCapacity = 0;
+}
+
+void LightClusters::build(const LightBuffer& lights, const glm::mat4& view, const glm::mat4& projection) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // Near and far planes back out of the perspective matrix
+    float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    float logDepthRange = std::log(farPlane / nearPlane);
+    // slice = log(depth) * sliceScale + sliceBias, the same in shader.frag
+    float sliceScale = GRID_Z / logDepthRange;
+    float sliceBias = -GRID_Z * std::log(nearPlane) / logDepthRange;
+
+    entries.clear();
+    binnedLights = 0;
+    for (int i = 0; i < lights.getCount(); i++) {
+        const GpuLight& light = lights.getLight(i);
+        glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float depth = -center.z;
+        float radius = light.radius;
+        if (radius <= 0.0f || depth + radius < nearPlane || depth - radius > farPlane) {
+            continue;
+        }
+
+        float minDepth = std::max(depth - radius, nearPlane);
+        float maxDepth = std::min(depth + radius, farPlane);
+        int firstSlice = std::max(0, static_cast<int>(std::floor(std::log(minDepth) * sliceScale + sliceBias)));
+        int lastSlice = std::min(GRID_Z - 1, static_cast<int>(std::floor(std::log(maxDepth) * sliceScale + sliceBias)));
+
+        bool binned = false;
+        for (int z = firstSlice; z <= lastSlice; z++) {
+            // Narrow the box to the part of the sphere inside this slice
+            float sliceNear = nearPlane * std::pow(farPlane / nearPlane, float(z) / GRID_Z);
+            float sliceFar = nearPlane * std::pow(farPlane / nearPlane, float(z + 1) / GRID_Z);
+            float sliceMin = std::max(minDepth, sliceNear);
+            float sliceMax = std::min(maxDepth, sliceFar);
+
+            int firstX, lastX, firstY, lastY;
+            if (!tileRange(center.x, radius, sliceMin, sliceMax, projection[0][0], GRID_X, firstX, lastX) ||
+                !tileRange(center.y, radius, sliceMin, sliceMax, projection[1][1], GRID_Y, firstY, lastY)) {
+                continue;
+            }
+            for (int y = firstY; y <= lastY; y++) {
+                for (int x = firstX; x <= lastX; x++) {
+                    Entry entry;
+                    entry.cluster = static_cast<uint32_t>(x + GRID_X * (y + GRID_Y * z));
+                    entry.light = static_cast<uint32_t>(i);
+                    entries.push_back(entry);
+                }
+            }
+            binned = true;
+        }
+        if (binned) {
+            binnedLights++;
+        }
+    }
+
+    // Counting sort by cluster into offset/count ranges and one index list
+    ranges.assign(CLUSTER_COUNT * 2, 0);
+    for (const auto& entry : entries) {
+        ranges[entry.cluster * 2 + 1]++;
+    }
+    uint32_t offset = 0;
+    maxClusterLights = 0;
+    activeClusters = 0;
+    for (int c = 0; c < CLUSTER_COUNT; c++) {
+        uint32_t count = ranges[c * 2 + 1];
+        ranges[c * 2] = offset;
+        offset += count;
+        maxClusterLights = std::max(maxClusterLights, count);
+        if (count > 0) {
+            activeClusters++;
+        }
+    }
+    indices.resize(entries.size());
+    std::vector<uint32_t> fill(CLUSTER_COUNT);
+    for (int c = 0; c < CLUSTER_COUNT; c++) {
+        fill[c] = ranges[c * 2];
+    }
+    for (const auto& entry : entries) {
+        indices[fill[entry.cluster]++] = entry.light;
+    }
+
+    Header header;
+    header.grid[0] = GRID_X;
+    header.grid[1] = GRID_Y;
+    header.grid[2] = GRID_Z;
+    header.grid[3] = 0;
+    header.params[0] = float(viewport[2]) / GRID_X;
+    header.params[1] = float(viewport[3]) / GRID_Y;
+    header.params[2] = sliceScale;
+    header.params[3] = sliceBias;
+    upload(header);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    buildMicroseconds = std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void LightClusters::upload(const Header& header) {
+    if (!clusterBuffer) {
+        glGenBuffers(1, &clusterBuffer);
+        glGenBuffers(1, &indexBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Header) + CLUSTER_COUNT * 2 * sizeof(uint32_t),
+            nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Header), &header);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(Header), ranges.size() * sizeof(uint32_t), ranges.data());
+
+    // Grow the index list by doubling; an empty one still needs a valid buffer
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+    size_t needed = std::max<size_t>(indices.size(), 1);
+    if (needed > indexCapacity) {
+        indexCapacity = std::max(needed, indexCapacity * 2);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, indexCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (!indices.empty()) {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, indices.size() * sizeof(uint32_t), indices.data());
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void LightClusters::bind() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_BINDING, clusterBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INDEX_BINDING, indexBuffer);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "light_buffer.h"
+
+// Clustered light culling for the lighting shader.
+// The view frustum is cut into GRID_X x GRID_Y screen tiles and GRID_Z depth
+// slices, spaced exponentially so near and far clusters have similar
+// proportions. Every frame each light's influence sphere is binned into the
+// clusters its bounding box touches, and shader.frag then only evaluates the
+// lights listed for the cluster its fragment falls in.
+class LightClusters {
+public:
+    static const int GRID_X = 16;
+    static const int GRID_Y = 9;
+    static const int GRID_Z = 24;
+    static const int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+    static const GLuint CLUSTER_BINDING = 1;    // ClusterBlock in shader.frag
+    static const GLuint INDEX_BINDING = 2;      // ClusterLightBlock in shader.frag
+
+    LightClusters();
+    void cleanup();
+
+    // GL thread: bins the lights for this camera (a glm::perspective
+    // projection) and the current viewport, and uploads the cluster lists
+    void build(const LightBuffer& lights, const glm::mat4& view, const glm::mat4& projection);
+    void bind() const;
+
+    // Of the last build
+    size_t getLightCount() const { return binnedLights; }
+    size_t getIndexCount() const { return indices.size(); }
+    unsigned int getMaxClusterLights() const { return maxClusterLights; }
+    size_t getActiveClusterCount() const { return activeClusters; }
+    double getBuildMicroseconds() const { return buildMicroseconds; }
+
+private:
+    // std430 header of ClusterBlock; the per-cluster ranges follow it
+    struct Header {
+        uint32_t grid[4];       // GRID_X, GRID_Y, GRID_Z, unused
+        float params[4];        // Tile size in pixels (x, y), depth slice scale and bias
+    };
+
+    // One light overlapping one cluster, before sorting by cluster
+    struct Entry {
+        uint32_t cluster;
+        uint32_t light;
+    };
+
+    GLuint clusterBuffer;
+    GLuint indexBuffer;
+    size_t indexCapacity;
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> ranges;      // Offset, count per cluster
+    std::vector<uint32_t> indices;     // Light indices, grouped by cluster
+
+    size_t binnedLights;
+    unsigned int maxClusterLights;
+    size_t activeClusters;
+    double buildMicroseconds;
+
+    void upload(const Header& header);
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "lod_selector.h"
+#include "model.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    // Smallest on-screen size (pixels) each level is kept at; below the last one
+    // the coarsest level is used
+    const float LOD_SCREEN_SIZES[MAX_LOD_LEVELS - 1] = { 250.0f, 100.0f, 40.0f };
+
+    // A switch needs the size 15% past the threshold in that direction
+    const float LOD_HYSTERESIS = 0.15f;
+
+    glm::vec3 cameraPosition(0.0f);
+    float pixelsPerUnit = 1.0f;     // At distance 1
+}
+
+bool LodSelector::enabled = true;
+
+void LodSelector::setCamera(const glm::vec3& position, float fovDegrees, float viewportHeight) {
+    cameraPosition = position;
+    pixelsPerUnit = viewportHeight / (2.0f * std::tan(glm::radians(fovDegrees) * 0.5f));
+}
+
+float LodSelector::projectedSize(const Model& model, const glm::mat4& modelMatrix) {
+    glm::vec3 center = (model.getBoundsMin() + model.getBoundsMax()) * 0.5f;
+    float radius = glm::length(model.getBoundsMax() - model.getBoundsMin()) * 0.5f;
+
+    float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+        std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    radius *= scale;
+
+    float distance = glm::length(glm::vec3(modelMatrix * glm::vec4(center, 1.0f)) - cameraPosition);
+    if (distance <= radius) {
+        return FLT_MAX;
+    }
+    return 2.0f * radius / distance * pixelsPerUnit;
+}
+
+unsigned int LodSelector::select(const Model& model, const glm::mat4& modelMatrix) {
+    unsigned int levels = model.getLodCount();
+    if (!enabled || levels <= 1) {
+        level = 0;
+        return level;
+    }
+
+    float size = projectedSize(model, modelMatrix);
+    level = std::min(level, levels - 1);
+    while (level > 0 && size > LOD_SCREEN_SIZES[level - 1] * (1.0f + LOD_HYSTERESIS)) {
+        level--;
+    }
+    while (level + 1 < levels && size < LOD_SCREEN_SIZES[level] * (1.0f - LOD_HYSTERESIS)) {
+        level++;
+    }
+    return level;
+}
\ No newline at end of file
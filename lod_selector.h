@@ -0,0 +1,27 @@
+#pragma once
+#include <glm/glm.hpp>
+
+class Model;
+
+// Picks a Model LOD for one drawn instance from its projected size on screen.
+// A level only changes once the size is well past the threshold, so an object
+// sitting near a boundary doesn't pop back and forth every frame.
+class LodSelector {
+public:
+    // Once per frame, before drawing: camera position, vertical field of view
+    // in degrees and viewport height in pixels
+    static void setCamera(const glm::vec3& position, float fovDegrees, float viewportHeight);
+
+    // When off every instance draws LOD 0
+    static bool enabled;
+
+    // Level to draw this model with this frame
+    unsigned int select(const Model& model, const glm::mat4& modelMatrix);
+    unsigned int getLevel() const { return level; }
+
+    // Diameter of the model's bounding sphere on screen, in pixels
+    static float projectedSize(const Model& model, const glm::mat4& modelMatrix);
+
+private:
+    unsigned int level = 0;
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "material_table.h"
+#include <algorithm>
+#include <cmath>
+
+static_assert(sizeof(MaterialVertex) == 20, "MaterialVertex must match its attribute layout");
+
+namespace {
+    // GL_INT_2_10_10_10_REV: x in the low bits, w (unused) in the top two
+    uint32_t packSnorm10(const glm::vec3& v) {
+        uint32_t packed = 0;
+        for (int i = 0; i < 3; i++) {
+            float clamped = std::max(-1.0f, std::min(1.0f, v[i]));
+            int32_t value = static_cast<int32_t>(std::round(clamped * 511.0f));
+            packed |= (static_cast<uint32_t>(value) & 0x3ffu) << (10 * i);
+        }
+        return packed;
+    }
+}
+
+MaterialVertex::MaterialVertex(const glm::vec3& p, const glm::vec3& n, int m)
+    : position(p), normal(packSnorm10(n)), material(static_cast<uint16_t>(m)), padding(0) {
+}
+
+void MaterialVertex::bindAttributes() {
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MaterialVertex), (void*)offsetof(MaterialVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(MaterialVertex), (void*)offsetof(MaterialVertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(8, 1, GL_UNSIGNED_SHORT, sizeof(MaterialVertex), (void*)offsetof(MaterialVertex, material));
+    glEnableVertexAttribArray(8);
+}
+
+MaterialTable::MaterialTable()
+    : buffer(0), writes(0), writtenBytes(0) {
+    std::fill(colors, colors + MAX_MATERIALS, glm::vec4(1.0f));
+}
+
+void MaterialTable::setup() {
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(colors), colors, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void MaterialTable::cleanup() {
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
+
+void MaterialTable::setColor(int material, const glm::vec3& color) {
+    if (material < 0 || material >= MAX_MATERIALS || glm::vec3(colors[material]) == color) {
+        return;
+    }
+    colors[material] = glm::vec4(color, 1.0f);
+
+    // Before setup() the colour just goes out with the rest of the table
+    if (buffer) {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, material * sizeof(glm::vec4), sizeof(glm::vec4), &colors[material]);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        writes++;
+        writtenBytes += sizeof(glm::vec4);
+    }
+}
+
+void MaterialTable::bind() const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, buffer);
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// 20-byte vertex for the flat-coloured showroom geometry (Room, Street,
+// street lights) instead of 9 floats: the normal is packed as 10:10:10
+// snorm and the colour is an index into a MaterialTable.
+struct MaterialVertex {
+    glm::vec3 position;
+    uint32_t normal;
+    uint16_t material;
+    uint16_t padding;
+
+    MaterialVertex(const glm::vec3& position, const glm::vec3& normal, int material);
+
+    // Attribute pointers for the bound VAO and GL_ARRAY_BUFFER. shader.vert
+    // reads them when its materialVertex uniform is set.
+    static void bindAttributes();
+};
+
+// Colours for MaterialVertex geometry, as shader.vert's MaterialBlock
+// uniform buffer. Vertices only carry the index, so recolouring a material
+// is one 16-byte glBufferSubData and the mesh is never rebuilt.
+class MaterialTable {
+public:
+    static const GLuint BINDING = 0;    // layout(binding = 0) in shader.vert
+    static const int MAX_MATERIALS = 64;
+
+    MaterialTable();
+    // GL thread: creates the buffer with the colours set so far
+    void setup();
+    void cleanup();
+
+    void setColor(int material, const glm::vec3& color);
+    glm::vec3 getColor(int material) const { return glm::vec3(colors[material]); }
+
+    // GL thread: makes this the MaterialBlock for the next draws
+    void bind() const;
+
+    size_t getWriteCount() const { return writes; }
+    size_t getWrittenBytes() const { return writtenBytes; }
+
+private:
+    glm::vec4 colors[MAX_MATERIALS];    // std140: vec4 array stride
+    GLuint buffer;
+    size_t writes;
+    size_t writtenBytes;
+};
\ No newline at end of file
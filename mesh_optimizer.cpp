@@ -0,0 +1,325 @@
+#include "mesh_optimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    // Forsyth, "Linear-Speed Vertex Cache Optimisation"
+    const int FORSYTH_CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    float vertexScore(int cachePosition, unsigned int remainingTriangles) {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Just used by the last triangle; don't favour it too much
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else {
+                float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+            }
+        }
+
+        // Finish off vertices with few triangles left so they leave the cache for good
+        score += VALENCE_BOOST_SCALE * std::pow(float(remainingTriangles), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    struct VertexKeyHash {
+        size_t operator()(const Vertex& v) const {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&v);
+            size_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(Vertex); i++) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    };
+
+    struct VertexKeyEqual {
+        bool operator()(const Vertex& a, const Vertex& b) const {
+            return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+        }
+    };
+}
+
+void MeshOptimizer::Stats::add(const Stats& other) {
+    verticesBefore += other.verticesBefore;
+    verticesAfter += other.verticesAfter;
+    triangles += other.triangles;
+    missesBefore += other.missesBefore;
+    missesAfter += other.missesAfter;
+}
+
+MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    Stats stats;
+    stats.verticesBefore = vertices.size();
+    stats.triangles = indices.size() / 3;
+    stats.missesBefore = countCacheMisses(indices, vertices.size());
+
+    if (indices.size() >= 3 && indices.size() % 3 == 0) {
+        weld(vertices, indices);
+        optimizeVertexCache(indices, vertices.size());
+        optimizeOverdraw(vertices, indices);
+        optimizeVertexFetch(vertices, indices);
+    }
+
+    stats.verticesAfter = vertices.size();
+    stats.missesAfter = countCacheMisses(indices, vertices.size());
+    return stats;
+}
+
+size_t MeshOptimizer::countCacheMisses(const std::vector<unsigned int>& indices, size_t vertexCount,
+    unsigned int cacheSize) {
+    // Timestamp FIFO: a vertex is cached if it entered within the last cacheSize misses
+    std::vector<size_t> entered(vertexCount, 0);
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (index >= vertexCount) {
+            continue;
+        }
+        if (entered[index] == 0 || misses - (entered[index] - 1) >= cacheSize) {
+            misses++;
+            entered[index] = misses;
+        }
+    }
+    return misses;
+}
+
+void MeshOptimizer::weld(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    std::unordered_map<Vertex, unsigned int, VertexKeyHash, VertexKeyEqual> unique;
+    unique.reserve(vertices.size());
+
+    std::vector<unsigned int> remap(vertices.size());
+    std::vector<Vertex> welded;
+    welded.reserve(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        auto result = unique.emplace(vertices[i], static_cast<unsigned int>(welded.size()));
+        if (result.second) {
+            welded.push_back(vertices[i]);
+        }
+        remap[i] = result.first->second;
+    }
+
+    for (auto& index : indices) {
+        index = remap[index];
+    }
+    vertices.swap(welded);
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+
+    // Vertex -> triangle adjacency, packed
+    std::vector<unsigned int> triangleCounts(vertexCount, 0);
+    for (unsigned int index : indices) {
+        triangleCounts[index]++;
+    }
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + triangleCounts[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    // triangleCounts now tracks triangles not yet emitted
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        scores[v] = vertexScore(-1, triangleCounts[v]);
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    std::vector<unsigned int> cache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    std::vector<unsigned int> nextCache;
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    size_t scanCursor = 0;
+    long bestTriangle = -1;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (bestTriangle < 0) {
+            // Nothing useful in the cache: continue with the next unused triangle
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            bestTriangle = static_cast<long>(scanCursor);
+        }
+
+        size_t t = static_cast<size_t>(bestTriangle);
+        emitted[t] = true;
+
+        // The new triangle's vertices go to the front, the rest of the cache follows
+        nextCache.clear();
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[t * 3 + k];
+            result.push_back(v);
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) {
+                nextCache.push_back(v);
+            }
+
+            // Retire this triangle from the vertex's adjacency list
+            unsigned int* begin = &adjacency[adjacencyOffsets[v]];
+            unsigned int* end = begin + triangleCounts[v];
+            unsigned int* found = std::find(begin, end, static_cast<unsigned int>(t));
+            if (found != end) {
+                std::swap(*found, *(end - 1));
+                triangleCounts[v]--;
+            }
+        }
+        size_t emittedVertices = nextCache.size();
+        for (unsigned int v : cache) {
+            if (std::find(nextCache.begin(), nextCache.begin() + emittedVertices, v) == nextCache.begin() + emittedVertices) {
+                nextCache.push_back(v);
+            }
+        }
+
+        // Vertices pushed out of the cache lose their cache bonus
+        for (size_t i = FORSYTH_CACHE_SIZE; i < nextCache.size(); i++) {
+            scores[nextCache[i]] = vertexScore(-1, triangleCounts[nextCache[i]]);
+        }
+        if (nextCache.size() > size_t(FORSYTH_CACHE_SIZE)) {
+            nextCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        cache.swap(nextCache);
+
+        for (size_t i = 0; i < cache.size(); i++) {
+            scores[cache[i]] = vertexScore(static_cast<int>(i), triangleCounts[cache[i]]);
+        }
+
+        // Rescore only triangles touching the cache and pick the best of them
+        bestTriangle = -1;
+        float bestScore = 0.0f;
+        for (unsigned int v : cache) {
+            for (unsigned int a = 0; a < triangleCounts[v]; a++) {
+                unsigned int candidate = adjacency[adjacencyOffsets[v] + a];
+                float score = scores[indices[candidate * 3]] + scores[indices[candidate * 3 + 1]] +
+                    scores[indices[candidate * 3 + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = candidate;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    size_t triangleCount = indices.size() / 3;
+
+    // Cut the cache-ordered list wherever a triangle shares nothing with the
+    // cache; reordering whole runs keeps the ACMR almost unchanged
+    std::vector<size_t> clusterStarts;
+    std::vector<size_t> entered(vertices.size(), 0);
+    size_t misses = 0;
+    const unsigned int cacheSize = 16;
+    for (size_t t = 0; t < triangleCount; t++) {
+        int triangleMisses = 0;
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[t * 3 + k];
+            if (entered[v] == 0 || misses - (entered[v] - 1) >= cacheSize) {
+                misses++;
+                entered[v] = misses;
+                triangleMisses++;
+            }
+        }
+        if (t == 0 || triangleMisses == 3) {
+            clusterStarts.push_back(t);
+        }
+    }
+    if (clusterStarts.size() < 2) {
+        return;
+    }
+    clusterStarts.push_back(triangleCount);
+
+    glm::vec3 meshCenter(0.0f);
+    for (const auto& vertex : vertices) {
+        meshCenter += vertex.Position;
+    }
+    meshCenter /= float(vertices.size());
+
+    // Sort key: how much the run faces away from the centre of the mesh.
+    // Outward-facing runs are drawn first so they occlude the ones behind them.
+    struct Cluster {
+        size_t begin;
+        size_t end;
+        float key;
+    };
+    std::vector<Cluster> clusters;
+    for (size_t c = 0; c + 1 < clusterStarts.size(); c++) {
+        glm::vec3 center(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+            const glm::vec3& a = vertices[indices[t * 3]].Position;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+            const glm::vec3& d = vertices[indices[t * 3 + 2]].Position;
+            glm::vec3 cross = glm::cross(b - a, d - a);
+            float triangleArea = glm::length(cross);
+            center += (a + b + d) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+
+        Cluster cluster;
+        cluster.begin = clusterStarts[c];
+        cluster.end = clusterStarts[c + 1];
+        cluster.key = 0.0f;
+        float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f) {
+            cluster.key = glm::dot(center / area - meshCenter, normal / normalLength);
+        }
+        clusters.push_back(cluster);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.key > b.key;
+    });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const auto& cluster : clusters) {
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(vertices.size(), unused);
+    std::vector<Vertex> ordered;
+    ordered.reserve(vertices.size());
+
+    for (auto& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = static_cast<unsigned int>(ordered.size());
+            ordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    // Vertices no triangle references are dropped
+    vertices.swap(ordered);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include "model.h"
+
+// Import-time index/vertex buffer optimisation for one mesh, in this order:
+//   1. weld     - merge bit-identical vertices
+//   2. vcache   - reorder triangles for the post-transform vertex cache (Forsyth)
+//   3. overdraw - keep those runs intact but draw outward-facing runs first
+//   4. fetch    - renumber vertices in first-use order so fetches stream linearly
+// The triangles themselves (and their winding) are never changed.
+class MeshOptimizer {
+public:
+    struct Stats {
+        size_t verticesBefore = 0;
+        size_t verticesAfter = 0;
+        size_t triangles = 0;
+        size_t missesBefore = 0;    // Simulated FIFO cache misses
+        size_t missesAfter = 0;
+
+        // Average cache miss ratio: transformed vertices per triangle (0.5 - 3.0)
+        float getAcmrBefore() const { return triangles ? float(missesBefore) / triangles : 0.0f; }
+        float getAcmrAfter() const { return triangles ? float(missesAfter) / triangles : 0.0f; }
+
+        void add(const Stats& other);
+    };
+
+    static Stats optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+    // Vertex shader invocations for this index order with a FIFO cache of cacheSize entries
+    static size_t countCacheMisses(const std::vector<unsigned int>& indices, size_t vertexCount,
+        unsigned int cacheSize = 16);
+
+    // Just the vcache pass, e.g. for an extra index list over already optimised vertices
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+private:
+    static void weld(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    static void optimizeOverdraw(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+};
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "mesh_simplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    // Border planes are weighted up so open edges keep their outline
+    const double BORDER_WEIGHT = 10.0;
+
+    // Symmetric 4x4 matrix (upper triangle) summing squared distances to planes
+    struct Quadric {
+        double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+        double a11 = 0, a12 = 0, a13 = 0;
+        double a22 = 0, a23 = 0;
+        double a33 = 0;
+        double weight = 0;
+
+        void addPlane(const glm::dvec3& n, double d, double w) {
+            a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z; a03 += w * n.x * d;
+            a11 += w * n.y * n.y; a12 += w * n.y * n.z; a13 += w * n.y * d;
+            a22 += w * n.z * n.z; a23 += w * n.z * d;
+            a33 += w * d * d;
+            weight += w;
+        }
+
+        void add(const Quadric& q) {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+            a11 += q.a11; a12 += q.a12; a13 += q.a13;
+            a22 += q.a22; a23 += q.a23;
+            a33 += q.a33;
+            weight += q.weight;
+        }
+
+        double evaluate(const glm::dvec3& p) const {
+            double result = a00 * p.x * p.x + 2 * a01 * p.x * p.y + 2 * a02 * p.x * p.z + 2 * a03 * p.x +
+                a11 * p.y * p.y + 2 * a12 * p.y * p.z + 2 * a13 * p.y +
+                a22 * p.z * p.z + 2 * a23 * p.z +
+                a33;
+            return result > 0.0 ? result : 0.0;
+        }
+    };
+
+    struct PositionHash {
+        size_t operator()(const glm::vec3& p) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return (size_t(bits[0]) * 73856093u) ^ (size_t(bits[1]) * 19349663u) ^ (size_t(bits[2]) * 83492791u);
+        }
+    };
+
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        double error;   // Distance, not squared
+    };
+
+    uint64_t edgeKey(unsigned int a, unsigned int b) {
+        return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+    }
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(const std::vector<Vertex>& vertices,
+    const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, float* resultError) {
+    std::vector<unsigned int> result = indices;
+    if (resultError) {
+        *resultError = 0.0f;
+    }
+    if (result.size() <= targetIndexCount || result.size() % 3 != 0) {
+        return result;
+    }
+
+    // Collapses work on positions; the vertices sharing a position (normal / UV
+    // seams) are its "wedges" and move together
+    std::unordered_map<glm::vec3, unsigned int, PositionHash> positionIds;
+    std::vector<unsigned int> positionOf(vertices.size());
+    std::vector<glm::dvec3> positions;
+    for (size_t v = 0; v < vertices.size(); v++) {
+        auto found = positionIds.emplace(vertices[v].Position, static_cast<unsigned int>(positions.size()));
+        if (found.second) {
+            positions.push_back(glm::dvec3(vertices[v].Position));
+        }
+        positionOf[v] = found.first->second;
+    }
+    size_t positionCount = positions.size();
+
+    std::vector<unsigned int> wedgeOffsets(positionCount + 1, 0);
+    for (size_t v = 0; v < vertices.size(); v++) {
+        wedgeOffsets[positionOf[v] + 1]++;
+    }
+    for (size_t p = 0; p < positionCount; p++) {
+        wedgeOffsets[p + 1] += wedgeOffsets[p];
+    }
+    std::vector<unsigned int> wedges(vertices.size());
+    {
+        std::vector<unsigned int> fill(wedgeOffsets.begin(), wedgeOffsets.end() - 1);
+        for (size_t v = 0; v < vertices.size(); v++) {
+            wedges[fill[positionOf[v]]++] = static_cast<unsigned int>(v);
+        }
+    }
+
+    // Plane quadrics from every triangle, area weighted
+    std::vector<Quadric> quadrics(positionCount);
+    std::unordered_map<uint64_t, int> edgeUse;
+    for (size_t t = 0; t < result.size(); t += 3) {
+        unsigned int p[3] = { positionOf[result[t]], positionOf[result[t + 1]], positionOf[result[t + 2]] };
+        glm::dvec3 cross = glm::cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+        double length = glm::length(cross);
+        if (length > 0.0) {
+            glm::dvec3 n = cross / length;
+            double d = -glm::dot(n, positions[p[0]]);
+            for (int k = 0; k < 3; k++) {
+                quadrics[p[k]].addPlane(n, d, length * 0.5);
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            edgeUse[edgeKey(p[k], p[(k + 1) % 3])]++;
+        }
+    }
+
+    // Open edges: a plane through the edge, perpendicular to its triangle
+    std::vector<bool> onBorder(positionCount, false);
+    for (size_t t = 0; t < result.size(); t += 3) {
+        unsigned int p[3] = { positionOf[result[t]], positionOf[result[t + 1]], positionOf[result[t + 2]] };
+        glm::dvec3 normal = glm::cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+        for (int k = 0; k < 3; k++) {
+            unsigned int a = p[k];
+            unsigned int b = p[(k + 1) % 3];
+            if (edgeUse[edgeKey(a, b)] != 1) {
+                continue;
+            }
+            onBorder[a] = onBorder[b] = true;
+
+            glm::dvec3 edge = positions[b] - positions[a];
+            glm::dvec3 n = glm::cross(edge, normal);
+            double length = glm::length(n);
+            if (length > 0.0) {
+                n /= length;
+                double w = glm::dot(edge, edge) * BORDER_WEIGHT;
+                double d = -glm::dot(n, positions[a]);
+                quadrics[a].addPlane(n, d, w);
+                quadrics[b].addPlane(n, d, w);
+            }
+        }
+    }
+
+    double largestError = 0.0;
+    std::vector<unsigned int> vertexRemap(vertices.size());
+    std::vector<bool> locked(positionCount);
+    std::vector<unsigned int> adjacencyOffsets(positionCount + 1);
+    std::vector<unsigned int> adjacency;
+    std::vector<Collapse> collapses;
+
+    // Each pass collapses a batch of independent edges, cheapest first
+    while (result.size() > targetIndexCount) {
+        size_t triangleCount = result.size() / 3;
+
+        // Position -> triangle adjacency for the current index list
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (unsigned int index : result) {
+            adjacencyOffsets[positionOf[index] + 1]++;
+        }
+        for (size_t p = 0; p < positionCount; p++) {
+            adjacencyOffsets[p + 1] += adjacencyOffsets[p];
+        }
+        adjacency.resize(result.size());
+        {
+            std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t t = 0; t < triangleCount; t++) {
+                for (int k = 0; k < 3; k++) {
+                    adjacency[fill[positionOf[result[t * 3 + k]]]++] = static_cast<unsigned int>(t);
+                }
+            }
+        }
+
+        // Candidate per edge, in whichever direction is allowed and cheaper
+        collapses.clear();
+        edgeUse.clear();
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) {
+                edgeUse[edgeKey(positionOf[result[t * 3 + k]], positionOf[result[t * 3 + (k + 1) % 3]])]++;
+            }
+        }
+        for (const auto& edge : edgeUse) {
+            unsigned int a = static_cast<unsigned int>(edge.first >> 32);
+            unsigned int b = static_cast<unsigned int>(edge.first & 0xffffffffu);
+            bool borderEdge = edge.second == 1;
+
+            Quadric q = quadrics[a];
+            q.add(quadrics[b]);
+            double weight = q.weight > 0.0 ? q.weight : 1.0;
+
+            Collapse best = { 0, 0, -1.0 };
+            for (int direction = 0; direction < 2; direction++) {
+                unsigned int from = direction == 0 ? a : b;
+                unsigned int to = direction == 0 ? b : a;
+                // Border vertices may only slide along the border
+                if (onBorder[from] && !(onBorder[to] && borderEdge)) {
+                    continue;
+                }
+                double error = std::sqrt(q.evaluate(positions[to]) / weight);
+                if (best.error < 0.0 || error < best.error) {
+                    best = { from, to, error };
+                }
+            }
+            if (best.error >= 0.0 && best.error <= maxError) {
+                collapses.push_back(best);
+            }
+        }
+        if (collapses.empty()) {
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            return a.error < b.error;
+        });
+
+        for (size_t v = 0; v < vertices.size(); v++) {
+            vertexRemap[v] = static_cast<unsigned int>(v);
+        }
+        std::fill(locked.begin(), locked.end(), false);
+
+        size_t remainingTriangles = triangleCount;
+        size_t applied = 0;
+        for (const auto& collapse : collapses) {
+            if (remainingTriangles * 3 <= targetIndexCount) {
+                break;
+            }
+            if (locked[collapse.from] || locked[collapse.to]) {
+                continue;
+            }
+
+            // Reject collapses that flip (or fold flat) a surviving triangle
+            const glm::dvec3& target = positions[collapse.to];
+            bool flips = false;
+            size_t removed = 0;
+            for (unsigned int a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !flips; a++) {
+                unsigned int t = adjacency[a];
+                unsigned int p[3] = { positionOf[result[t * 3]], positionOf[result[t * 3 + 1]], positionOf[result[t * 3 + 2]] };
+                if (p[0] == collapse.to || p[1] == collapse.to || p[2] == collapse.to) {
+                    removed++;
+                    continue;
+                }
+                glm::dvec3 before = glm::cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+                glm::dvec3 corner[3] = { positions[p[0]], positions[p[1]], positions[p[2]] };
+                for (int k = 0; k < 3; k++) {
+                    if (p[k] == collapse.from) {
+                        corner[k] = target;
+                    }
+                }
+                glm::dvec3 after = glm::cross(corner[1] - corner[0], corner[2] - corner[0]);
+                if (glm::dot(before, after) <= 0.0) {
+                    flips = true;
+                }
+            }
+            if (flips) {
+                continue;
+            }
+
+            // Each wedge moves to the wedge at the target with the closest attributes
+            for (unsigned int w = wedgeOffsets[collapse.from]; w < wedgeOffsets[collapse.from + 1]; w++) {
+                const Vertex& source = vertices[wedges[w]];
+                unsigned int bestWedge = wedges[wedgeOffsets[collapse.to]];
+                float bestScore = -FLT_MAX;
+                for (unsigned int c = wedgeOffsets[collapse.to]; c < wedgeOffsets[collapse.to + 1]; c++) {
+                    const Vertex& candidate = vertices[wedges[c]];
+                    float score = glm::dot(source.Normal, candidate.Normal) -
+                        glm::length(source.TexCoords - candidate.TexCoords);
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestWedge = wedges[c];
+                    }
+                }
+                vertexRemap[wedges[w]] = bestWedge;
+            }
+
+            // The whole one-ring is locked so the flip test above stays valid this pass
+            for (unsigned int a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                unsigned int t = adjacency[a];
+                for (int k = 0; k < 3; k++) {
+                    locked[positionOf[result[t * 3 + k]]] = true;
+                }
+            }
+            locked[collapse.to] = true;
+
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            largestError = std::max(largestError, collapse.error);
+            remainingTriangles -= removed;
+            applied++;
+        }
+        if (applied == 0) {
+            break;
+        }
+
+        // Apply the pass and drop the triangles that collapsed to an edge
+        size_t write = 0;
+        for (size_t t = 0; t < triangleCount; t++) {
+            unsigned int a = vertexRemap[result[t * 3]];
+            unsigned int b = vertexRemap[result[t * 3 + 1]];
+            unsigned int c = vertexRemap[result[t * 3 + 2]];
+            if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[a] == positionOf[c]) {
+                continue;
+            }
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (resultError) {
+        *resultError = static_cast<float>(largestError);
+    }
+    return result;
+}
\ No newline at end of file
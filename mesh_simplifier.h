@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include "model.h"
+
+// Import-time LOD generation by quadric error edge collapse (Garland & Heckbert).
+// Vertices are only ever collapsed onto other existing vertices, so a level is
+// just a new index list over the unchanged vertex array and every level of a
+// mesh shares one vertex buffer. Open borders only shrink along themselves and
+// collapses that would flip a triangle are skipped.
+class MeshSimplifier {
+public:
+    // Collapses edges, cheapest first, until at most targetIndexCount indices are
+    // left or the next collapse would move the surface further than maxError
+    // (object-space units). resultError receives the largest error introduced.
+    static std::vector<unsigned int> simplify(const std::vector<Vertex>& vertices,
+        const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError,
+        float* resultError = nullptr);
+};
\ No newline at end of file
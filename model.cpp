@@ -1,4 +1,13 @@
 #include "model.h"
+#include "cooked_mesh.h"
+#include "obj_loader.h"
+#include "mesh_optimizer.h"
+#include "mesh_simplifier.h"
+#include "model_cache.h"
+#include "parallel_for.h"
+#include "instance_batch.h"
+#include "texture_cache.h"
+#include "texture_loader.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -6,80 +15,596 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>  // Add this for std::transform
+#include <cctype>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 // Helper function declarations (add these at the top)
 std::string getFileName(const std::string& path);
-unsigned int createDefaultTexture();
 
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures) {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->textures = textures;
-    setupMesh();
+bool Model::compactVertices = true;
+size_t Model::trianglesSubmitted = 0;
+size_t Model::trianglesFullDetail = 0;
+
+// Per simplified level: index count target (LOD 0 >> level) and the largest
+// surface error allowed, as a fraction of the model's bounding radius
+static const float LOD_MAX_ERRORS[MAX_LOD_LEVELS - 1] = { 0.005f, 0.015f, 0.04f };
+// A level that keeps more than this share of the previous one isn't worth drawing
+static const float LOD_MIN_REDUCTION = 0.8f;
+
+size_t MeshData::getLodIndexTotal() const {
+    size_t total = 0;
+    for (unsigned int level = 1; level < lodCount; level++) {
+        total += lodIndexCounts[level - 1];
+    }
+    return total;
+}
+
+// Half floats keep ~3 significant digits, so tiled UVs far outside 0..1 stay as floats
+static const float PACKED_UV_LIMIT = 4.0f;
+
+static glm::vec2 octahedralEncode(glm::vec3 n) {
+    float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (sum == 0.0f) {
+        return glm::vec2(0.0f);
+    }
+    n /= sum;
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f) {
+        e.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        e.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return e;
 }
 
-void Mesh::setupMesh() {
+void Model::createBuffers() {
+    meshes.resize(pending.size());
+
+    size_t totalVertices = 0;
+    size_t totalIndices = 0;
+    size_t largestMesh = 0;
+    lodCount = 1;
+    for (unsigned int level = 0; level < MAX_LOD_LEVELS; level++) {
+        triangleCounts[level] = 0;
+    }
+    bool smallUVs = true;
+    boundsMin = glm::vec3(FLT_MAX);
+    boundsMax = glm::vec3(-FLT_MAX);
+    for (size_t m = 0; m < pending.size(); m++) {
+        const MeshData& data = pending[m];
+        const Vertex* vertexData = data.getVertices();
+        size_t vertexCount = data.getVertexCount();
+
+        Mesh& mesh = meshes[m];
+        mesh.boundsMin = glm::vec3(FLT_MAX);
+        mesh.boundsMax = glm::vec3(-FLT_MAX);
+        for (size_t i = 0; i < vertexCount; i++) {
+            mesh.boundsMin = glm::min(mesh.boundsMin, vertexData[i].Position);
+            mesh.boundsMax = glm::max(mesh.boundsMax, vertexData[i].Position);
+            if (std::abs(vertexData[i].TexCoords.x) > PACKED_UV_LIMIT || std::abs(vertexData[i].TexCoords.y) > PACKED_UV_LIMIT) {
+                smallUVs = false;
+            }
+        }
+        if (vertexCount == 0) {
+            mesh.boundsMin = mesh.boundsMax = glm::vec3(0.0f);
+        }
+        else {
+            boundsMin = glm::min(boundsMin, mesh.boundsMin);
+            boundsMax = glm::max(boundsMax, mesh.boundsMax);
+        }
+
+        // The mesh's levels sit back to back in the EBO, LOD 0 first
+        for (unsigned int level = 0; level < MAX_LOD_LEVELS; level++) {
+            if (level < data.lodCount) {
+                mesh.firstIndex[level] = static_cast<unsigned int>(totalIndices);
+                mesh.indexCount[level] = static_cast<unsigned int>(
+                    level == 0 ? data.getIndexCount() : data.lodIndexCounts[level - 1]);
+                totalIndices += mesh.indexCount[level];
+            }
+            else {
+                mesh.firstIndex[level] = mesh.firstIndex[level - 1];
+                mesh.indexCount[level] = mesh.indexCount[level - 1];
+            }
+            triangleCounts[level] += mesh.indexCount[level] / 3;
+        }
+        lodCount = std::max(lodCount, data.lodCount);
+
+        mesh.vertexCount = static_cast<unsigned int>(vertexCount);
+        mesh.baseVertex = static_cast<int>(totalVertices);
+        totalVertices += vertexCount;
+        largestMesh = std::max(largestMesh, vertexCount);
+    }
+    if (totalVertices == 0) {
+        boundsMin = boundsMax = glm::vec3(0.0f);
+    }
+
+    // Positions are quantised against the whole model, so one set of packed
+    // uniforms covers every mesh. Indices stay local to their mesh (baseVertex),
+    // so 16 bits are enough as long as no single mesh is larger than that.
+    packed = compactVertices && totalVertices > 0 && smallUVs;
+    indexType = (compactVertices && largestMesh <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    size_t vertexSize = packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    gpuBytes = totalVertices * vertexSize + totalIndices * indexSize;
+    fullBytes = totalVertices * sizeof(Vertex);
+    for (const auto& mesh : meshes) {
+        fullBytes += mesh.indexCount[0] * sizeof(unsigned int);
+    }
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
     glBindVertexArray(VAO);
 
+    // Filled one mesh at a time by uploadMesh()
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
+    glBufferData(GL_ARRAY_BUFFER, totalVertices * vertexSize, nullptr, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, totalIndices * indexSize, nullptr, GL_STATIC_DRAW);
+
+    if (packed) {
+        // Decoded in shader.vert when packedVertex is set (see Draw)
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Position));
 
-    // Vertex positions
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Normal));
 
-    // Vertex normals
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, TexCoords));
+    }
+    else {
+        // Vertex positions
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+
+        // Vertex normals
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+
+        // Vertex texture coords
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+    }
+
+    glBindVertexArray(0);
+}
 
-    // Vertex texture coords
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+void Model::uploadMesh(const MeshData& data, const Mesh& mesh) {
+    const Vertex* vertexData = data.getVertices();
+    const unsigned int* indexData = data.getIndices();
 
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (packed) {
+        glm::vec3 extent = boundsMax - boundsMin;
+        std::vector<PackedVertex> packedData(mesh.vertexCount);
+        for (size_t i = 0; i < mesh.vertexCount; i++) {
+            const Vertex& v = vertexData[i];
+            PackedVertex& p = packedData[i];
+            for (int c = 0; c < 3; c++) {
+                float t = extent[c] > 0.0f ? (v.Position[c] - boundsMin[c]) / extent[c] : 0.0f;
+                p.Position[c] = glm::packUnorm1x16(t);
+            }
+            p.Position[3] = 0;
+            glm::vec2 oct = octahedralEncode(v.Normal);
+            p.Normal[0] = static_cast<int16_t>(glm::packSnorm1x16(oct.x));
+            p.Normal[1] = static_cast<int16_t>(glm::packSnorm1x16(oct.y));
+            p.TexCoords[0] = glm::packHalf1x16(v.TexCoords.x);
+            p.TexCoords[1] = glm::packHalf1x16(v.TexCoords.y);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, mesh.baseVertex * sizeof(PackedVertex),
+            mesh.vertexCount * sizeof(PackedVertex), packedData.data());
+    }
+    else {
+        glBufferSubData(GL_ARRAY_BUFFER, mesh.baseVertex * sizeof(Vertex),
+            mesh.vertexCount * sizeof(Vertex), vertexData);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // LOD 0 and the simplified levels are one contiguous range.
+    // The EBO is VAO state, so it is bound through the VAO rather than directly.
+    size_t lodIndexTotal = data.getLodIndexTotal();
+    const unsigned int* lodData = data.getLodIndices();
+    glBindVertexArray(VAO);
+    if (indexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> shortIndices(indexData, indexData + mesh.indexCount[0]);
+        shortIndices.insert(shortIndices.end(), lodData, lodData + lodIndexTotal);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.firstIndex[0] * sizeof(uint16_t),
+            shortIndices.size() * sizeof(uint16_t), shortIndices.data());
+    }
+    else {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.firstIndex[0] * sizeof(unsigned int),
+            mesh.indexCount[0] * sizeof(unsigned int), indexData);
+        if (lodIndexTotal > 0) {
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (mesh.firstIndex[0] + mesh.indexCount[0]) * sizeof(unsigned int),
+                lodIndexTotal * sizeof(unsigned int), lodData);
+        }
+    }
     glBindVertexArray(0);
 }
 
-void Mesh::Draw(Shader& shader) {
-    // Bind textures
-    unsigned int diffuseNr = 1;
-    unsigned int specularNr = 1;
+static bool sameTextures(const std::vector<Texture>& a, const std::vector<Texture>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].id != b[i].id || a[i].type != b[i].type) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    for (unsigned int i = 0; i < textures.size(); i++) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        std::string number;
-        std::string name = textures[i].type;
+void Model::buildBatches() {
+    batches.clear();
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
 
-        if (name == "texture_diffuse")
-            number = std::to_string(diffuseNr++);
-        else if (name == "texture_specular")
-            number = std::to_string(specularNr++);
+    for (const auto& mesh : meshes) {
+        if (mesh.indexCount[0] == 0) {
+            continue;
+        }
 
-        shader.setInt(("material." + name + number).c_str(), i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        DrawBatch* batch = nullptr;
+        for (auto& candidate : batches) {
+            if (sameTextures(candidate.textures, mesh.textures)) {
+                batch = &candidate;
+                break;
+            }
+        }
+        if (!batch) {
+            batches.push_back(DrawBatch());
+            batch = &batches.back();
+            batch->textures = mesh.textures;
+
+            // Sampler names are fixed per batch, so they are built once here
+            unsigned int diffuseNr = 1;
+            unsigned int specularNr = 1;
+            for (const auto& texture : batch->textures) {
+                std::string number;
+                if (texture.type == "texture_diffuse")
+                    number = std::to_string(diffuseNr++);
+                else if (texture.type == "texture_specular")
+                    number = std::to_string(specularNr++);
+                batch->samplers.push_back("material." + texture.type + number);
+            }
+        }
+
+        for (unsigned int level = 0; level < MAX_LOD_LEVELS; level++) {
+            batch->counts[level].push_back(static_cast<GLsizei>(mesh.indexCount[level]));
+            batch->offsets[level].push_back(reinterpret_cast<const void*>(mesh.firstIndex[level] * indexSize));
+        }
+        batch->baseVertices.push_back(mesh.baseVertex);
+    }
+}
+
+void Model::bindTextures(Shader& shader, const DrawBatch& batch) {
+    for (unsigned int i = 0; i < batch.textures.size(); i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        shader.setInt(batch.samplers[i], i);
+        glBindTexture(GL_TEXTURE_2D, batch.textures[i].id);
     }
     glActiveTexture(GL_TEXTURE0);
+}
+
+Model::Model(const std::string& path)
+    : path(path), state(STATE_IMPORTING), boundsMin(0.0f), boundsMax(0.0f),
+    lodCount(1), triangleCounts(),
+    VAO(0), VBO(0), EBO(0), indirectBuffer(0), indexType(GL_UNSIGNED_INT), packed(false), gpuBytes(0), fullBytes(0),
+    uploadCursor(0), importMs(0.0), uploadMs(0.0) {
+    import();
+    while (!uploadStep()) {
+    }
+
+    if (meshes.empty()) {
+        throw std::runtime_error("No meshes loaded from: " + path);
+    }
+}
+
+Model::Model(const std::string& path, bool deferLoad)
+    : path(path), state(STATE_IMPORTING), boundsMin(0.0f), boundsMax(0.0f),
+    lodCount(1), triangleCounts(),
+    VAO(0), VBO(0), EBO(0), indirectBuffer(0), indexType(GL_UNSIGNED_INT), packed(false), gpuBytes(0), fullBytes(0),
+    uploadCursor(0), importMs(0.0), uploadMs(0.0) {
+    if (!deferLoad) {
+        import();
+        while (!uploadStep()) {
+        }
+    }
+}
+
+Model::~Model() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+    if (indirectBuffer) {
+        glDeleteBuffers(1, &indirectBuffer);
+    }
+}
+
+size_t Model::getTriangleCount(unsigned int lod) const {
+    return triangleCounts[std::min(lod, lodCount - 1)];
+}
+
+void Model::resetTriangleCounters() {
+    trianglesSubmitted = 0;
+    trianglesFullDetail = 0;
+}
+
+void Model::Draw(Shader& shader, unsigned int lod) {
+    if (state != STATE_READY) {
+        return;
+    }
+
+    lod = std::min(lod, lodCount - 1);
+    trianglesSubmitted += triangleCounts[lod];
+    trianglesFullDetail += triangleCounts[0];
+
+    if (packed) {
+        shader.setBool("packedVertex", true);
+        shader.setVec3("packedPositionMin", boundsMin);
+        shader.setVec3("packedPositionExtent", boundsMax - boundsMin);
+    }
 
-    // Draw mesh
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    for (const auto& batch : batches) {
+        bindTextures(shader, batch);
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, batch.counts[lod].data(), indexType, batch.offsets[lod].data(),
+            static_cast<GLsizei>(batch.counts[lod].size()), batch.baseVertices.data());
+    }
     glBindVertexArray(0);
+
+    // Everything else drawn with this shader uses plain float vertices
+    if (packed) {
+        shader.setBool("packedVertex", false);
+    }
 }
 
-Model::Model(const std::string& path) {
+void Model::DrawInstanced(Shader& shader, unsigned int instanceBuffer, const unsigned int* lodInstanceCounts) {
+    if (state != STATE_READY) {
+        return;
+    }
+
+    // Levels past the model's last one draw with its last one; their instances
+    // follow on in the buffer, so they just extend that level's range
+    unsigned int instanceCounts[MAX_LOD_LEVELS] = {};
+    unsigned int instanceTotal = 0;
+    for (unsigned int l = 0; l < MAX_LOD_LEVELS; l++) {
+        instanceCounts[std::min(l, lodCount - 1)] += lodInstanceCounts[l];
+        instanceTotal += lodInstanceCounts[l];
+    }
+    if (instanceTotal == 0) {
+        return;
+    }
+
+    // One command per mesh and level, grouped by batch so each batch is a
+    // contiguous slice of the indirect buffer
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    indirectCommands.clear();
+    std::vector<size_t> batchStarts;
+    for (const auto& batch : batches) {
+        batchStarts.push_back(indirectCommands.size());
+        unsigned int baseInstance = 0;
+        for (unsigned int l = 0; l < lodCount; l++) {
+            if (instanceCounts[l] > 0) {
+                for (size_t m = 0; m < batch.counts[l].size(); m++) {
+                    DrawElementsIndirectCommand command;
+                    command.count = static_cast<GLuint>(batch.counts[l][m]);
+                    command.instanceCount = instanceCounts[l];
+                    command.firstIndex = static_cast<GLuint>(reinterpret_cast<size_t>(batch.offsets[l][m]) / indexSize);
+                    command.baseVertex = batch.baseVertices[m];
+                    command.baseInstance = baseInstance;
+                    indirectCommands.push_back(command);
+                }
+            }
+            baseInstance += instanceCounts[l];
+        }
+    }
+    batchStarts.push_back(indirectCommands.size());
+
+    for (unsigned int l = 0; l < lodCount; l++) {
+        trianglesSubmitted += triangleCounts[l] * instanceCounts[l];
+    }
+    trianglesFullDetail += triangleCounts[0] * instanceTotal;
+
+    if (!indirectBuffer) {
+        glGenBuffers(1, &indirectBuffer);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, indirectCommands.size() * sizeof(DrawElementsIndirectCommand),
+        indirectCommands.data(), GL_STREAM_DRAW);
+
+    shader.setBool("instanced", true);
+    if (packed) {
+        shader.setBool("packedVertex", true);
+        shader.setVec3("packedPositionMin", boundsMin);
+        shader.setVec3("packedPositionExtent", boundsMax - boundsMin);
+    }
+
+    glBindVertexArray(VAO);
+    InstanceBatch::bindAttributes(instanceBuffer);
+    for (size_t b = 0; b < batches.size(); b++) {
+        bindTextures(shader, batches[b]);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType,
+            (const void*)(batchStarts[b] * sizeof(DrawElementsIndirectCommand)),
+            static_cast<GLsizei>(batchStarts[b + 1] - batchStarts[b]), 0);
+    }
+    // The VAO is shared with plain Draw, which must not see instance attributes
+    InstanceBatch::unbindAttributes();
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    shader.setBool("instanced", false);
+    if (packed) {
+        shader.setBool("packedVertex", false);
+    }
+}
+
+void Model::import() {
     std::cout << "\n=== LOADING MODEL: " << path << " ===" << std::endl;
-    loadModel(path);
+    auto importStart = std::chrono::high_resolution_clock::now();
+
+    directory = path.substr(0, path.find_last_of('/'));
+
+    // Fast path: a current .cmesh next to the source skips parsing entirely.
+    // OBJ files go through the dedicated parallel importer; Assimp handles
+    // everything else and is the fallback if the OBJ importer gives up.
+    bool cooked = loadCooked(path);
+    bool imported = cooked;
+
+    if (!imported && ObjLoader::isObjFile(path)) {
+        imported = loadObj(path);
+        if (!imported) {
+            std::cout << "OBJ importer failed, falling back to Assimp" << std::endl;
+            pending.clear();
+        }
+    }
+
+    if (!imported) {
+        imported = loadAssimp(path);
+    }
+
+    // Freshly imported geometry is optimised once, then cooked so the next run
+    // can map it instead of re-importing
+    if (imported && !cooked && !pending.empty()) {
+        optimizeMeshes();
+        generateLods();
+        CookedMesh::write(path, pending);
+    }
+
+    // Decode every image now so the GL thread only has to upload. Distinct files
+    // decode in parallel on the TextureLoader pool; meshes that share a file share
+    // one decode, and files already on the GPU are not decoded at all.
+    struct TextureDecode {
+        TextureImage image;
+        DecodeFuture pixels;
+    };
+    std::unordered_map<std::string, TextureDecode> decoded;
+    bool indexed = false;
+    for (auto& data : pending) {
+        for (auto& texture : data.textures) {
+            if (decoded.count(texture.path)) {
+                continue;
+            }
+            // Index the model folder once, and only if something needs resolving
+            if (!indexed) {
+                buildTextureIndex();
+                indexed = true;
+            }
+
+            TextureDecode decode;
+            decode.image = findTexture(texture.path, texture.type);
+            if (!decode.image.resolvedPath.empty() && !decode.image.cached) {
+                decode.pixels = TextureLoader::decodeCooked(decode.image.resolvedPath);
+            }
+            decoded.emplace(texture.path, decode);
+        }
+    }
+
+    for (auto& entry : decoded) {
+        TextureDecode& decode = entry.second;
+        if (!decode.pixels.valid()) {
+            continue;
+        }
+        decode.image.pixels = decode.pixels.get();
+        if (decode.image.pixels) {
+            std::cout << "      SUCCESS! Loaded texture: " << decode.image.resolvedPath
+                << " (" << decode.image.pixels->width << "x" << decode.image.pixels->height
+                << (decode.image.pixels->compressedFormat ? ", compressed" : "") << ")" << std::endl;
+        }
+        else {
+            std::cout << "ERROR: Could not decode texture: " << decode.image.resolvedPath << std::endl;
+            std::cout << "Creating default texture instead." << std::endl;
+        }
+    }
+
+    std::map<std::string, unsigned int> unresolved;
+    for (auto& data : pending) {
+        for (auto& texture : data.textures) {
+            std::string type = texture.type;
+            texture = decoded[texture.path].image;
+            texture.type = type;
+
+            if (texture.resolvedPath.empty()) {
+                unresolved[texture.path]++;
+            }
+        }
+    }
+    textureIndex.clear();
+
+    if (!unresolved.empty()) {
+        std::cout << "\n=== UNRESOLVED TEXTURES: " << path << " ===" << std::endl;
+        for (const auto& entry : unresolved) {
+            std::cout << "  " << entry.first << " (" << entry.second << " reference"
+                << (entry.second == 1 ? "" : "s") << ")" << std::endl;
+        }
+        std::cout << "Using the default texture for " << unresolved.size() << " file(s)" << std::endl;
+    }
+
+    importMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - importStart).count();
+
+    if (pending.empty()) {
+        cookedFile.reset();
+        state = STATE_FAILED;
+        std::cout << "No meshes loaded from: " << path << std::endl;
+        return;
+    }
+
+    state = STATE_UPLOADING;
+}
+
+bool Model::uploadStep() {
+    if (state != STATE_UPLOADING) {
+        return true;
+    }
+
+    auto uploadStart = std::chrono::high_resolution_clock::now();
+
+    if (uploadCursor == 0) {
+        createBuffers();
+    }
+
+    size_t meshIndex = uploadCursor++;
+    const MeshData& data = pending[meshIndex];
+    Mesh& mesh = meshes[meshIndex];
+    for (const auto& image : data.textures) {
+        Texture texture;
+        texture.handle = TextureCache::acquire(image);
+        texture.id = texture.handle->getId();
+        texture.type = image.type;
+        texture.path = image.path;
+        mesh.textures.push_back(texture);
+    }
+
+    // glBufferSubData copies the geometry, so the import data can go once every mesh is up
+    uploadMesh(data, mesh);
+
+    uploadMs += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - uploadStart).count();
+
+    if (uploadCursor < pending.size()) {
+        return false;
+    }
+
+    pending.clear();
+    pending.shrink_to_fit();
+    cookedFile.reset();
+
+    buildBatches();
 
     // Print summary
-    std::cout << "\n=== MODEL LOAD SUMMARY ===" << std::endl;
+    std::cout << "\n=== MODEL LOAD SUMMARY: " << path << " ===" << std::endl;
     std::cout << "Total meshes: " << meshes.size() << std::endl;
 
     unsigned int totalTextures = 0;
@@ -88,18 +613,112 @@ Model::Model(const std::string& path) {
     }
     std::cout << "Total textures: " << totalTextures << std::endl;
 
-    if (meshes.empty()) {
-        throw std::runtime_error("No meshes loaded from: " + path);
+    std::cout << "Geometry: " << gpuBytes / 1024 << " KB on GPU (" << fullBytes / 1024
+        << " KB as float vertices / 32-bit indices)" << std::endl;
+    std::cout << "LOD triangles:";
+    for (unsigned int level = 0; level < lodCount; level++) {
+        std::cout << (level ? " / " : " ") << triangleCounts[level];
+    }
+    std::cout << std::endl;
+    std::cout << "Draw calls: " << batches.size() << " multi-draw (was " << meshes.size()
+        << " glDrawElements, one per mesh)" << std::endl;
+    std::cout << "Import time: " << importMs << " ms, upload time: " << uploadMs << " ms" << std::endl;
+
+    state = STATE_READY;
+    return true;
+}
+
+void Model::optimizeMeshes() {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Meshes are independent, so optimise them side by side
+    std::vector<MeshOptimizer::Stats> stats(pending.size());
+    parallelFor(pending.size(), [this, &stats](size_t i) {
+        stats[i] = MeshOptimizer::optimize(pending[i].vertices, pending[i].indices);
+    });
+
+    MeshOptimizer::Stats total;
+    for (const auto& meshStats : stats) {
+        total.add(meshStats);
     }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "Mesh optimisation (" << ms << " ms): vertices " << total.verticesBefore
+        << " -> " << total.verticesAfter << ", ACMR " << total.getAcmrBefore()
+        << " -> " << total.getAcmrAfter() << " over " << total.triangles << " triangles" << std::endl;
 }
 
-void Model::Draw(Shader& shader) {
-    for (unsigned int i = 0; i < meshes.size(); i++) {
-        meshes[i].Draw(shader);
+void Model::generateLods() {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    glm::vec3 modelMin(FLT_MAX);
+    glm::vec3 modelMax(-FLT_MAX);
+    for (const auto& data : pending) {
+        for (const auto& vertex : data.vertices) {
+            modelMin = glm::min(modelMin, vertex.Position);
+            modelMax = glm::max(modelMax, vertex.Position);
+        }
+    }
+    float radius = glm::length(modelMax - modelMin) * 0.5f;
+
+    // Each level is simplified from the one before it; meshes run side by
+    // side, at most one thread per core
+    std::vector<float> meshErrors(pending.size(), 0.0f);
+    parallelFor(pending.size(), [this, &meshErrors, radius](size_t i) {
+        MeshData& data = pending[i];
+        float largestError = 0.0f;
+        data.lodIndices.clear();
+        data.lodCount = 1;
+
+        std::vector<unsigned int> previous = data.indices;
+        for (unsigned int level = 1; level < MAX_LOD_LEVELS; level++) {
+            float error = 0.0f;
+            std::vector<unsigned int> simplified = MeshSimplifier::simplify(data.vertices, previous,
+                data.indices.size() >> level, LOD_MAX_ERRORS[level - 1] * radius, &error);
+            if (simplified.empty() || simplified.size() > previous.size() * LOD_MIN_REDUCTION) {
+                break;
+            }
+
+            MeshOptimizer::optimizeVertexCache(simplified, data.vertices.size());
+            data.lodIndices.insert(data.lodIndices.end(), simplified.begin(), simplified.end());
+            data.lodIndexCounts[level - 1] = static_cast<unsigned int>(simplified.size());
+            data.lodCount = level + 1;
+            largestError = std::max(largestError, error);
+            previous.swap(simplified);
+        }
+        meshErrors[i] = largestError;
+    });
+
+    float largestError = 0.0f;
+    for (float error : meshErrors) {
+        largestError = std::max(largestError, error);
     }
+
+    size_t triangles[MAX_LOD_LEVELS] = {};
+    for (const auto& data : pending) {
+        size_t count = data.indices.size();
+        for (unsigned int level = 0; level < MAX_LOD_LEVELS; level++) {
+            if (level > 0 && level < data.lodCount) {
+                count = data.lodIndexCounts[level - 1];
+            }
+            triangles[level] += count / 3;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "LOD generation (" << ms << " ms): triangles";
+    for (unsigned int level = 0; level < MAX_LOD_LEVELS; level++) {
+        std::cout << (level ? " / " : " ") << triangles[level];
+    }
+    std::cout << ", max error " << (radius > 0.0f ? largestError / radius * 100.0f : 0.0f)
+        << "% of the model radius" << std::endl;
 }
 
-void Model::loadModel(const std::string& path) {
+bool Model::loadAssimp(const std::string& path) {
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(path,
         aiProcess_Triangulate |
@@ -108,18 +727,87 @@ void Model::loadModel(const std::string& path) {
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
-        return;
+        return false;
     }
 
-    directory = path.substr(0, path.find_last_of('/'));
     processNode(scene->mRootNode, scene);
+    return true;
+}
+
+bool Model::loadCooked(const std::string& path) {
+    std::shared_ptr<CookedMesh> cooked = std::make_shared<CookedMesh>();
+    if (!cooked->open(path)) {
+        return false;
+    }
+
+    std::cout << "Using cooked mesh: " << CookedMesh::cachePathFor(path) << std::endl;
+
+    for (unsigned int i = 0; i < cooked->getMeshCount(); i++) {
+        const CookedMesh::MeshEntry& entry = cooked->getMeshEntry(i);
+
+        MeshData data;
+        data.mappedVertices = cooked->getVertices(i);
+        data.mappedVertexCount = entry.vertexCount;
+        data.mappedIndices = cooked->getIndices(i);
+        data.mappedIndexCount = entry.indexCount;
+        data.mappedLodIndices = cooked->getLodIndices(i);
+        data.lodCount = entry.lodCount;
+        for (unsigned int level = 1; level < entry.lodCount; level++) {
+            data.lodIndexCounts[level - 1] = entry.lodIndexCounts[level - 1];
+        }
+
+        for (const auto& ref : cooked->getTextureRefs(i)) {
+            TextureImage texture;
+            texture.type = ref.type;
+            texture.path = ref.path;
+            data.textures.push_back(texture);
+        }
+
+        pending.push_back(std::move(data));
+    }
+
+    // The geometry points into the mapping, so keep it open until uploadStep() is done
+    cookedFile = cooked;
+    return true;
+}
+
+bool Model::loadObj(const std::string& path) {
+    ObjScene scene;
+    if (!ObjLoader::load(path, scene)) {
+        return false;
+    }
+
+    for (auto& obj : scene.meshes) {
+        MeshData data;
+        data.vertices = std::move(obj.vertices);
+        data.indices = std::move(obj.indices);
+
+        const ObjMaterial* material = scene.findMaterial(obj.material);
+        if (material) {
+            std::cout << "  Material: " << material->name << std::endl;
+
+            auto addTexture = [&](const std::string& file, const std::string& typeName) {
+                if (file.empty()) return;
+                TextureImage texture;
+                texture.type = typeName;
+                texture.path = file;
+                data.textures.push_back(texture);
+            };
+            addTexture(material->diffuseMap, "texture_diffuse");
+            addTexture(material->specularMap, "texture_specular");
+        }
+
+        pending.push_back(std::move(data));
+    }
+
+    return true;
 }
 
 void Model::processNode(aiNode* node, const aiScene* scene) {
     // Process all the node's meshes
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+        pending.push_back(processMesh(mesh, scene));
     }
 
     // Then do the same for each of its children
@@ -128,10 +816,10 @@ void Model::processNode(aiNode* node, const aiScene* scene) {
     }
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
+MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene) {
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+    std::vector<TextureImage> textures;
 
     // Process vertices
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -195,12 +883,12 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         }
 
         // 3. Load textures with better path handling
-        std::vector<Texture> diffuseMaps = loadMaterialTextures(material,
+        std::vector<TextureImage> diffuseMaps = loadMaterialTextures(material,
             aiTextureType_DIFFUSE, "texture_diffuse");
         textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
 
         // 4. Also try other texture types
-        std::vector<Texture> specularMaps = loadMaterialTextures(material,
+        std::vector<TextureImage> specularMaps = loadMaterialTextures(material,
             aiTextureType_SPECULAR, "texture_specular");
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
@@ -210,11 +898,15 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         }
     }
 
-    return Mesh(vertices, indices, textures);
+    MeshData data;
+    data.vertices = std::move(vertices);
+    data.indices = std::move(indices);
+    data.textures = std::move(textures);
+    return data;
 }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName) {
-    std::vector<Texture> textures;
+std::vector<TextureImage> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName) {
+    std::vector<TextureImage> textures;
 
     for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
         aiString str;
@@ -231,8 +923,8 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType
         }
 
         if (!skip) {
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), this->directory);
+            // Decoded later in import(), once every mesh is known
+            TextureImage texture;
             texture.type = typeName;
             texture.path = str.C_Str();
             textures.push_back(texture);
@@ -253,100 +945,108 @@ std::string getFileName(const std::string& path) {
     return path;
 }
 
-// Create a default texture if none found
-unsigned int createDefaultTexture() {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    // Create 2x2 checkerboard pattern
-    unsigned char data[] = {
-        255, 0, 0, 255,     0, 255, 0, 255,
-        0, 255, 0, 255,     255, 0, 0, 255
-    };
-
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    return textureID;
+// Lower-cased, forward-slashed form used for index keys
+static std::string normalizeTextureKey(const std::string& path) {
+    std::string key = path;
+    std::replace(key.begin(), key.end(), '\\', '/');
+    while (key.compare(0, 2, "./") == 0) {
+        key.erase(0, 2);
+    }
+    std::transform(key.begin(), key.end(), key.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
 }
 
-unsigned int Model::TextureFromFile(const char* path, const std::string& directory) {
-    std::string filename = std::string(path);
+void Model::buildTextureIndex() {
+    namespace fs = std::filesystem;
 
-    std::cout << "  Looking for texture: " << filename << std::endl;
+    textureIndex.clear();
 
-    // Try different paths
-    std::vector<std::string> tryPaths;
+    // Files in the model folder and up to two levels below it (car/, skinhp/, skin00 - skin07, ...)
+    const int maxDepth = 2;
 
-    // 1. Original path relative to model
-    tryPaths.push_back(directory + "/" + filename);
-
-    // 2. Just the filename (might be in same directory)
-    tryPaths.push_back(directory + "/" + getFileName(filename));
+    struct Entry {
+        int depth;
+        std::string relative;
+        std::string path;
+    };
+    std::vector<Entry> entries;
+
+    std::error_code ec;
+    fs::recursive_directory_iterator it(directory, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            if (it.depth() >= maxDepth) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        if (!it->is_regular_file(ec)) {
+            continue;
+        }
 
-    // 3. Check common subdirectories for car models
-    tryPaths.push_back(directory + "/car/" + filename);
-    tryPaths.push_back(directory + "/car/" + getFileName(filename));
+        Entry entry;
+        entry.depth = it.depth();
+        entry.relative = normalizeTextureKey(fs::relative(it->path(), directory, ec).generic_string());
+        entry.path = it->path().generic_string();
+        entries.push_back(entry);
+    }
 
-    tryPaths.push_back(directory + "/skinhp/" + filename);
-    tryPaths.push_back(directory + "/skinhp/" + getFileName(filename));
+    // Shallower files win a filename clash, then alphabetical order, so car/
+    // beats skin00/ - the same preference the old path probing had
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.depth != b.depth ? a.depth < b.depth : a.relative < b.relative;
+    });
 
-    // Try skin00 - skin07 folders
-    for (int i = 0; i <= 7; i++) {
-        std::string skinFolder = "/skin0" + std::to_string(i) + "/";
-        tryPaths.push_back(directory + skinFolder + filename);
-        tryPaths.push_back(directory + skinFolder + getFileName(filename));
+    for (const auto& entry : entries) {
+        textureIndex.emplace(entry.relative, entry.path);
+        textureIndex.emplace(getFileName(entry.relative), entry.path);
     }
 
-    // 4. Try without any path modifications
-    tryPaths.push_back(filename);
-
-    unsigned int textureID = 0;
+    std::cout << "Indexed " << entries.size() << " files under " << directory << std::endl;
+}
 
-    for (const auto& tryPath : tryPaths) {
-        std::cout << "    Trying: " << tryPath << std::endl;
+std::string Model::resolveTexturePath(const std::string& file) const {
+    std::string key = normalizeTextureKey(file);
 
-        int width, height, nrComponents;
-        unsigned char* data = stbi_load(tryPath.c_str(), &width, &height, &nrComponents, 0);
+    // 1. Path as written, relative to the model
+    auto it = textureIndex.find(key);
+    if (it != textureIndex.end()) {
+        return it->second;
+    }
 
-        if (data) {
-            std::cout << "      SUCCESS! Loaded texture: " << tryPath
-                << " (" << width << "x" << height << ")" << std::endl;
+    // 2. Just the filename, wherever it sits in the model folder
+    it = textureIndex.find(getFileName(key));
+    if (it != textureIndex.end()) {
+        return it->second;
+    }
 
-            GLenum format;
-            if (nrComponents == 1)
-                format = GL_RED;
-            else if (nrComponents == 3)
-                format = GL_RGB;
-            else if (nrComponents == 4)
-                format = GL_RGBA;
-            else {
-                stbi_image_free(data);
-                continue;
-            }
+    // 3. Absolute path or path relative to the working directory
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(file, ec)) {
+        return file;
+    }
 
-            glGenTextures(1, &textureID);
-            glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+    return std::string();
+}
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+TextureImage Model::findTexture(const std::string& file, const std::string& typeName) const {
+    TextureImage image;
+    image.type = typeName;
+    image.path = file;
 
-            stbi_image_free(data);
-            return textureID;
-        }
-        else {
-            std::cout << "      Failed to load." << std::endl;
-        }
+    std::string found = resolveTexturePath(file);
+    if (found.empty()) {
+        // Reported once per model at the end of import()
+        return image;
     }
 
-    std::cout << "ERROR: Could not load texture: " << filename << std::endl;
-    std::cout << "Creating default texture instead." << std::endl;
+    image.resolvedPath = ModelCache::canonicalPath(found);
 
-    // Create a default checkerboard texture
-    return createDefaultTexture();
+    // Another model already uploaded this file - nothing to decode
+    image.cached = TextureCache::findByPath(image.resolvedPath);
+    if (image.cached) {
+        std::cout << "    Already on GPU: " << found << std::endl;
+    }
+    return image;
 }
\ No newline at end of file
@@ -1,4 +1,8 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <glad/glad.h>
@@ -20,42 +24,200 @@ struct Vertex {
     glm::vec2 TexCoords;
 };
 
+// 16-byte GPU form of Vertex picked by Model when it is lossless enough:
+// unorm16 position within the model bounds, octahedral snorm16 normal, half-float UV
+struct PackedVertex {
+    uint16_t Position[4];   // [3] is padding
+    int16_t Normal[2];
+    uint16_t TexCoords[2];
+};
+
+class TextureHandle;
+struct DecodedImage;
+
 struct Texture {
     unsigned int id;
     std::string type;
     std::string path;
+    std::shared_ptr<TextureHandle> handle;  // Keeps the shared GL texture alive
 };
 
-class Mesh {
-public:
+// Decoded image waiting for upload on the GL thread.
+// pixels is null if the file could not be found (a default texture is used)
+// or if TextureCache already had it (cached is set instead).
+struct TextureImage {
+    std::string type;
+    std::string path;
+    std::string resolvedPath;   // Canonical file path, the TextureCache key
+    std::shared_ptr<const DecodedImage> pixels;     // Level 0 plus CPU-built mips
+    std::shared_ptr<TextureHandle> cached;
+};
+
+// LOD 0 (the imported mesh) plus up to three MeshSimplifier levels
+const unsigned int MAX_LOD_LEVELS = 4;
+
+// CPU-side result of importing one mesh. Geometry is either owned (vertices /
+// indices) or points into the mapped .cmesh file the Model keeps open until upload.
+struct MeshData {
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+    const Vertex* mappedVertices = nullptr;
+    size_t mappedVertexCount = 0;
+    const unsigned int* mappedIndices = nullptr;
+    size_t mappedIndexCount = 0;
+    std::vector<TextureImage> textures;
 
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
-    void Draw(Shader& shader);
+    // Simplified levels 1.. back to back, indexing the same vertices as LOD 0
+    std::vector<unsigned int> lodIndices;
+    const unsigned int* mappedLodIndices = nullptr;
+    unsigned int lodCount = 1;      // Including LOD 0
+    unsigned int lodIndexCounts[MAX_LOD_LEVELS - 1] = {};
 
-private:
-    unsigned int VAO, VBO, EBO;
-    void setupMesh();
+    const Vertex* getVertices() const { return vertices.empty() ? mappedVertices : vertices.data(); }
+    size_t getVertexCount() const { return vertices.empty() ? mappedVertexCount : vertices.size(); }
+    const unsigned int* getIndices() const { return indices.empty() ? mappedIndices : indices.data(); }
+    size_t getIndexCount() const { return indices.empty() ? mappedIndexCount : indices.size(); }
+    const unsigned int* getLodIndices() const { return lodIndices.empty() ? mappedLodIndices : lodIndices.data(); }
+    size_t getLodIndexTotal() const;    // Indices of levels 1..
 };
 
+// One mesh's range in its Model's shared vertex and index buffers
+class Mesh {
+public:
+    std::vector<Texture> textures;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    unsigned int firstIndex[MAX_LOD_LEVELS] = {};  // Per level; past the mesh's last level it repeats
+    unsigned int indexCount[MAX_LOD_LEVELS] = {};
+    unsigned int vertexCount = 0;
+    int baseVertex = 0;     // Indices are local to the mesh
+};
+
+class CookedMesh;
+
 class Model {
 public:
+    // Imports and uploads immediately on the calling (GL) thread.
+    // Throws std::runtime_error if nothing could be loaded.
     Model(const std::string& path);
-    void Draw(Shader& shader);
+
+    // With deferLoad the Model starts empty; AssetLoader then runs import() on a
+    // worker thread and uploadStep() on the GL thread until it is ready
+    Model(const std::string& path, bool deferLoad);
+    ~Model();
+
+    // Draws nothing until the model is ready. lod is clamped to getLodCount() - 1.
+    void Draw(Shader& shader, unsigned int lod = 0);
+
+    // Draws the model once per instance in instanceBuffer (see InstanceBatch),
+    // with one glMultiDrawElementsIndirect per texture set. Instances must be
+    // sorted by LOD: the first lodInstanceCounts[0] use LOD 0, and so on.
+    void DrawInstanced(Shader& shader, unsigned int instanceBuffer, const unsigned int* lodInstanceCounts);
+
+    // CPU half of loading: parse, decode textures. Touches no GL state.
+    void import();
+    // GL half of loading: uploads one mesh per call, returns true once finished (or failed)
+    bool uploadStep();
+
+    bool isReady() const { return state == STATE_READY; }
+    bool hasFailed() const { return state == STATE_FAILED; }
+    const std::string& getPath() const { return path; }
+
+    // Upload PackedVertex / 16-bit indices where possible (applies to models uploaded afterwards)
+    static bool compactVertices;
+
+    // glMultiDrawElementsBaseVertex calls per Draw: one per distinct texture set
+    unsigned int getDrawCallCount() const { return batches.size(); }
+
+    unsigned int getLodCount() const { return lodCount; }
+    size_t getTriangleCount(unsigned int lod) const;
+
+    // Triangles every Draw submitted since the last reset, and what they would
+    // have been at LOD 0
+    static void resetTriangleCounters();
+    static size_t getTrianglesSubmitted() { return trianglesSubmitted; }
+    static size_t getTrianglesFullDetail() { return trianglesFullDetail; }
 
     // Optional: Add these if you want mesh info
     unsigned int getMeshCount() const { return meshes.size(); }
     std::string getMeshName(unsigned int index) const { return "Mesh_" + std::to_string(index); }
 
+    // Object-space bounds of all meshes
+    glm::vec3 getBoundsMin() const { return boundsMin; }
+    glm::vec3 getBoundsMax() const { return boundsMax; }
+
 private:
+    enum LoadState {
+        STATE_IMPORTING,
+        STATE_UPLOADING,
+        STATE_READY,
+        STATE_FAILED
+    };
+
+    std::string path;
+    std::atomic<int> state;
     std::vector<Mesh> meshes;
     std::string directory;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
+    // Every mesh lives in one VBO / EBO behind a single VAO. Meshes with the
+    // same textures are drawn together by one glMultiDrawElementsBaseVertex.
+    struct DrawBatch {
+        std::vector<Texture> textures;
+        std::vector<std::string> samplers;  // "material.texture_diffuse1" etc., one per texture
+        std::vector<GLsizei> counts[MAX_LOD_LEVELS];
+        std::vector<const void*> offsets[MAX_LOD_LEVELS];   // Byte offsets into the EBO
+        std::vector<GLint> baseVertices;
+    };
+    std::vector<DrawBatch> batches;
+
+    // Layout fixed by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+    std::vector<DrawElementsIndirectCommand> indirectCommands;  // Rebuilt by each DrawInstanced
+    unsigned int lodCount;
+    size_t triangleCounts[MAX_LOD_LEVELS];
+    static size_t trianglesSubmitted;
+    static size_t trianglesFullDetail;
+    unsigned int VAO, VBO, EBO;
+    unsigned int indirectBuffer;
+    GLenum indexType;
+    bool packed;
+    size_t gpuBytes;
+    size_t fullBytes;
+
+    // Import results waiting for uploadStep()
+    std::vector<MeshData> pending;
+    std::shared_ptr<CookedMesh> cookedFile;
+    size_t uploadCursor;
+    double importMs;
+    double uploadMs;
+
+    // Lower-cased relative path and bare filename -> file, for every file in the
+    // model folder. Built once per import() so textures resolve with one lookup.
+    std::unordered_map<std::string, std::string> textureIndex;
+
+    void createBuffers();   // Sizes the shared buffers and lays out meshes from pending
+    void uploadMesh(const MeshData& data, const Mesh& mesh);
+    void buildBatches();
+    static void bindTextures(Shader& shader, const DrawBatch& batch);
 
-    void loadModel(const std::string& path);
+    bool loadCooked(const std::string& path);
+    void optimizeMeshes();  // MeshOptimizer on every pending mesh, before cooking
+    void generateLods();    // MeshSimplifier levels for every pending mesh, after optimizing
+    bool loadObj(const std::string& path);
+    bool loadAssimp(const std::string& path);
     void processNode(aiNode* node, const aiScene* scene);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
-    unsigned int TextureFromFile(const char* path, const std::string& directory);
+    MeshData processMesh(aiMesh* mesh, const aiScene* scene);
+    std::vector<TextureImage> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+    void buildTextureIndex();
+    std::string resolveTexturePath(const std::string& file) const;
+    // Resolves a texture reference and checks TextureCache; decoding is left to import()
+    TextureImage findTexture(const std::string& file, const std::string& typeName) const;
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "model_cache.h"
+#include "model.h"
+#include "asset_loader.h"
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+
+unsigned int ModelCache::hits = 0;
+unsigned int ModelCache::misses = 0;
+
+std::unordered_map<std::string, std::weak_ptr<Model>>& ModelCache::entries() {
+    static std::unordered_map<std::string, std::weak_ptr<Model>> cache;
+    return cache;
+}
+
+std::string ModelCache::canonicalPath(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    if (ec) {
+        canonical = std::filesystem::absolute(path, ec);
+    }
+
+    // Use forward slashes so "models\\Tree.obj" and "models/Tree.obj" share an entry
+    std::string key = canonical.lexically_normal().generic_string();
+
+#ifdef _WIN32
+    // Windows paths are case-insensitive
+    for (auto& c : key) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+#endif
+
+    return key;
+}
+
+std::shared_ptr<Model> ModelCache::acquire(const std::string& path) {
+    return acquire(path, false);
+}
+
+std::shared_ptr<Model> ModelCache::acquireAsync(const std::string& path) {
+    return acquire(path, true);
+}
+
+std::shared_ptr<Model> ModelCache::acquire(const std::string& path, bool async) {
+    std::string key = canonicalPath(path);
+    auto& cache = entries();
+
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        if (std::shared_ptr<Model> existing = it->second.lock()) {
+            hits++;
+            std::cout << "ModelCache: reusing " << path
+                << " (" << existing.use_count() - 1 << " other owners)" << std::endl;
+            return existing;
+        }
+    }
+
+    // Not loaded yet (or every previous owner has gone) - import it now
+    misses++;
+    std::shared_ptr<Model> model;
+    if (async) {
+        model = std::make_shared<Model>(path, true);
+        AssetLoader::enqueue(model);
+    }
+    else {
+        model = std::make_shared<Model>(path);
+    }
+    cache[key] = model;
+    return model;
+}
+
+unsigned int ModelCache::liveCount() {
+    unsigned int count = 0;
+    for (const auto& entry : entries()) {
+        if (!entry.second.expired()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ModelCache::printStats() {
+    std::cout << "\n=== MODEL CACHE ===" << std::endl;
+    std::cout << "Imports: " << misses << ", reused: " << hits << std::endl;
+    std::cout << "Models alive: " << liveCount() << std::endl;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class Model;
+
+// Process-wide cache of imported models, keyed by canonical file path.
+// Every Car / Tree / ModelObject that asks for the same file gets the same
+// Model (one Assimp import, one set of VBO/EBO/textures). The Model is freed
+// when the last owner releases its shared_ptr.
+class ModelCache {
+public:
+    // Returns the shared Model for this file, importing it on first use.
+    // Throws whatever Model's constructor throws if the import fails.
+    static std::shared_ptr<Model> acquire(const std::string& path);
+
+    // Same, but never blocks: a new model is handed to AssetLoader and the
+    // returned Model stays empty until Model::isReady()
+    static std::shared_ptr<Model> acquireAsync(const std::string& path);
+
+    // Normalised absolute path used as the cache key
+    static std::string canonicalPath(const std::string& path);
+
+    // Number of models currently alive in the cache
+    static unsigned int liveCount();
+
+    static void printStats();
+
+private:
+    static std::shared_ptr<Model> acquire(const std::string& path, bool async);
+    static std::unordered_map<std::string, std::weak_ptr<Model>>& entries();
+
+    static unsigned int hits;
+    static unsigned int misses;
+};
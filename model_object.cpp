@@ -0,0 +1,44 @@
+#include "model_object.h"
+#include "model.h"
+#include "model_cache.h"
+#include "shader.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+
+ModelObject::ModelObject(const std::string& modelPath, glm::vec3 pos)
+    : model(nullptr), position(pos), scale(1.0f), color(1.0f), rotation(0.0f) {
+    load(modelPath);
+}
+
+ModelObject::~ModelObject() {
+    // model is shared; ModelCache frees it with the last owner
+}
+
+bool ModelObject::load(const std::string& modelPath) {
+    try {
+        model = ModelCache::acquire(modelPath);
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cout << "Failed to load model object from " << modelPath
+            << ": " << e.what() << std::endl;
+        model = nullptr;
+        return false;
+    }
+}
+
+void ModelObject::draw(Shader& shader) {
+    if (!model) {
+        return;
+    }
+
+    glm::mat4 modelMat = glm::mat4(1.0f);
+    modelMat = glm::translate(modelMat, position);
+    modelMat = glm::rotate(modelMat, glm::radians(rotation), glm::vec3(0.0f, 1.0f, 0.0f));
+    modelMat = glm::scale(modelMat, scale);
+
+    shader.setMat4("model", modelMat);
+    shader.setBool("useColorOverride", true);
+    shader.setVec3("colorOverride", color);
+    model->Draw(shader);
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 
 class Model;
@@ -7,7 +8,7 @@ class Shader;
 
 class ModelObject {
 private:
-    Model* model;
+    std::shared_ptr<Model> model;  // Shared through ModelCache
     glm::vec3 position;
     glm::vec3 scale;
     glm::vec3 color;
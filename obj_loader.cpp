@@ -0,0 +1,670 @@
+#include "obj_loader.h"
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    // Negative (relative) OBJ indices can only be resolved once we know how
+    // many vertices the earlier chunks defined, so they are stored biased
+    // below zero and fixed up during the merge
+    const int32_t RELATIVE_BIAS = 0x40000000;
+
+    // Below this, splitting the file costs more than it saves
+    const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+    const double POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    struct Corner {
+        int32_t v, vt, vn;
+    };
+
+    // Faces that share the same object/material state. A run that does not
+    // set object or material inherits it from whatever came before it in the file.
+    struct Run {
+        bool setsObject = false;
+        bool setsMaterial = false;
+        std::string object;
+        std::string material;
+        std::vector<Corner> corners;
+        std::vector<uint32_t> faceSizes;
+    };
+
+    struct Chunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        std::vector<float> positions;   // xyz
+        std::vector<float> texCoords;   // uv
+        std::vector<float> normals;     // xyz
+        std::vector<Run> runs;
+        std::vector<std::string> materialLibs;
+        size_t lines = 0;
+        bool ok = true;
+    };
+
+    // Faces of one output mesh with every index made absolute and 0-based (-1 = missing)
+    struct MeshBuild {
+        std::string name;
+        std::string material;
+        std::vector<Corner> corners;
+        std::vector<uint32_t> faceSizes;
+    };
+
+    struct CornerHash {
+        size_t operator()(const Corner& c) const {
+            return (size_t(uint32_t(c.v)) * 73856093u) ^ (size_t(uint32_t(c.vt)) * 19349663u) ^ (size_t(uint32_t(c.vn)) * 83492791u);
+        }
+    };
+
+    struct CornerEqual {
+        bool operator()(const Corner& a, const Corner& b) const {
+            return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
+        }
+    };
+
+    inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    inline const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        return p;
+    }
+
+    // Matches "word" followed by whitespace or end of line; returns the rest of the line
+    inline bool keyword(const char* p, const char* end, const char* word, const char*& rest) {
+        size_t length = std::strlen(word);
+        if (size_t(end - p) < length || std::memcmp(p, word, length) != 0) return false;
+        const char* after = p + length;
+        if (after < end && *after != ' ' && *after != '\t' && *after != '\r') return false;
+        rest = skipSpaces(after, end);
+        return true;
+    }
+
+    // Rest of the line with trailing whitespace removed
+    std::string readName(const char* p, const char* end) {
+        while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+        return std::string(p, end);
+    }
+
+    // Locale-independent decimal float parser ([sign] digits [. digits] [e[sign]digits]).
+    // Returns nullptr if no number is present.
+    const char* parseFloat(const char* p, const char* end, float& out) {
+        p = skipSpaces(p, end);
+
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = (*p == '-');
+            p++;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool sawDigit = false;
+
+        while (p < end && isDigit(*p)) {
+            sawDigit = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) digits++;
+            }
+            else {
+                exponent++;
+            }
+            p++;
+        }
+
+        if (p < end && *p == '.') {
+            p++;
+            while (p < end && isDigit(*p)) {
+                sawDigit = true;
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    if (mantissa != 0) digits++;
+                    exponent--;
+                }
+                p++;
+            }
+        }
+
+        if (!sawDigit) return nullptr;
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            const char* q = p + 1;
+            bool exponentNegative = false;
+            if (q < end && (*q == '-' || *q == '+')) {
+                exponentNegative = (*q == '-');
+                q++;
+            }
+            if (q < end && isDigit(*q)) {
+                int value = 0;
+                while (q < end && isDigit(*q)) {
+                    if (value < 10000) value = value * 10 + (*q - '0');
+                    q++;
+                }
+                exponent += exponentNegative ? -value : value;
+                p = q;
+            }
+        }
+
+        double value = double(mantissa);
+        if (exponent < 0) {
+            value = (exponent >= -22) ? value / POW10[-exponent] : value * std::pow(10.0, exponent);
+        }
+        else if (exponent > 0) {
+            value = (exponent <= 22) ? value * POW10[exponent] : value * std::pow(10.0, exponent);
+        }
+
+        out = static_cast<float>(negative ? -value : value);
+        return p;
+    }
+
+    const char* parseIndex(const char* p, const char* end, int32_t& out) {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = (*p == '-');
+            p++;
+        }
+        if (p >= end || !isDigit(*p)) return nullptr;
+
+        int64_t value = 0;
+        while (p < end && isDigit(*p)) {
+            value = value * 10 + (*p - '0');
+            if (value >= RELATIVE_BIAS) return nullptr;
+            p++;
+        }
+
+        out = static_cast<int32_t>(negative ? -value : value);
+        return p;
+    }
+
+    // Positive indices stay 1-based absolute; negative ones become chunk-relative
+    inline int32_t encodeIndex(int32_t raw, size_t localCount) {
+        return raw >= 0 ? raw : static_cast<int32_t>(localCount) + raw - RELATIVE_BIAS;
+    }
+
+    inline int32_t resolveIndex(int32_t encoded, size_t chunkBase) {
+        if (encoded > 0) return encoded - 1;
+        if (encoded == 0) return -1;
+        return static_cast<int32_t>(chunkBase) + (encoded + RELATIVE_BIAS);
+    }
+
+    Run& beginRun(Chunk& chunk) {
+        if (!chunk.runs.back().faceSizes.empty()) {
+            chunk.runs.emplace_back();
+        }
+        return chunk.runs.back();
+    }
+
+    bool parseFace(Chunk& chunk, const char* p, const char* end) {
+        Run& run = chunk.runs.back();
+        size_t positionCount = chunk.positions.size() / 3;
+        size_t texCoordCount = chunk.texCoords.size() / 2;
+        size_t normalCount = chunk.normals.size() / 3;
+
+        uint32_t count = 0;
+        while (true) {
+            p = skipSpaces(p, end);
+            if (p >= end || *p == '\r' || *p == '#') break;
+
+            Corner corner = { 0, 0, 0 };
+            p = parseIndex(p, end, corner.v);
+            if (!p) return false;
+
+            if (p < end && *p == '/') {
+                p++;
+                if (p < end && *p != '/') {
+                    p = parseIndex(p, end, corner.vt);
+                    if (!p) return false;
+                }
+                if (p < end && *p == '/') {
+                    p++;
+                    p = parseIndex(p, end, corner.vn);
+                    if (!p) return false;
+                }
+            }
+
+            corner.v = encodeIndex(corner.v, positionCount);
+            corner.vt = encodeIndex(corner.vt, texCoordCount);
+            corner.vn = encodeIndex(corner.vn, normalCount);
+            run.corners.push_back(corner);
+            count++;
+        }
+
+        // Points and lines are dropped, same as the triangle-only Assimp path
+        if (count < 3) {
+            run.corners.resize(run.corners.size() - count);
+        }
+        else {
+            run.faceSizes.push_back(count);
+        }
+        return true;
+    }
+
+    bool parseLine(Chunk& chunk, const char* p, const char* end) {
+        if (p >= end) return true;
+
+        const char* rest = nullptr;
+        float x, y, z;
+
+        switch (*p) {
+        case 'v':
+            if (keyword(p, end, "v", rest)) {
+                if (!(rest = parseFloat(rest, end, x)) || !(rest = parseFloat(rest, end, y)) || !parseFloat(rest, end, z)) return false;
+                chunk.positions.push_back(x);
+                chunk.positions.push_back(y);
+                chunk.positions.push_back(z);
+            }
+            else if (keyword(p, end, "vt", rest)) {
+                if (!(rest = parseFloat(rest, end, x))) return false;
+                if (!parseFloat(rest, end, y)) y = 0.0f;
+                chunk.texCoords.push_back(x);
+                chunk.texCoords.push_back(y);
+            }
+            else if (keyword(p, end, "vn", rest)) {
+                if (!(rest = parseFloat(rest, end, x)) || !(rest = parseFloat(rest, end, y)) || !parseFloat(rest, end, z)) return false;
+                chunk.normals.push_back(x);
+                chunk.normals.push_back(y);
+                chunk.normals.push_back(z);
+            }
+            return true;
+
+        case 'f':
+            if (keyword(p, end, "f", rest)) {
+                return parseFace(chunk, rest, end);
+            }
+            return true;
+
+        case 'o':
+        case 'g':
+            if (keyword(p, end, "o", rest) || keyword(p, end, "g", rest)) {
+                Run& run = beginRun(chunk);
+                run.setsObject = true;
+                run.object = readName(rest, end);
+                if (run.object.empty()) run.object = "default";
+            }
+            return true;
+
+        case 'u':
+            if (keyword(p, end, "usemtl", rest)) {
+                Run& run = beginRun(chunk);
+                run.setsMaterial = true;
+                run.material = readName(rest, end);
+            }
+            return true;
+
+        case 'm':
+            if (keyword(p, end, "mtllib", rest)) {
+                chunk.materialLibs.push_back(readName(rest, end));
+            }
+            return true;
+
+        default:
+            // Comments, smoothing groups and anything we do not render
+            return true;
+        }
+    }
+
+    void parseChunk(Chunk& chunk) {
+        chunk.runs.emplace_back();
+
+        const char* p = chunk.begin;
+        while (p < chunk.end) {
+            // memchr is vectorised in every C runtime we build against
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+            if (!lineEnd) lineEnd = chunk.end;
+
+            chunk.lines++;
+            if (!parseLine(chunk, skipSpaces(p, lineEnd), lineEnd)) {
+                std::cout << "  OBJ parse error near: " << readName(p, lineEnd) << std::endl;
+                chunk.ok = false;
+                return;
+            }
+            p = lineEnd + 1;
+        }
+    }
+
+    glm::vec3 readVec3(const std::vector<float>& data, int32_t index) {
+        return glm::vec3(data[index * 3], data[index * 3 + 1], data[index * 3 + 2]);
+    }
+
+    // Triangulates (fan) and welds one mesh; corners without a normal get the
+    // flat face normal and are never welded, like aiProcess_GenNormals
+    void buildMesh(const MeshBuild& build, const std::vector<float>& positions,
+        const std::vector<float>& texCoords, const std::vector<float>& normals, ObjMeshData& out) {
+        out.name = build.name;
+        out.material = build.material;
+        out.vertices.reserve(build.corners.size() / 2);
+        out.indices.reserve(build.corners.size() * 3 / 2);
+
+        std::unordered_map<Corner, unsigned int, CornerHash, CornerEqual> welded;
+        welded.reserve(build.corners.size());
+
+        std::vector<unsigned int> polygon;
+        size_t cursor = 0;
+
+        for (uint32_t faceSize : build.faceSizes) {
+            const Corner* face = &build.corners[cursor];
+            cursor += faceSize;
+
+            bool needsFaceNormal = false;
+            for (uint32_t i = 0; i < faceSize; i++) {
+                if (face[i].vn < 0) needsFaceNormal = true;
+            }
+
+            glm::vec3 faceNormal(0.0f);
+            if (needsFaceNormal) {
+                // Newell's method handles quads and n-gons as well as triangles
+                for (uint32_t i = 0; i < faceSize; i++) {
+                    glm::vec3 current = readVec3(positions, face[i].v);
+                    glm::vec3 next = readVec3(positions, face[(i + 1) % faceSize].v);
+                    faceNormal.x += (current.y - next.y) * (current.z + next.z);
+                    faceNormal.y += (current.z - next.z) * (current.x + next.x);
+                    faceNormal.z += (current.x - next.x) * (current.y + next.y);
+                }
+                float length = glm::length(faceNormal);
+                faceNormal = (length > 0.0f) ? faceNormal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+
+            polygon.clear();
+            for (uint32_t i = 0; i < faceSize; i++) {
+                const Corner& corner = face[i];
+
+                if (corner.vn >= 0) {
+                    auto it = welded.find(corner);
+                    if (it != welded.end()) {
+                        polygon.push_back(it->second);
+                        continue;
+                    }
+                }
+
+                Vertex vertex;
+                vertex.Position = readVec3(positions, corner.v);
+                vertex.Normal = (corner.vn >= 0) ? readVec3(normals, corner.vn) : faceNormal;
+                if (corner.vt >= 0) {
+                    // Flip V to match aiProcess_FlipUVs
+                    vertex.TexCoords = glm::vec2(texCoords[corner.vt * 2], 1.0f - texCoords[corner.vt * 2 + 1]);
+                }
+                else {
+                    vertex.TexCoords = glm::vec2(0.0f, 0.0f);
+                }
+
+                unsigned int index = static_cast<unsigned int>(out.vertices.size());
+                out.vertices.push_back(vertex);
+                polygon.push_back(index);
+
+                if (corner.vn >= 0) {
+                    welded.emplace(corner, index);
+                }
+            }
+
+            for (uint32_t i = 1; i + 1 < faceSize; i++) {
+                out.indices.push_back(polygon[0]);
+                out.indices.push_back(polygon[i]);
+                out.indices.push_back(polygon[i + 1]);
+            }
+        }
+    }
+
+    std::string directoryOf(const std::string& path) {
+        size_t pos = path.find_last_of("/\\");
+        return (pos == std::string::npos) ? std::string(".") : path.substr(0, pos);
+    }
+
+    double millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+const ObjMaterial* ObjScene::findMaterial(const std::string& name) const {
+    for (const auto& material : materials) {
+        if (material.name == name) {
+            return &material;
+        }
+    }
+    return nullptr;
+}
+
+bool ObjLoader::isObjFile(const std::string& path) {
+    if (path.size() < 4) return false;
+    std::string extension = path.substr(path.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return extension == ".obj";
+}
+
+bool ObjLoader::load(const std::string& path, ObjScene& scene, bool verbose) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const char* data = reinterpret_cast<const char*>(file.data());
+    size_t size = file.size();
+
+    // Split into line-aligned chunks, one per worker
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads, size / MIN_CHUNK_BYTES));
+
+    std::vector<Chunk> chunks(chunkCount);
+    const char* cursor = data;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char* chunkEnd = (i + 1 == chunkCount) ? data + size : data + size * (i + 1) / chunkCount;
+        if (chunkEnd < cursor) chunkEnd = cursor;
+        if (chunkEnd < data + size) {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', data + size - chunkEnd));
+            chunkEnd = newline ? newline + 1 : data + size;
+        }
+        chunks[i].begin = cursor;
+        chunks[i].end = chunkEnd;
+        cursor = chunkEnd;
+    }
+
+    parallelFor(chunkCount, [&chunks](size_t i) {
+        parseChunk(chunks[i]);
+    });
+
+    double parseTime = millisecondsSince(start);
+
+    size_t lines = 0;
+    for (const auto& chunk : chunks) {
+        if (!chunk.ok) return false;
+        lines += chunk.lines;
+    }
+
+    // Stitch the chunks together in file order
+    auto mergeStart = std::chrono::high_resolution_clock::now();
+
+    std::vector<float> positions, texCoords, normals;
+    std::vector<size_t> positionBase(chunkCount), texCoordBase(chunkCount), normalBase(chunkCount);
+    std::vector<std::string> materialLibs;
+    for (size_t i = 0; i < chunkCount; i++) {
+        positionBase[i] = positions.size() / 3;
+        texCoordBase[i] = texCoords.size() / 2;
+        normalBase[i] = normals.size() / 3;
+        positions.insert(positions.end(), chunks[i].positions.begin(), chunks[i].positions.end());
+        texCoords.insert(texCoords.end(), chunks[i].texCoords.begin(), chunks[i].texCoords.end());
+        normals.insert(normals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+        materialLibs.insert(materialLibs.end(), chunks[i].materialLibs.begin(), chunks[i].materialLibs.end());
+    }
+
+    int32_t positionCount = static_cast<int32_t>(positions.size() / 3);
+    int32_t texCoordCount = static_cast<int32_t>(texCoords.size() / 2);
+    int32_t normalCount = static_cast<int32_t>(normals.size() / 3);
+
+    std::vector<MeshBuild> builds;
+    std::unordered_map<std::string, size_t> buildLookup;
+    std::string object = "default";
+    std::string material;
+    size_t faceCount = 0;
+
+    for (size_t i = 0; i < chunkCount; i++) {
+        for (const Run& run : chunks[i].runs) {
+            if (run.setsObject) object = run.object;
+            if (run.setsMaterial) material = run.material;
+            if (run.faceSizes.empty()) continue;
+
+            std::string key = object + '\n' + material;
+            auto found = buildLookup.find(key);
+            if (found == buildLookup.end()) {
+                found = buildLookup.emplace(key, builds.size()).first;
+                builds.emplace_back();
+                builds.back().name = object;
+                builds.back().material = material;
+            }
+            MeshBuild& build = builds[found->second];
+
+            for (const Corner& corner : run.corners) {
+                Corner resolved;
+                resolved.v = resolveIndex(corner.v, positionBase[i]);
+                resolved.vt = resolveIndex(corner.vt, texCoordBase[i]);
+                resolved.vn = resolveIndex(corner.vn, normalBase[i]);
+
+                if (resolved.v < 0 || resolved.v >= positionCount ||
+                    resolved.vt >= texCoordCount || resolved.vn >= normalCount ||
+                    (corner.vt != 0 && resolved.vt < 0) || (corner.vn != 0 && resolved.vn < 0)) {
+                    std::cout << "  OBJ face index out of range in " << path << std::endl;
+                    return false;
+                }
+                build.corners.push_back(resolved);
+            }
+            build.faceSizes.insert(build.faceSizes.end(), run.faceSizes.begin(), run.faceSizes.end());
+            faceCount += run.faceSizes.size();
+        }
+    }
+
+    // Weld and triangulate the meshes side by side, at most one thread per core
+    scene.meshes.clear();
+    scene.meshes.resize(builds.size());
+    parallelFor(builds.size(), [&](size_t i) {
+        buildMesh(builds[i], positions, texCoords, normals, scene.meshes[i]);
+    });
+
+    double mergeTime = millisecondsSince(mergeStart);
+
+    scene.materials.clear();
+    for (const auto& lib : materialLibs) {
+        loadMaterials(directoryOf(path) + "/" + lib, scene.materials);
+    }
+
+    if (verbose) {
+        size_t vertexCount = 0;
+        for (const auto& mesh : scene.meshes) {
+            vertexCount += mesh.vertices.size();
+        }
+        std::cout << "OBJ importer: " << lines << " lines on " << chunkCount << " thread(s), "
+            << faceCount << " faces -> " << scene.meshes.size() << " meshes, " << vertexCount << " vertices" << std::endl;
+        std::cout << "  Parse: " << parseTime << " ms, merge/weld: " << mergeTime << " ms" << std::endl;
+    }
+
+    return !scene.meshes.empty();
+}
+
+bool ObjLoader::loadMaterials(const std::string& path, std::vector<ObjMaterial>& materials) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cout << "  Material library not found: " << path << std::endl;
+        return false;
+    }
+
+    const char* p = reinterpret_cast<const char*>(file.data());
+    const char* end = p + file.size();
+
+    // Options such as "-s 1 1 1" may precede the file name; the name is the last token then
+    auto mapName = [](const char* rest, const char* lineEnd) {
+        std::string name = readName(rest, lineEnd);
+        if (!name.empty() && name[0] == '-') {
+            size_t space = name.find_last_of(" \t");
+            name = (space == std::string::npos) ? std::string() : name.substr(space + 1);
+        }
+        return name;
+    };
+
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+
+        const char* line = skipSpaces(p, lineEnd);
+        const char* rest = nullptr;
+
+        if (keyword(line, lineEnd, "newmtl", rest)) {
+            materials.emplace_back();
+            materials.back().name = readName(rest, lineEnd);
+        }
+        else if (!materials.empty()) {
+            ObjMaterial& material = materials.back();
+            float r, g, b;
+            if (keyword(line, lineEnd, "Kd", rest)) {
+                if ((rest = parseFloat(rest, lineEnd, r)) && (rest = parseFloat(rest, lineEnd, g)) && parseFloat(rest, lineEnd, b)) {
+                    material.diffuse = glm::vec3(r, g, b);
+                }
+            }
+            else if (keyword(line, lineEnd, "map_Kd", rest)) {
+                material.diffuseMap = mapName(rest, lineEnd);
+            }
+            else if (keyword(line, lineEnd, "map_Ks", rest)) {
+                material.specularMap = mapName(rest, lineEnd);
+            }
+        }
+
+        p = lineEnd + 1;
+    }
+
+    return true;
+}
+
+void ObjLoader::benchmark(const std::vector<std::string>& paths, int runs) {
+    std::cout << "\n=== OBJ IMPORT BENCHMARK (best of " << runs << ") ===" << std::endl;
+    std::cout << "  Threads available: " << std::max(1u, std::thread::hardware_concurrency()) << std::endl;
+
+    for (const auto& path : paths) {
+        if (!isObjFile(path)) continue;
+
+        double fastBest = 1e30;
+        bool fastOk = true;
+        for (int run = 0; run < runs; run++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            ObjScene scene;
+            fastOk = load(path, scene, false) && fastOk;
+            fastBest = std::min(fastBest, millisecondsSince(start));
+        }
+
+        double assimpBest = 1e30;
+        bool assimpOk = true;
+        for (int run = 0; run < runs; run++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            Assimp::Importer importer;
+            const aiScene* aiscene = importer.ReadFile(path,
+                aiProcess_Triangulate |
+                aiProcess_FlipUVs |
+                aiProcess_GenNormals);
+            assimpOk = (aiscene != nullptr) && assimpOk;
+            assimpBest = std::min(assimpBest, millisecondsSince(start));
+        }
+
+        std::cout << "  " << path << std::endl;
+        if (!fastOk || !assimpOk) {
+            std::cout << "    Could not import (ObjLoader " << (fastOk ? "ok" : "failed")
+                << ", Assimp " << (assimpOk ? "ok" : "failed") << ")" << std::endl;
+            continue;
+        }
+        std::cout << "    ObjLoader: " << fastBest << " ms, Assimp: " << assimpBest << " ms, speedup: "
+            << assimpBest / fastBest << "x" << std::endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "model.h"
+
+// Material read from an .mtl file
+struct ObjMaterial {
+    std::string name;
+    glm::vec3 diffuse = glm::vec3(0.8f);
+    std::string diffuseMap;
+    std::string specularMap;
+};
+
+// One mesh per (object/group, material) pair, already triangulated and
+// with identical position/uv/normal corners welded into one Vertex
+struct ObjMeshData {
+    std::string name;
+    std::string material;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+};
+
+struct ObjScene {
+    std::vector<ObjMeshData> meshes;
+    std::vector<ObjMaterial> materials;
+
+    const ObjMaterial* findMaterial(const std::string& name) const;
+};
+
+// Dedicated Wavefront OBJ/MTL importer used by Model instead of Assimp.
+// The file is memory-mapped, cut into line-aligned chunks and each chunk is
+// parsed on its own thread with a locale-independent number parser. The
+// chunks are then stitched together in file order and each mesh is
+// triangulated/welded on its own thread.
+// Output matches Model's Assimp import flags (Triangulate | FlipUVs | GenNormals).
+class ObjLoader {
+public:
+    // Returns false on any malformed input so the caller can fall back to Assimp
+    static bool load(const std::string& path, ObjScene& scene, bool verbose = true);
+
+    static bool isObjFile(const std::string& path);
+
+    // Times ObjLoader::load against Assimp::Importer::ReadFile on each file
+    // (best of several runs, CPU side only) and prints the comparison
+    static void benchmark(const std::vector<std::string>& paths, int runs = 3);
+
+private:
+    static bool loadMaterials(const std::string& path, std::vector<ObjMaterial>& materials);
+};
\ No newline at end of file
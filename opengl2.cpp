@@ -13,69 +13,30 @@
 #include "room.h"
 #include "light_source.h"
 #include "glass.h"
+#include "glass_batch.h"
 #include "car.h"
 #include "floor.h"
 #include "street.h"
 #include "door.h"
 #include "tree.h"
+#include "tree_impostors.h"
+#include "light_buffer.h"
+#include "light_clusters.h"
+#include "deferred_renderer.h"
+#include "model_cache.h"
+#include "obj_loader.h"
+#include "asset_loader.h"
+#include "texture_loader.h"
+#include "lod_selector.h"
+#include "frustum_culler.h"
+#include "scene.h"
+#include "bounding_box.h"
+#include "model.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 
 
-struct BoundingBox {
-    glm::vec3 min;
-    glm::vec3 max;
-    glm::vec3 center;
-    glm::vec3 size;
-
-    BoundingBox() : min(0.0f), max(0.0f), center(0.0f), size(0.0f) {}
-    BoundingBox(glm::vec3 min, glm::vec3 max) : min(min), max(max) {
-        center = (min + max) * 0.5f;
-        size = max - min;
-    }
-
-    void update(const glm::mat4& transform) {
-        // Transform all 8 corners of the box
-        glm::vec3 corners[8] = {
-            glm::vec3(min.x, min.y, min.z),
-            glm::vec3(max.x, min.y, min.z),
-            glm::vec3(min.x, max.y, min.z),
-            glm::vec3(max.x, max.y, min.z),
-            glm::vec3(min.x, min.y, max.z),
-            glm::vec3(max.x, min.y, max.z),
-            glm::vec3(min.x, max.y, max.z),
-            glm::vec3(max.x, max.y, max.z)
-        };
-
-        // Initialize transformed min/max
-        glm::vec3 transformedMin(FLT_MAX);
-        glm::vec3 transformedMax(-FLT_MAX);
-
-        // Transform each corner and find new bounds
-        for (int i = 0; i < 8; i++) {
-            glm::vec4 transformed = transform * glm::vec4(corners[i], 1.0f);
-            transformedMin = glm::min(transformedMin, glm::vec3(transformed));
-            transformedMax = glm::max(transformedMax, glm::vec3(transformed));
-        }
-
-        min = transformedMin;
-        max = transformedMax;
-        center = (min + max) * 0.5f;
-        size = max - min;
-    }
-
-    bool intersects(const BoundingBox& other) const {
-        return (min.x <= other.max.x && max.x >= other.min.x) &&
-            (min.y <= other.max.y && max.y >= other.min.y) &&
-            (min.z <= other.max.z && max.z >= other.min.z);
-    }
-
-    void draw() const {
-        // For debugging - draw wireframe box
-        // This is optional but useful for debugging collisions
-    }
-};
-
 // Camera and input variables
 glm::vec3 cameraPos = glm::vec3(0.0f, 8.0f, 20.0f);  // Start further back
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
@@ -162,13 +123,24 @@ Street* mainStreet = nullptr;
 float streetRotation = 90.0f;  // ADD THIS: Rotate street by 90 degrees
 bool streetCreated = false;
 std::vector<StreetLight*> streetLights;
+StreetLightMesh* streetLightMesh = nullptr;  // Draws every entry of streetLights
 std::vector<glm::vec3> streetLightPositions;
 std::vector<glm::vec3> streetLightColors;
-std::vector<GlassWindow> sideWindows;
-std::vector<GlassWindow> frontWindows;
+GlassBatch glassBatch;  // Every window pane of the hall
+
+// Car platforms (Porsche, Koenigsegg, Mercedes): the shared cube scaled up.
+// They never move, so they go into the Scene once.
+glm::mat4 platformTransforms[3];
+int platformProxies[3];
 
 
 std::vector<Tree*> trees;
+TreeImpostors treeImpostors;  // Distant trees as billboards once Tree.obj is in and baked
+LightBuffer sceneLights;      // LightBlock of the lighting shader, see updateMultipleLights
+LightClusters lightClusters;  // sceneLights binned per view-space cluster, rebuilt every frame
+bool clusteredLighting = true;  // F10; off evaluates every light for every fragment
+DeferredRenderer deferredRenderer;
+bool deferredShading = false;   // --deferred on the command line
 std::vector<glm::vec3> treePositions;
 // Function prototypes
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -184,6 +156,9 @@ Tree* loadTreeModel(const glm::vec3& position, float scale,
     const glm::vec3& color = glm::vec3(0.0f, 0.5f, 0.0f));
 void updateMultipleLights(Shader& shader, const std::vector<glm::vec3>& positions,
     const std::vector<glm::vec3>& colors, const glm::vec3& viewPos);
+void benchmarkUniformUpdates(Shader& shader, const glm::mat4& projection, const glm::mat4& view,
+    const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& colors, const glm::vec3& viewPos);
+bool uniformBenchmarkRequested = false;  // F9; runs inside the next frame, with the lighting shader bound
 
 float transparencyStep = 0.1f;
 bool showTransparencyInfo = true;
@@ -204,7 +179,10 @@ void checkShaderFiles() {
         "shader.frag",
         "light_cube.frag",
         "glass.vert",
-        "glass_simple.frag"
+        "glass_simple.frag",
+        "gbuffer.frag",
+        "deferred_light.vert",
+        "deferred_light.frag"
     };
 
     bool allFound = true;
@@ -236,9 +214,11 @@ Car* loadCarModel(const std::string& name, const std::vector<std::string>& paths
             std::cout << "File found! Attempting to load..." << std::endl;
 
             try {
+                // The model streams in on a loader thread; the render loop
+                // draws a placeholder until car->IsReady()
                 Car* car = new Car(path, position);
                 car->SetScale(glm::vec3(scale));
-                std::cout << "SUCCESS: " << name << " loaded from: " << path << std::endl;
+                std::cout << "SUCCESS: " << name << " queued from: " << path << std::endl;
                 return car;
             }
             catch (const std::exception& e) {
@@ -402,7 +382,248 @@ void findDriverSeatPosition() {
     }
 }
 
-int main() {
+// Street fly-through for the LOD benchmark (F6): the camera runs down the middle
+// of the street at eye height and the triangles submitted each frame are recorded
+const int STREET_PATH_FRAMES = 600;
+const glm::vec3 STREET_PATH_START = glm::vec3(-45.0f, 1.7f, 45.0f);
+const glm::vec3 STREET_PATH_END = glm::vec3(61.0f, 1.7f, 45.0f);
+
+int streetPathFrame = -1;  // -1 while not running
+glm::vec3 streetPathSavedPos;
+glm::vec3 streetPathSavedFront;
+size_t streetPathTriangles = 0;
+size_t streetPathFullTriangles = 0;
+size_t streetPathPeak = 0;
+size_t streetPathPeakFull = 0;
+size_t streetPathDrawn = 0;
+size_t streetPathCulled = 0;
+
+void startStreetBenchmark() {
+    if (streetPathFrame >= 0 || cameraMode != FREE_CAMERA) {
+        return;
+    }
+    streetPathFrame = 0;
+    streetPathSavedPos = cameraPos;
+    streetPathSavedFront = cameraFront;
+    streetPathTriangles = streetPathFullTriangles = 0;
+    streetPathPeak = streetPathPeakFull = 0;
+    streetPathDrawn = streetPathCulled = 0;
+    std::cout << "\n=== LOD BENCHMARK: " << STREET_PATH_FRAMES << " frames along the street, LOD "
+        << (LodSelector::enabled ? "on" : "off") << " ===" << std::endl;
+}
+
+// Before rendering: puts the camera on the path
+void updateStreetBenchmark() {
+    if (streetPathFrame < 0) {
+        return;
+    }
+    float t = static_cast<float>(streetPathFrame) / (STREET_PATH_FRAMES - 1);
+    cameraPos = STREET_PATH_START + (STREET_PATH_END - STREET_PATH_START) * t;
+    cameraFront = glm::vec3(1.0f, 0.0f, 0.0f);
+}
+
+// After rendering: records the frame's triangle counts
+void recordStreetBenchmarkFrame() {
+    if (streetPathFrame < 0) {
+        return;
+    }
+    size_t submitted = Model::getTrianglesSubmitted();
+    size_t fullDetail = Model::getTrianglesFullDetail();
+    streetPathTriangles += submitted;
+    streetPathFullTriangles += fullDetail;
+    streetPathPeak = std::max(streetPathPeak, submitted);
+    streetPathPeakFull = std::max(streetPathPeakFull, fullDetail);
+    streetPathDrawn += FrustumCuller::getDrawnCount();
+    streetPathCulled += FrustumCuller::getCulledCount();
+
+    if (++streetPathFrame < STREET_PATH_FRAMES) {
+        return;
+    }
+
+    std::cout << "Model triangles per frame: average " << streetPathTriangles / STREET_PATH_FRAMES
+        << " (" << streetPathFullTriangles / STREET_PATH_FRAMES << " at full detail), peak "
+        << streetPathPeak << " (" << streetPathPeakFull << " at full detail)" << std::endl;
+    if (streetPathFullTriangles > 0) {
+        std::cout << "LOD saves " << 100.0 - 100.0 * streetPathTriangles / streetPathFullTriangles
+            << "% of the model triangles" << std::endl;
+    }
+    std::cout << "Objects per frame: " << streetPathDrawn / STREET_PATH_FRAMES << " drawn, "
+        << streetPathCulled / STREET_PATH_FRAMES << " frustum culled" << std::endl;
+
+    streetPathFrame = -1;
+    cameraPos = streetPathSavedPos;
+    cameraFront = streetPathSavedFront;
+}
+
+// Forward vs deferred benchmark (F11): every pose below is rendered with
+// both pipelines, RENDER_BENCHMARK_WARMUP frames to settle and then
+// RENDER_BENCHMARK_FRAMES timed ones. Each timed frame ends in glFinish,
+// so the times are CPU plus GPU up to (not including) the buffer swap.
+struct RenderBenchmarkPose {
+    const char* name;
+    glm::vec3 position;
+    glm::vec3 front;
+};
+const RenderBenchmarkPose RENDER_BENCHMARK_POSES[] = {
+    { "Hall overview", glm::vec3(0.0f, 8.0f, 20.0f), glm::vec3(0.0f, -0.35f, -1.0f) },
+    { "Porsche platform", glm::vec3(-5.0f, 2.0f, 6.0f), glm::vec3(-0.6f, -0.2f, -0.7f) },
+    { "Entrance from street", glm::vec3(0.0f, 1.7f, 40.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+    { "Down the street", glm::vec3(-40.0f, 1.7f, 45.0f), glm::vec3(1.0f, 0.0f, 0.0f) }
+};
+const int RENDER_BENCHMARK_POSE_COUNT = sizeof(RENDER_BENCHMARK_POSES) / sizeof(RENDER_BENCHMARK_POSES[0]);
+const int RENDER_BENCHMARK_WARMUP = 10;
+const int RENDER_BENCHMARK_FRAMES = 60;
+
+int renderBenchmarkFrame = -1;  // -1 while not running
+glm::vec3 renderBenchmarkSavedPos;
+glm::vec3 renderBenchmarkSavedFront;
+bool renderBenchmarkSavedDeferred = false;
+std::chrono::high_resolution_clock::time_point renderBenchmarkFrameStart;
+double renderBenchmarkTimes[RENDER_BENCHMARK_POSE_COUNT][2];  // ms summed over the timed frames; forward, deferred
+
+void startRenderBenchmark() {
+    if (renderBenchmarkFrame >= 0 || streetPathFrame >= 0 || cameraMode != FREE_CAMERA) {
+        return;
+    }
+    renderBenchmarkFrame = 0;
+    renderBenchmarkSavedPos = cameraPos;
+    renderBenchmarkSavedFront = cameraFront;
+    renderBenchmarkSavedDeferred = deferredShading;
+    for (int i = 0; i < RENDER_BENCHMARK_POSE_COUNT; i++) {
+        renderBenchmarkTimes[i][0] = renderBenchmarkTimes[i][1] = 0.0;
+    }
+    std::cout << "\n=== RENDER BENCHMARK: forward vs deferred, " << RENDER_BENCHMARK_POSE_COUNT << " poses, "
+        << RENDER_BENCHMARK_FRAMES << " frames each ===" << std::endl;
+}
+
+// Before rendering: puts the camera on the pose and picks the pipeline
+void updateRenderBenchmark() {
+    if (renderBenchmarkFrame < 0) {
+        return;
+    }
+    int framesPerRun = RENDER_BENCHMARK_WARMUP + RENDER_BENCHMARK_FRAMES;
+    int run = renderBenchmarkFrame / framesPerRun;
+    const RenderBenchmarkPose& pose = RENDER_BENCHMARK_POSES[run / 2];
+    cameraPos = pose.position;
+    cameraFront = glm::normalize(pose.front);
+    deferredShading = (run % 2) == 1;
+    renderBenchmarkFrameStart = std::chrono::high_resolution_clock::now();
+}
+
+// After rendering: waits for the GPU and records the frame time
+void recordRenderBenchmarkFrame() {
+    if (renderBenchmarkFrame < 0) {
+        return;
+    }
+    glFinish();
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - renderBenchmarkFrameStart).count();
+
+    int framesPerRun = RENDER_BENCHMARK_WARMUP + RENDER_BENCHMARK_FRAMES;
+    int run = renderBenchmarkFrame / framesPerRun;
+    if (renderBenchmarkFrame % framesPerRun >= RENDER_BENCHMARK_WARMUP) {
+        renderBenchmarkTimes[run / 2][run % 2] += milliseconds;
+    }
+
+    if (++renderBenchmarkFrame < framesPerRun * RENDER_BENCHMARK_POSE_COUNT * 2) {
+        return;
+    }
+
+    for (int i = 0; i < RENDER_BENCHMARK_POSE_COUNT; i++) {
+        double forward = renderBenchmarkTimes[i][0] / RENDER_BENCHMARK_FRAMES;
+        double deferred = renderBenchmarkTimes[i][1] / RENDER_BENCHMARK_FRAMES;
+        std::cout << RENDER_BENCHMARK_POSES[i].name << ": forward " << forward << " ms, deferred "
+            << deferred << " ms";
+        if (deferred > 0.0) {
+            std::cout << " (" << forward / deferred << "x)";
+        }
+        std::cout << std::endl;
+    }
+
+    renderBenchmarkFrame = -1;
+    cameraPos = renderBenchmarkSavedPos;
+    cameraFront = renderBenchmarkSavedFront;
+    deferredShading = renderBenchmarkSavedDeferred;
+}
+
+// Glass for one of the hall's window openings, slightly in front of the wall
+GlassPane makeGlassPane(const Room::WindowOpening& opening, const GlassWindow& material) {
+    GlassPane pane;
+    pane.center = opening.center + opening.normal * 0.05f;
+    pane.size = glm::vec3(opening.size, 0.02f);
+    pane.normal = opening.normal;
+    pane.tint = material.getTintColor();
+    pane.transparency = material.getTransparency();
+    return pane;
+}
+
+// Door toggle cost (N): CPU time and uploads spent on the entrance doors from
+// the key press until both leaves stop. The leaves only ever change their
+// model matrix, so the room mesh should not be rebuilt at all meanwhile.
+int doorToggleFrames = -1;  // -1 while no toggle is being measured
+double doorToggleMicroseconds = 0.0;
+unsigned int doorToggleStartRebuilds = 0;
+
+void startDoorToggleTiming(const Room& room) {
+    doorToggleFrames = 0;
+    doorToggleMicroseconds = 0.0;
+    doorToggleStartRebuilds = room.getRebuildCount();
+}
+
+void recordDoorToggleFrame(const Room& room, double microseconds) {
+    if (doorToggleFrames < 0) {
+        return;
+    }
+    doorToggleFrames++;
+    doorToggleMicroseconds += microseconds;
+
+    float target = leftDoor->getIsOpen() ? 90.0f : 0.0f;
+    if (leftDoor->getRotation() != target || rightDoor->getRotation() != target) {
+        return;
+    }
+
+    unsigned int rebuilds = room.getRebuildCount() - doorToggleStartRebuilds;
+    size_t matrixBytes = 2 * sizeof(glm::mat4);
+    std::cout << "\n=== DOOR TOGGLE: " << doorToggleFrames << " frames ===" << std::endl;
+    std::cout << "Now: " << doorToggleMicroseconds / doorToggleFrames << " us CPU and "
+        << matrixBytes << " bytes (two model matrices) per frame, "
+        << rebuilds << " room rebuilds" << std::endl;
+    std::cout << "Fully rebuilding the room every frame: " << room.getFullRebuildMicroseconds() << " us CPU and "
+        << room.getFullRebuildBytes() / 1024.0 << " KB uploaded per frame" << std::endl;
+    doorToggleFrames = -1;
+}
+
+// Ray and overlap queries against the Scene BVH from the camera
+void printSceneProbe() {
+    const Bvh& bvh = Scene::getBvh();
+
+    // The hall's box contains the camera whenever it is inside, so it is left out
+    float distance = 0.0f;
+    int hit = bvh.raycast(cameraPos, glm::normalize(cameraFront), 200.0f, &distance, ~(1u << SCENE_ROOM));
+    if (hit != Bvh::NULL_NODE) {
+        std::cout << "Looking at: " << Scene::getTypeName(Scene::getType(hit)) << " at " << distance << " m" << std::endl;
+    }
+    else {
+        std::cout << "Looking at: nothing within 200 m" << std::endl;
+    }
+
+    const float radius = 5.0f;
+    std::vector<int> nearby;
+    bvh.queryOverlap(BoundingBox(cameraPos - glm::vec3(radius), cameraPos + glm::vec3(radius)), nearby);
+    std::cout << nearby.size() << " objects within " << radius << " m:";
+    for (int proxy : nearby) {
+        std::cout << " " << Scene::getTypeName(Scene::getType(proxy));
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--deferred") {
+            deferredShading = true;
+        }
+    }
+
     // Initialize GLFW and create window
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW!" << std::endl;
@@ -447,6 +668,11 @@ int main() {
     Shader glassShader("glass.vert", "glass_simple.frag");
     Shader skyboxShader("skybox.vert", "skybox.frag");
     Shader texturedShader("shader_with_texture.vert", "shader_with_texture.frag");
+    Shader impostorShader("impostor.vert", "impostor.frag");
+    Shader gbufferShader("shader.vert", "gbuffer.frag");
+    Shader deferredLightShader("deferred_light.vert", "deferred_light.frag");
+    std::cout << "Rendering: " << (deferredShading ? "deferred shading" : "forward (start with --deferred for deferred shading)")
+        << std::endl;
 
     // Load Porsche 911 GT2
     std::vector<std::string> porschePaths = {
@@ -589,6 +815,9 @@ int main() {
 
     Skybox skybox;
     skybox.setup();
+
+    treeImpostors.setup();
+    deferredRenderer.setup();
     bool skyboxLoaded = skybox.loadCrossFormatCubemap("textures/skybox/Cubemap_Sky_06-512x512.png");
 
     // If that fails, try a relative path
@@ -609,6 +838,12 @@ int main() {
     room.setCeilingColor(glm::vec3(1.0f, 1.0f, 1.0f));   // WHITE ceiling
     room.setup();
 
+    // One box for the whole hall (it is a single mesh), with a little slack
+    // for the entrance arch and frames
+    glm::vec3 roomExtent(room.getWidth() / 2.0f + 1.0f, room.getHeight() + 0.5f, room.getDepth() / 2.0f + 1.0f);
+    BoundingBox roomBounds(glm::vec3(-roomExtent.x, -0.5f, -roomExtent.z), roomExtent);
+    int roomProxy = Scene::add(roomBounds, SCENE_ROOM, &room);
+
     leftDoor = new Door(glm::vec3(-2.5f, 3.5f, room.getDepth() / 2.0f - 0.01f),
         glm::vec3(4.0f, 7.0f, 0.1f), true);
     rightDoor = new Door(glm::vec3(2.5f, 3.5f, room.getDepth() / 2.0f - 0.01f),
@@ -618,67 +853,28 @@ int main() {
     rightDoor->setup();
     doorsLoaded = true;
 
-    // Create glass window for the exhibition (much larger)
-    glm::vec3 windowPos = room.getWindowPosition();
-    windowPos.z += 0.05f;  // Bring it slightly forward
-    GlassWindow glassWindow(windowPos, glm::vec3(25.0f, 8.0f, 0.02f));  // Large exhibition window
+    // All the glass (the large back window, the side windows and the ones
+    // either side of the entrance) is one batch of panes, laid out from the
+    // hall's window openings. glassWindow is not drawn itself: it holds the
+    // back window's material, which the transparency keys change.
+    GlassWindow glassWindow(room.getWindowPosition(), glm::vec3(25.0f, 8.0f, 0.02f));  // Large exhibition window
     glassWindow.setAsTintedGlass();
-    glassWindow.setup();
-
-        float halfDepth = room.getDepth() / 2.0f;  // Changed from roomDepth to room.getDepth()
-
-        float roomHalfDepth = room.getDepth() / 2.0f;  // Use different name to avoid conflict
-        float roomHalfWidth = room.getWidth() / 2.0f;  // Get half width
-
-        float windowSpacing = 5.0f;
-        float windowHeight = 4.0f;
-        float windowWidth = 3.0f;
-
-        // Clear any existing windows
-        sideWindows.clear();
-        frontWindows.clear();
-
-        // Left side windows
-        for (int i = 0; i < 3; i++) {
-            float windowCenterZ = -roomHalfDepth + 2.5f + i * windowSpacing;
-            glm::vec3 windowPos(-roomHalfWidth + 0.02f, 4.0f, windowCenterZ); // Slightly in front of wall
-            GlassWindow sideWindow(windowPos, glm::vec3(windowWidth, windowHeight, 0.02f));
-            sideWindow.setAsTintedGlass();
-            sideWindow.setup();
-            sideWindows.push_back(sideWindow);
-        }
-
-        // Right side windows
-        for (int i = 0; i < 3; i++) {
-            float windowCenterZ = -roomHalfDepth + 2.5f + i * windowSpacing;
-            glm::vec3 windowPos(roomHalfWidth - 0.02f, 4.0f, windowCenterZ); // Slightly in front of wall
-            GlassWindow sideWindow(windowPos, glm::vec3(windowWidth, windowHeight, 0.02f));
-            sideWindow.setAsTintedGlass();
-            sideWindow.setup();
-            sideWindows.push_back(sideWindow);
-        }
-
+    GlassWindow paneGlass;
+    paneGlass.setAsTintedGlass();
 
-        for (int i = 0; i < 2; i++) {
-            float windowCenterX = -12.0f + i * 8.0f;  // Adjusted spacing
-            glm::vec3 windowPos(windowCenterX, 4.0f, roomHalfDepth + 0.02f); // Slightly in front of wall
-            GlassWindow frontWindow(windowPos, glm::vec3(3.0f, 4.0f, 0.02f));
-            frontWindow.setAsTintedGlass();
-            frontWindow.setup();
-            frontWindows.push_back(frontWindow);
+    glassBatch.setup();
+    int mainGlassPane = -1;
+    for (const auto& opening : room.getWindowOpenings()) {
+        int index = glassBatch.addPane(makeGlassPane(opening, opening.isMainWindow ? glassWindow : paneGlass));
+        if (opening.isMainWindow) {
+            mainGlassPane = index;
         }
-
-        // Windows on right side of entrance
-        for (int i = 0; i < 2; i++) {
-            float windowCenterX = 12.0f - i * 8.0f;  // Mirror of left side
-            glm::vec3 windowPos(windowCenterX, 4.0f, roomHalfDepth + 0.02f); // Slightly in front of wall
-            GlassWindow frontWindow(windowPos, glm::vec3(3.0f, 4.0f, 0.02f));
-            frontWindow.setAsTintedGlass();
-            frontWindow.setup();
-            frontWindows.push_back(frontWindow);
-        }
-
-
+    }
+    // The side walls' panes come last; they are replaced whenever those walls
+    // are rebuilt (window spacing, size, on/off)
+    size_t sideGlassPanes = glassBatch.getPaneCount() - room.getSideWindowOpenings().size();
+    unsigned int glassSideWindowVersion = room.getSideWindowVersion();
+    std::cout << "Glass: " << glassBatch.getPaneCount() << " panes in one batch" << std::endl;
 
     // Create main light - positioned high for exhibition hall
     LightSource lightSource(glm::vec3(0.0f, 12.0f, 0.0f), glm::vec3(1.2f, 1.2f, 1.0f));  // Bright warm light
@@ -715,6 +911,7 @@ int main() {
         streetLightColors.push_back(glm::vec3(1.0f, 1.0f, 0.8f));  // Warm light
         streetLightColors.push_back(glm::vec3(1.0f, 1.0f, 0.8f));  // Warm light
     }
+    streetLightMesh = new StreetLightMesh();
 
     for (int i = -8; i <= 8; i++) {
         float xPos = static_cast<float>(i) * 5.0f + 8.0f;
@@ -759,6 +956,7 @@ int main() {
 
 
     std::cout << "Created " << trees.size() << " trees along the street" << std::endl;
+    ModelCache::printStats();
 
     // Add the main hall light to lighting calculations
     streetLightPositions.push_back(lightSource.getPosition());
@@ -810,12 +1008,35 @@ int main() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
+    const glm::vec3 platformPositions[3] = {
+        glm::vec3(-10.0f, 0.0f, 0.0f),
+        glm::vec3(10.0f, 0.0f, 0.0f),
+        glm::vec3(0.0f, 0.0f, 0.0f)
+    };
+    BoundingBox cubeBounds(glm::vec3(-1.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.1f, 1.0f));
+    for (int i = 0; i < 3; i++) {
+        platformTransforms[i] = glm::translate(glm::mat4(1.0f), platformPositions[i]);
+        platformTransforms[i] = glm::scale(platformTransforms[i], glm::vec3(8.0f, 0.2f, 15.0f));
+        platformProxies[i] = Scene::add(cubeBounds.transformed(platformTransforms[i]), SCENE_PLATFORM, nullptr);
+    }
+
     // Main render loop
+    bool firstFrame = true;
     while (!glfwWindowShouldClose(window)) {
         float currentFrame = static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        if (firstFrame) {
+            firstFrame = false;
+            std::cout << "First frame after " << currentFrame * 1000.0f << " ms, "
+                << AssetLoader::pendingCount() << " models still streaming" << std::endl;
+        }
+
+        // Upload whatever the loader threads finished since last frame
+        AssetLoader::update();
+        TextureLoader::update();
+
         // Update driver seat camera if active
         if (cameraInCar) {
             updateDriverSeatCamera();
@@ -831,8 +1052,6 @@ int main() {
             );
             lightSource.setPosition(newLightPos);
 
-            room.updateDoors(deltaTime);
-
             // Update traffic car position (automatic movement)
                // Update traffic car position (automatic movement) - MOVE THIS OUTSIDE THE LIGHT ANIMATION!
             if (trafficCarLoaded && trafficMoving) {
@@ -882,12 +1101,17 @@ int main() {
         }
 
         processInput(window, room, lightSource, glassWindow);
+        updateStreetBenchmark();
+        updateRenderBenchmark();
 
         glClearColor(0.2f, 0.2f, 0.25f, 1.0f);  // BRIGHTER background
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glm::mat4 projection = glm::perspective(glm::radians(fov), 1000.0f / 800.0f, 0.1f, 200.0f);
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        LodSelector::setCamera(cameraPos, fov, 800.0f);
+        FrustumCuller::setCamera(projection, view);
+        Model::resetTriangleCounters();
 
         glDepthMask(GL_FALSE); // Disable depth writing for skybox
         skybox.draw(skyboxShader.ID, view, projection);
@@ -896,12 +1120,30 @@ int main() {
 
 
         // 1. Draw the street and outdoor environment FIRST (farthest objects)
+        // (impostor baking reuses lightingShader, so it goes before the frame's uniforms)
+        treeImpostors.bake(trees, lightingShader);
         lightingShader.use();
         lightingShader.setMat4("projection", projection);
         lightingShader.setMat4("view", view);
 
         // Update multiple lights (street lights + main light)
         updateMultipleLights(lightingShader, streetLightPositions, streetLightColors, cameraPos);
+        lightClusters.build(sceneLights, view, projection);
+        lightClusters.bind();
+        if (uniformBenchmarkRequested) {
+            uniformBenchmarkRequested = false;
+            benchmarkUniformUpdates(lightingShader, projection, view, streetLightPositions, streetLightColors, cameraPos);
+        }
+
+        // The opaque scene is shaded as it is drawn, or with deferred shading
+        // goes into the G-buffer and is lit in one pass after the doors
+        Shader& sceneShader = deferredShading ? gbufferShader : lightingShader;
+        if (deferredShading) {
+            deferredRenderer.beginGeometryPass();
+            sceneShader.use();
+            sceneShader.setMat4("projection", projection);
+            sceneShader.setMat4("view", view);
+        }
 
         // Draw street
         if (mainStreet) {
@@ -909,113 +1151,126 @@ int main() {
             streetModel = glm::translate(streetModel, glm::vec3(8.0f, 0.0f, 45.0f));  // Use the same position: (8.0f, 0.0f, 45.0f)
             streetModel = glm::rotate(streetModel, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
             streetModel = glm::translate(streetModel, glm::vec3(-8.0f, 0.0f, -45.0f));  // Adjusted to -8.0f instead of 0.0f
-            lightingShader.setMat4("model", streetModel);
-            mainStreet->draw();
+            sceneShader.setMat4("model", streetModel);
+            mainStreet->draw(sceneShader);
         }
 
-        // Draw street lights
-        for (size_t i = 0; i < streetLights.size(); i++) {
-            glm::mat4 lightModel = glm::mat4(1.0f);
-
-            // Street lights are already in correct world position
-            // No rotation needed - they're on the sidewalk, not part of the street mesh
-            glm::vec3 lightPos = streetLights[i]->getPosition();
-            lightModel = glm::translate(lightModel, lightPos);
-
-            lightingShader.setMat4("model", lightModel);
-            streetLights[i]->draw();
-        }
-
-        // Draw trees
-        for (size_t i = 0; i < trees.size(); i++) {
-            trees[i]->draw(lightingShader);
+        // Draw street lights: one instanced draw for all of them. Lights are
+        // already in world position (on the sidewalk, not part of the street
+        // mesh), and the instance buffer is only rebuilt if one moves.
+        if (streetLightMesh) {
+            streetLightMesh->update(streetLights);
+            sceneShader.setBool("instanced", true);
+            streetLightMesh->draw(sceneShader);
+            sceneShader.setBool("instanced", false);
         }
 
-        lightingShader.use();
-        lightingShader.setBool("useColorOverride", false);  // Reset this!
-        lightingShader.setFloat("shininess", 32.0f);  // Reset any other uniforms
+        sceneShader.use();
+        sceneShader.setBool("useColorOverride", false);  // Reset this!
+        sceneShader.setFloat("shininess", 32.0f);  // Reset any other uniforms
 
         // 2. Draw the exhibition hall
-        lightingShader.setMat4("model", glm::mat4(1.0f));
-        room.draw();
+        sceneShader.setMat4("model", glm::mat4(1.0f));
+        if (FrustumCuller::isVisible(roomProxy)) {
+            room.draw(sceneShader);
+        }
 
         // 3. Draw car platforms
-        lightingShader.use();
-        lightingShader.setMat4("projection", projection);
-        lightingShader.setMat4("view", view);
+        sceneShader.use();
+        sceneShader.setMat4("projection", projection);
+        sceneShader.setMat4("view", view);
 
-        // Platform for Porsche (updated position)
-        glm::mat4 platform = glm::mat4(1.0f);
-        platform = glm::translate(platform, glm::vec3(-10.0f, 0.0f, 0.0f));
-        platform = glm::scale(platform, glm::vec3(8.0f, 0.2f, 15.0f));
-        lightingShader.setMat4("model", platform);
         glBindVertexArray(cubeVAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        // Platform for Koenigsegg (updated position)
-        platform = glm::mat4(1.0f);
-        platform = glm::translate(platform, glm::vec3(10.0f, 0.0f, 0.0f));
-        platform = glm::scale(platform, glm::vec3(8.0f, 0.2f, 15.0f));
-        lightingShader.setMat4("model", platform);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        // Platform for Mercedes (center)
-        platform = glm::mat4(1.0f);
-        platform = glm::translate(platform, glm::vec3(0.0f, 0.0f, 0.0f));  // Center position
-        platform = glm::scale(platform, glm::vec3(8.0f, 0.2f, 15.0f));
-        lightingShader.setMat4("model", platform);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        for (int i = 0; i < 3; i++) {
+            if (!FrustumCuller::isVisible(platformProxies[i])) {
+                continue;
+            }
+            sceneShader.setMat4("model", platformTransforms[i]);
+            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        }
 
         // 4. Draw the cars
-        lightingShader.use();
-        lightingShader.setMat4("projection", projection);
-        lightingShader.setMat4("view", view);
+        sceneShader.use();
+        sceneShader.setMat4("projection", projection);
+        sceneShader.setMat4("view", view);
         if (trafficCarLoaded && trafficCar) {
-            trafficCar->Draw(lightingShader);
+            trafficCar->Draw(sceneShader);
         }
 
         if (trafficCar2Loaded && trafficCar2) {
-            trafficCar2->Draw(lightingShader);
+            trafficCar2->Draw(sceneShader);
         }
 
-        if (mercedesLoaded && mercedes) {
-            mercedes->Draw(lightingShader);
+        if (mercedesLoaded && mercedes && mercedes->IsReady()) {
+            mercedes->Draw(sceneShader);
         }
         else {
-            // Placeholder for Mercedes
+            // Placeholder for Mercedes until it has streamed in
+            // (rebind the cube: a car drawn above leaves its own VAO state behind)
+            glBindVertexArray(cubeVAO);
             glm::mat4 placeholder = glm::mat4(1.0f);
             placeholder = glm::translate(placeholder, glm::vec3(0.0f, 0.5f, 0.0f));
             placeholder = glm::scale(placeholder, glm::vec3(1.8f, 1.0f, 3.5f));  // SUV is bigger
-            lightingShader.setMat4("model", placeholder);
+            sceneShader.setMat4("model", placeholder);
             glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
         }
 
         // Draw Porsche (left side)
-        if (porscheLoaded && porsche) {
-            porsche->Draw(lightingShader);
+        if (porscheLoaded && porsche && porsche->IsReady()) {
+            porsche->Draw(sceneShader);
         }
         else {
-            // Placeholder for Porsche
+            // Placeholder for Porsche until it has streamed in
+            glBindVertexArray(cubeVAO);
             glm::mat4 placeholder = glm::mat4(1.0f);
             placeholder = glm::translate(placeholder, glm::vec3(-10.0f, 0.5f, 0.0f));
             placeholder = glm::scale(placeholder, glm::vec3(1.5f, 0.8f, 3.0f));
-            lightingShader.setMat4("model", placeholder);
+            sceneShader.setMat4("model", placeholder);
             glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
         }
 
         // Draw Koenigsegg (right side)
-        if (koenigseggLoaded && koenigsegg) {
-            koenigsegg->Draw(lightingShader);
+        if (koenigseggLoaded && koenigsegg && koenigsegg->IsReady()) {
+            koenigsegg->Draw(sceneShader);
         }
         else {
-            // Placeholder for Koenigsegg
+            // Placeholder for Koenigsegg until it has streamed in
+            glBindVertexArray(cubeVAO);
             glm::mat4 placeholder = glm::mat4(1.0f);
             placeholder = glm::translate(placeholder, glm::vec3(10.0f, 0.5f, 0.0f));
             placeholder = glm::scale(placeholder, glm::vec3(1.5f, 0.8f, 3.0f));
-            lightingShader.setMat4("model", placeholder);
+            sceneShader.setMat4("model", placeholder);
             glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
         }
 
+        // Doors are opaque too, so they go in before the lighting pass and the glass
+        if (doorsLoaded) {
+            sceneShader.use();
+            auto doorStart = std::chrono::high_resolution_clock::now();
+
+            // Update door animations
+            leftDoor->update(deltaTime);
+            rightDoor->update(deltaTime);
+
+            // Draw doors
+            leftDoor->draw(sceneShader);
+            rightDoor->draw(sceneShader);
+
+            recordDoorToggleFrame(room, std::chrono::duration<double, std::micro>(
+                std::chrono::high_resolution_clock::now() - doorStart).count());
+        }
+
+        if (deferredShading) {
+            deferredRenderer.lightingPass(deferredLightShader, view, projection, cameraPos, clusteredLighting);
+        }
+
+        // Draw trees: meshes up close, one instanced impostor draw for the rest.
+        // Always forward: the impostors come with their lighting baked in.
+        lightingShader.use();
+        treeImpostors.draw(trees, lightingShader, impostorShader, cameraPos, view, projection);
+        lightingShader.use();
+        lightingShader.setBool("useColorOverride", false);
+
         // 5. Draw the light source (visual representation)
         lightCubeShader.use();
         lightCubeShader.setMat4("projection", projection);
@@ -1034,93 +1289,51 @@ int main() {
             glassShader.setMat4("projection", projection);
             glassShader.setMat4("view", view);
 
-            // Draw main back window
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glassWindow.getPosition());
-            glassShader.setMat4("model", model);
-            glassWindow.updateShader(glassShader.ID, lightSource.getPosition(),
-                cameraPos, lightSource.getColor(), 0.3f);
-
             glDepthMask(GL_FALSE);
-            glassWindow.draw(glassShader.ID);
-
-
-            // Draw front windows (on left and right sides of entrance)
-            float roomHalfDepth = room.getDepth() / 2.0f;
-            float roomHalfWidth = room.getWidth() / 2.0f;
 
-            // Left side front window
-            for (int i = 0; i < 2; i++) {
-                float windowCenterX = -12.0f + i * 8.0f;
-                glm::vec3 windowPos(windowCenterX, 4.0f, roomHalfDepth + 0.02f);
-
-                // Create glass window for this position
-                GlassWindow frontWindow(windowPos, glm::vec3(3.0f, 4.0f, 0.02f));
-                frontWindow.setAsTintedGlass();
-                frontWindow.setup();
-
-                // Set up transformation
-                glm::mat4 frontModel = glm::mat4(1.0f);
-                frontModel = glm::translate(frontModel, windowPos);
-                glassShader.setMat4("model", frontModel);
-
-                // Update shader with lighting
-                frontWindow.updateShader(glassShader.ID, lightSource.getPosition(),
-                    cameraPos, lightSource.getColor(), 0.3f);
-
-                // Draw the window
-                frontWindow.draw(glassShader.ID);
+            // Every pane in one draw; the back window follows the transparency keys
+            if (mainGlassPane >= 0) {
+                glassBatch.getPane(mainGlassPane).transparency = glassWindow.getTransparency();
+                glassBatch.getPane(mainGlassPane).tint = glassWindow.getTintColor();
             }
-
-            // Right side front window
-            for (int i = 0; i < 2; i++) {
-                float windowCenterX = 12.0f - i * 8.0f;
-                glm::vec3 windowPos(windowCenterX, 4.0f, roomHalfDepth + 0.02f);
-
-                // Create glass window for this position
-                GlassWindow frontWindow(windowPos, glm::vec3(3.0f, 4.0f, 0.02f));
-                frontWindow.setAsTintedGlass();
-                frontWindow.setup();
-
-                // Set up transformation
-                glm::mat4 frontModel = glm::mat4(1.0f);
-                frontModel = glm::translate(frontModel, windowPos);
-                glassShader.setMat4("model", frontModel);
-
-                // Update shader with lighting
-                frontWindow.updateShader(glassShader.ID, lightSource.getPosition(),
-                    cameraPos, lightSource.getColor(), 0.3f);
-
-                // Draw the window
-                frontWindow.draw(glassShader.ID);
+            if (room.getSideWindowVersion() != glassSideWindowVersion) {
+                glassBatch.removePanes(sideGlassPanes);
+                for (const auto& opening : room.getSideWindowOpenings()) {
+                    glassBatch.addPane(makeGlassPane(opening, paneGlass));
+                }
+                glassSideWindowVersion = room.getSideWindowVersion();
+                std::cout << "Glass: side windows re-glazed, " << glassBatch.getPaneCount() << " panes" << std::endl;
             }
+            glassWindow.updateShader(glassShader.ID, lightSource.getPosition(),
+                cameraPos, lightSource.getColor(), 0.3f);
+            glassBatch.update();
+            glassShader.setBool("instanced", true);
+            glassBatch.draw();
+            glassShader.setBool("instanced", false);
 
             glDepthMask(GL_TRUE);
         }
 
-        if (doorsLoaded) {
-            lightingShader.use();
-            lightingShader.setMat4("projection", projection);
-            lightingShader.setMat4("view", view);
-
-            // Update door animations
-            leftDoor->update(deltaTime);
-            rightDoor->update(deltaTime);
-
-            // Draw doors
-            leftDoor->draw(lightingShader);
-            rightDoor->draw(lightingShader);
-        }
+        recordStreetBenchmarkFrame();
+        recordRenderBenchmarkFrame();
 
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    // Stop the loader threads before anything they might still touch goes away
+    AssetLoader::shutdown();
+    TextureLoader::shutdown();
+
     // Cleanup
     skybox.cleanup();
+    treeImpostors.cleanup();
+    sceneLights.cleanup();
+    lightClusters.cleanup();
+    deferredRenderer.cleanup();
     room.cleanup();
     lightSource.cleanup();
-    glassWindow.cleanup();
+    glassBatch.cleanup();
     if (mercedes) delete mercedes;
     // Cleanup
     if (leftDoor) delete leftDoor;
@@ -1139,6 +1352,8 @@ int main() {
         delete streetLights[i];
     }
     streetLights.clear();
+    delete streetLightMesh;
+    streetLightMesh = nullptr;
 
     if (porsche) delete porsche;
     if (koenigsegg) delete koenigsegg;
@@ -1197,14 +1412,25 @@ void processInput(GLFWwindow* window, Room& room, LightSource& light, GlassWindo
         mPressed = false;
     }
 
-    static bool dPressed = false;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS && !dPressed) {
-        dPressed = true;
+    static bool nPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS && !nPressed) {
+        nPressed = true;
         room.toggleDoors();
+        if (doorsLoaded) {
+            if (room.areDoorsOpen()) {
+                leftDoor->open();
+                rightDoor->open();
+            }
+            else {
+                leftDoor->close();
+                rightDoor->close();
+            }
+            startDoorToggleTiming(room);
+        }
         std::cout << "Toggled doors" << std::endl;
     }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_RELEASE) {
-        dPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_N) == GLFW_RELEASE) {
+        nPressed = false;
     }
 
     // Helper to find driver seat position (F key)
@@ -1246,6 +1472,131 @@ void processInput(GLFWwindow* window, Room& room, LightSource& light, GlassWindo
         f4Pressed = false;
     }
 
+    // OBJ import benchmark (F5): ObjLoader vs Assimp on the shipped models
+    static bool f5Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS && !f5Pressed) {
+        f5Pressed = true;
+        std::vector<std::string> benchmarkPaths;
+        for (const char* path : { "models/Porsche_911_GT2/Porsche_911_GT2.obj",
+                                  "models/uploads_files_2792345_Koenigsegg.obj",
+                                  "models/Tree.obj" }) {
+            if (fileExists(path)) benchmarkPaths.push_back(path);
+        }
+        ObjLoader::benchmark(benchmarkPaths);
+    }
+    if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_RELEASE) {
+        f5Pressed = false;
+    }
+
+    // LOD benchmark (F6): triangles per frame along the street; L toggles LOD
+    static bool f6Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F6) == GLFW_PRESS && !f6Pressed) {
+        f6Pressed = true;
+        startStreetBenchmark();
+    }
+    if (glfwGetKey(window, GLFW_KEY_F6) == GLFW_RELEASE) {
+        f6Pressed = false;
+    }
+
+    // Frustum culling: F7 toggles it and reports the last frame
+    static bool f7Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F7) == GLFW_PRESS && !f7Pressed) {
+        f7Pressed = true;
+        const Bvh& bvh = Scene::getBvh();
+        std::cout << "Last frame: " << FrustumCuller::getDrawnCount() << " objects drawn, "
+            << FrustumCuller::getCulledCount() << " culled" << std::endl;
+        std::cout << "Scene BVH: " << bvh.getLeafCount() << " objects, height " << bvh.getHeight()
+            << ", SAH cost " << bvh.getSahCost() << ", " << bvh.getRefitCount() << " refits / "
+            << bvh.getReinsertCount() << " re-inserts so far" << std::endl;
+        FrustumCuller::enabled = !FrustumCuller::enabled;
+        std::cout << "Frustum culling " << (FrustumCuller::enabled ? "ENABLED" : "DISABLED") << std::endl;
+    }
+    if (glfwGetKey(window, GLFW_KEY_F7) == GLFW_RELEASE) {
+        f7Pressed = false;
+    }
+
+    // Clustered lighting: F10 reports the last frame's clusters and toggles it
+    static bool f10Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F10) == GLFW_PRESS && !f10Pressed) {
+        f10Pressed = true;
+        std::cout << "Light clusters: " << lightClusters.getLightCount() << " of " << sceneLights.getCount()
+            << " lights in view, " << lightClusters.getActiveClusterCount() << " of " << LightClusters::CLUSTER_COUNT
+            << " clusters lit, " << lightClusters.getIndexCount() << " light references, at most "
+            << lightClusters.getMaxClusterLights() << " per cluster, built in "
+            << lightClusters.getBuildMicroseconds() << " us" << std::endl;
+        clusteredLighting = !clusteredLighting;
+        std::cout << "Clustered lighting " << (clusteredLighting ? "ENABLED" : "DISABLED (all lights per fragment)")
+            << std::endl;
+    }
+    if (glfwGetKey(window, GLFW_KEY_F10) == GLFW_RELEASE) {
+        f10Pressed = false;
+    }
+
+    // Forward vs deferred frame time (F11)
+    static bool f11Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F11) == GLFW_PRESS && !f11Pressed) {
+        f11Pressed = true;
+        startRenderBenchmark();
+    }
+    if (glfwGetKey(window, GLFW_KEY_F11) == GLFW_RELEASE) {
+        f11Pressed = false;
+    }
+
+    // Uniform update benchmark (F9)
+    static bool f9Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS && !f9Pressed) {
+        f9Pressed = true;
+        uniformBenchmarkRequested = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_RELEASE) {
+        f9Pressed = false;
+    }
+
+    // Scene probe (F8): what the camera looks at and what is around it
+    static bool f8Pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS && !f8Pressed) {
+        f8Pressed = true;
+        printSceneProbe();
+    }
+    if (glfwGetKey(window, GLFW_KEY_F8) == GLFW_RELEASE) {
+        f8Pressed = false;
+    }
+
+    // Tree impostors: V toggles them, [ and ] move the switch distance
+    static bool vPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS && !vPressed) {
+        vPressed = true;
+        treeImpostors.setEnabled(!treeImpostors.isEnabled());
+        std::cout << "Tree impostors " << (treeImpostors.isEnabled() ? "ENABLED" : "DISABLED") << std::endl;
+    }
+    if (glfwGetKey(window, GLFW_KEY_V) == GLFW_RELEASE) {
+        vPressed = false;
+    }
+
+    static bool bracketPressed = false;
+    bool lowerDistance = glfwGetKey(window, GLFW_KEY_LEFT_BRACKET) == GLFW_PRESS;
+    bool raiseDistance = glfwGetKey(window, GLFW_KEY_RIGHT_BRACKET) == GLFW_PRESS;
+    if ((lowerDistance || raiseDistance) && !bracketPressed) {
+        bracketPressed = true;
+        treeImpostors.setDistance(treeImpostors.getDistance() + (raiseDistance ? 5.0f : -5.0f));
+        std::cout << "Tree impostor distance: " << treeImpostors.getDistance() << " m ("
+            << treeImpostors.getMeshCount() << " trees as meshes, "
+            << treeImpostors.getImpostorCount() << " as impostors)" << std::endl;
+    }
+    if (!lowerDistance && !raiseDistance) {
+        bracketPressed = false;
+    }
+
+    static bool lPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS && !lPressed) {
+        lPressed = true;
+        LodSelector::enabled = !LodSelector::enabled;
+        std::cout << "Model LOD " << (LodSelector::enabled ? "ENABLED" : "DISABLED") << std::endl;
+    }
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_RELEASE) {
+        lPressed = false;
+    }
+
     // Exit driver seat with E key
     static bool ePressed = false;
     if (cameraInCar && glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS && !ePressed) {
@@ -1762,6 +2113,18 @@ void printTransparencyControls() {
     std::cout << "  [WASD]  : Move camera (free mode only)\n";
     std::cout << "  [QE]    : Move up/down (free mode only)\n";
     std::cout << "  [ESC]   : Exit program (in free mode)\n";
+    std::cout << "\n      DIAGNOSTICS\n";
+    std::cout << "  [F5]    : Benchmark OBJ import (ObjLoader vs Assimp)\n";
+    std::cout << "  [F6]    : Benchmark model triangles along the street\n";
+    std::cout << "  [L]     : Toggle model LOD\n";
+    std::cout << "  [F7]    : Toggle frustum culling (prints drawn/culled)\n";
+    std::cout << "  [F8]    : Scene probe (object ahead, objects nearby)\n";
+    std::cout << "  [F9]    : Benchmark per-frame uniform updates (by name vs cached)\n";
+    std::cout << "  [F10]   : Toggle clustered lighting (prints cluster stats)\n";
+    std::cout << "  [F11]   : Benchmark frame time, forward vs deferred shading\n";
+    std::cout << "  [N]     : Open/close the entrance doors (prints the animation cost)\n";
+    std::cout << "  [V]     : Toggle tree impostors\n";
+    std::cout << "  [ / ]   : Tree impostor distance -/+ 5 m\n";
     std::cout << "=============================================\n\n";
 }
 
@@ -1807,29 +2170,76 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
 
 
 
+// Copies the lights into sceneLights and uploads whatever changed since the
+// last frame: after the first frame only lights that moved (the animated
+// one) are written, each as its own sizeof(GpuLight) sub-range
 void updateMultipleLights(Shader& shader, const std::vector<glm::vec3>& positions,
     const std::vector<glm::vec3>& colors, const glm::vec3& viewPos) {
-    shader.use();
-
-    // Pass view position
-    shader.setVec3("viewPos", viewPos);
-
-    // Pass number of lights
-    int numLights = std::min((int)positions.size(), 10);  // Limit to 10 lights
-    shader.setInt("numLights", numLights);
+    static unsigned int resolvedProgram = 0;
+    static Shader::Uniform viewPosUniform;
+    static Shader::Uniform clusteredUniform;
+    if (resolvedProgram != shader.ID) {
+        resolvedProgram = shader.ID;
+        viewPosUniform = shader.uniform("viewPos");
+        clusteredUniform = shader.uniform("clusteredLighting");
+    }
 
-    // Pass each light's properties
+    int numLights = std::min((int)positions.size(), LightBuffer::MAX_LIGHTS);
+    sceneLights.setCount(numLights);
     for (int i = 0; i < numLights; i++) {
-        std::string lightStr = "lights[" + std::to_string(i) + "]";
-        shader.setVec3(lightStr + ".position", positions[i]);
-        shader.setVec3(lightStr + ".color", colors[i]);
-        shader.setFloat(lightStr + ".ambient", 0.3f);
-        shader.setFloat(lightStr + ".diffuse", 0.8f);
-        shader.setFloat(lightStr + ".specular", 0.5f);
-        shader.setFloat(lightStr + ".constant", 1.0f);
-        shader.setFloat(lightStr + ".linear", 0.09f);
-        shader.setFloat(lightStr + ".quadratic", 0.032f);
+        sceneLights.setLight(i, LightBuffer::pointLight(positions[i], colors[i]));
     }
+    sceneLights.upload();
+    sceneLights.bind();
+
+    shader.use();
+    shader.setVec3(viewPosUniform, viewPos);
+    shader.setBool(clusteredUniform, clusteredLighting);
+}
+
+// Uniform benchmark (F9): CPU time of one frame's lighting-shader uniform
+// updates, the old way (a std::string and a glGetUniformLocation per call)
+// against cached handles. The lights are no longer uniforms, so only the
+// uniforms the shader still has are set by name; the cached side also
+// includes the light buffer update. Leaves the shader with this frame's values.
+void benchmarkUniformUpdates(Shader& shader, const glm::mat4& projection, const glm::mat4& view,
+    const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& colors, const glm::vec3& viewPos) {
+    const int runs = 2000;
+    const int uniformsPerFrame = 5;     // projection, view, model, viewPos, clusteredLighting
+    glm::mat4 model(1.0f);
+    shader.use();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int run = 0; run < runs; run++) {
+        GLuint program = shader.ID;
+        glUniformMatrix4fv(glGetUniformLocation(program, std::string("projection").c_str()), 1, GL_FALSE, &projection[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(program, std::string("view").c_str()), 1, GL_FALSE, &view[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(program, std::string("model").c_str()), 1, GL_FALSE, &model[0][0]);
+        glUniform3fv(glGetUniformLocation(program, std::string("viewPos").c_str()), 1, &viewPos[0]);
+        glUniform1i(glGetUniformLocation(program, std::string("clusteredLighting").c_str()), clusteredLighting);
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+
+    Shader::Uniform projectionUniform = shader.uniform("projection");
+    Shader::Uniform viewUniform = shader.uniform("view");
+    Shader::Uniform modelUniform = shader.uniform("model");
+    for (int run = 0; run < runs; run++) {
+        shader.setMat4(projectionUniform, projection);
+        shader.setMat4(viewUniform, view);
+        shader.setMat4(modelUniform, model);
+        updateMultipleLights(shader, positions, colors, viewPos);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double before = std::chrono::duration<double, std::micro>(middle - start).count() / runs;
+    double after = std::chrono::duration<double, std::micro>(end - middle).count() / runs;
+    std::cout << "\n=== UNIFORM BENCHMARK: " << uniformsPerFrame << " uniforms per frame, "
+        << runs << " runs ===" << std::endl;
+    std::cout << "By name (string + glGetUniformLocation), no lights: " << before << " us/frame" << std::endl;
+    std::cout << "Cached handles, plus " << std::min((int)positions.size(), LightBuffer::MAX_LIGHTS)
+        << " lights into the light buffer: " << after << " us/frame" << std::endl;
+    std::cout << "Light buffer: " << sceneLights.getUploadCount() << " uploads, "
+        << sceneLights.getUploadedBytes() << " bytes since start" << std::endl;
 }
 
 
@@ -0,0 +1,32 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Runs body(0) .. body(count - 1) on at most one thread per core, the calling
+// thread included, and returns once every item is done. Items are handed out
+// one at a time, so a file with hundreds of meshes still starts only a core's
+// worth of threads.
+inline void parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t threadCount = std::min<size_t>(cores, count);
+
+    std::atomic<size_t> next(0);
+    auto work = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            body(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
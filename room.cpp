@@ -1,16 +1,22 @@
 #include "room.h"
 #include <iostream>
 #include <cmath>
+#include <chrono>
+#include <string>
+
+namespace {
+    const char* SECTION_NAMES[] = { "floor/ceiling", "side walls", "back wall", "front wall", "columns", "platforms" };
+}
 
 // Constructor - LARGE exhibition hall
 Room::Room(float width, float height, float depth)
     : roomWidth(width), roomHeight(height), roomDepth(depth),
-    needsUpdate(true) {
+    mesh(SECTION_COUNT), building(SECTION_SHELL), dirtySections((1u << SECTION_COUNT) - 1) {
 
-    wallColor = glm::vec3(1.0f, 1.0f, 1.0f);     // PURE WHITE walls
-    floorColor = glm::vec3(0.95f, 0.95f, 0.95f); // Very light gray floor
-    ceilingColor = glm::vec3(1.0f, 1.0f, 1.0f);  // WHITE ceiling
-    accentColor = glm::vec3(0.7f, 0.7f, 0.7f);   // Gray for details
+    materials.setColor(ROOM_WALL, glm::vec3(1.0f, 1.0f, 1.0f));       // PURE WHITE walls
+    materials.setColor(ROOM_FLOOR, glm::vec3(0.95f, 0.95f, 0.95f));   // Very light gray floor
+    materials.setColor(ROOM_CEILING, glm::vec3(1.0f, 1.0f, 1.0f));    // WHITE ceiling
+    materials.setColor(ROOM_ACCENT, glm::vec3(0.7f, 0.7f, 0.7f));     // Gray for details
 
     // Create large main window by default
     addMainWindow(glm::vec3(0.0f, 4.0f, -14.9f), glm::vec3(25.0f, 8.0f, 0.0f));
@@ -18,8 +24,6 @@ Room::Room(float width, float height, float depth)
     // Enable side and front windows
     hasSideWindows = true;
     hasFrontWindows = true;
-
-    VAO = VBO = EBO = 0;
 }
 
 // Add main exhibition window
@@ -28,34 +32,21 @@ void Room::addMainWindow(const glm::vec3& position, const glm::vec3& size) {
     windowPos = position;
     windowSize = size;
     windowWallNormal = glm::vec3(0.0f, 0.0f, 1.0f); // Facing forward
-    needsUpdate = true;
+    markDirty(SECTION_BACK_WALL);
 }
 
 // Helper function to add a quad
 void Room::addQuad(const glm::vec3& p1, const glm::vec3& p2,
     const glm::vec3& p3, const glm::vec3& p4,
-    const glm::vec3& color, const glm::vec3& normal) {
-    int baseIndex = vertices.size() / 9;
-
-    // Vertex 1
-    vertices.push_back(p1.x); vertices.push_back(p1.y); vertices.push_back(p1.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
-
-    // Vertex 2
-    vertices.push_back(p2.x); vertices.push_back(p2.y); vertices.push_back(p2.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
+    int material, const glm::vec3& normal) {
+    std::vector<MaterialVertex>& vertices = mesh.getVertices(building);
+    std::vector<unsigned int>& indices = mesh.getIndices(building);
+    unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 
-    // Vertex 3
-    vertices.push_back(p3.x); vertices.push_back(p3.y); vertices.push_back(p3.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
-
-    // Vertex 4
-    vertices.push_back(p4.x); vertices.push_back(p4.y); vertices.push_back(p4.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
+    vertices.emplace_back(p1, normal, material);
+    vertices.emplace_back(p2, normal, material);
+    vertices.emplace_back(p3, normal, material);
+    vertices.emplace_back(p4, normal, material);
 
     // Add indices for two triangles
     indices.push_back(baseIndex);
@@ -68,23 +59,14 @@ void Room::addQuad(const glm::vec3& p1, const glm::vec3& p2,
 
 // Helper function to add a triangle
 void Room::addTriangle(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
-    const glm::vec3& color, const glm::vec3& normal) {
-    int baseIndex = vertices.size() / 9;
-
-    // Vertex 1
-    vertices.push_back(p1.x); vertices.push_back(p1.y); vertices.push_back(p1.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
+    int material, const glm::vec3& normal) {
+    std::vector<MaterialVertex>& vertices = mesh.getVertices(building);
+    std::vector<unsigned int>& indices = mesh.getIndices(building);
+    unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 
-    // Vertex 2
-    vertices.push_back(p2.x); vertices.push_back(p2.y); vertices.push_back(p2.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
-
-    // Vertex 3
-    vertices.push_back(p3.x); vertices.push_back(p3.y); vertices.push_back(p3.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
+    vertices.emplace_back(p1, normal, material);
+    vertices.emplace_back(p2, normal, material);
+    vertices.emplace_back(p3, normal, material);
 
     // Add indices for triangle
     indices.push_back(baseIndex);
@@ -92,285 +74,122 @@ void Room::addTriangle(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3
     indices.push_back(baseIndex + 2);
 }
 
+void Room::addWall(const glm::vec3& origin, const glm::vec3& uAxis, const glm::vec3& vAxis,
+    const WallTessellator::Rect& wall, const std::vector<WallTessellator::Rect>& openings,
+    int material, const glm::vec3& normal) {
+    std::vector<WallTessellator::Rect> panels = WallTessellator::tessellate(wall, openings, &sectionWallStats[building]);
+    for (const auto& panel : panels) {
+        addQuad(
+            origin + panel.minX * uAxis + panel.minY * vAxis,
+            origin + panel.maxX * uAxis + panel.minY * vAxis,
+            origin + panel.maxX * uAxis + panel.maxY * vAxis,
+            origin + panel.minX * uAxis + panel.maxY * vAxis,
+            material,
+            normal
+        );
+    }
+}
+
 // Create main wall with large exhibition window
 void Room::createMainWallWithLargeWindow() {
     float halfWidth = roomWidth / 2.0f;
-    float windowHalfWidth = windowSize.x / 2.0f;
-    float windowHalfHeight = windowSize.y / 2.0f;
-    float windowBottom = windowPos.y - windowHalfHeight;
-    float windowTop = windowPos.y + windowHalfHeight;
-    float windowLeft = windowPos.x - windowHalfWidth;
-    float windowRight = windowPos.x + windowHalfWidth;
 
     // Back wall (z = -roomDepth/2) with large window
     float wallZ = -roomDepth / 2.0f;
 
-    // FIXED: Use wallColor (which should be white) instead of hardcoded colors
-    // 1. Top section (above window)
-    addQuad(
-        glm::vec3(-halfWidth, roomHeight, wallZ),
-        glm::vec3(halfWidth, roomHeight, wallZ),
-        glm::vec3(halfWidth, windowTop, wallZ),
-        glm::vec3(-halfWidth, windowTop, wallZ),
-        wallColor,  // Use wallColor instead of hardcoded color
-        glm::vec3(0.0f, 0.0f, 1.0f)
-    );
-
-    // 2. Bottom section (below window)
-    addQuad(
-        glm::vec3(-halfWidth, windowBottom, wallZ),
-        glm::vec3(halfWidth, windowBottom, wallZ),
-        glm::vec3(halfWidth, 0.0f, wallZ),
-        glm::vec3(-halfWidth, 0.0f, wallZ),
-        wallColor,  // Use wallColor instead of hardcoded color
-        glm::vec3(0.0f, 0.0f, 1.0f)
-    );
-
-    // 3. Left section (left of window)
-    addQuad(
-        glm::vec3(-halfWidth, windowTop, wallZ),
-        glm::vec3(windowLeft, windowTop, wallZ),
-        glm::vec3(windowLeft, windowBottom, wallZ),
-        glm::vec3(-halfWidth, windowBottom, wallZ),
-        wallColor,  // Use wallColor instead of hardcoded color
-        glm::vec3(0.0f, 0.0f, 1.0f)
-    );
-
-    // 4. Right section (right of window)
-    addQuad(
-        glm::vec3(windowRight, windowTop, wallZ),
-        glm::vec3(halfWidth, windowTop, wallZ),
-        glm::vec3(halfWidth, windowBottom, wallZ),
-        glm::vec3(windowRight, windowBottom, wallZ),
-        wallColor,  // Use wallColor instead of hardcoded color
-        glm::vec3(0.0f, 0.0f, 1.0f)
-    );
+    WallTessellator::Rect window = {
+        windowPos.x - windowSize.x / 2.0f, windowPos.y - windowSize.y / 2.0f,
+        windowPos.x + windowSize.x / 2.0f, windowPos.y + windowSize.y / 2.0f
+    };
+    addWall(glm::vec3(0.0f, 0.0f, wallZ), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+        { -halfWidth, 0.0f, halfWidth, roomHeight }, { window },
+        ROOM_WALL, glm::vec3(0.0f, 0.0f, 1.0f));
 }
 
-// Helper function to create a wall with multiple windows
-void Room::createWallWithWindows(float wallZ, const glm::vec3& normal, bool isFrontWall) {
-    float halfWidth = roomWidth / 2.0f;
+std::vector<WallTessellator::Rect> Room::getSideWindowRects() const {
+    float halfDepth = roomDepth / 2.0f;
 
-    // Calculate how many windows fit on the wall
-    int numWindows = static_cast<int>((roomWidth - windowSpacing) / windowSpacing);
+    // Calculate how many windows fit on the side wall
+    int numWindows = static_cast<int>((roomDepth - windowSpacing) / windowSpacing);
     if (numWindows < 1) numWindows = 1;
 
-    // Calculate starting position for windows
-    float startX = -halfWidth + windowSpacing / 2.0f;
+    float startZ = -halfDepth + windowSpacing / 2.0f;
 
+    std::vector<WallTessellator::Rect> windows;
     for (int i = 0; i < numWindows; i++) {
-        float windowCenterX = startX + i * windowSpacing;
-
-        // Skip center area for front wall (where entrance is)
-        if (isFrontWall && fabs(windowCenterX) < 6.0f) {
-            continue;
-        }
-
-        // Window dimensions
-        float windowBottom = 2.0f;  // Window starts 2m above floor
-        float windowTop = windowBottom + windowHeight;
-        float windowLeft = windowCenterX - windowWidth / 2.0f;
-        float windowRight = windowCenterX + windowWidth / 2.0f;
-
-        // Create wall with window cutout
-        // Top section above window
-        addQuad(
-            glm::vec3(-halfWidth, roomHeight, wallZ),
-            glm::vec3(halfWidth, roomHeight, wallZ),
-            glm::vec3(halfWidth, windowTop, wallZ),
-            glm::vec3(-halfWidth, windowTop, wallZ),
-            wallColor,
-            normal
-        );
-
-        // Bottom section below window
-        addQuad(
-            glm::vec3(-halfWidth, windowBottom, wallZ),
-            glm::vec3(halfWidth, windowBottom, wallZ),
-            glm::vec3(halfWidth, 0.0f, wallZ),
-            glm::vec3(-halfWidth, 0.0f, wallZ),
-            wallColor,
-            normal
-        );
-
-        // Left section (left of window)
-        addQuad(
-            glm::vec3(-halfWidth, windowTop, wallZ),
-            glm::vec3(windowLeft, windowTop, wallZ),
-            glm::vec3(windowLeft, windowBottom, wallZ),
-            glm::vec3(-halfWidth, windowBottom, wallZ),
-            wallColor,
-            normal
-        );
+        float windowCenterZ = startZ + i * windowSpacing;
+        windows.push_back({ windowCenterZ - windowWidth / 2.0f, 2.0f,
+            windowCenterZ + windowWidth / 2.0f, 2.0f + windowHeight });
+    }
+    return windows;
+}
 
-        // Right section (right of window)
-        addQuad(
-            glm::vec3(windowRight, windowTop, wallZ),
-            glm::vec3(halfWidth, windowTop, wallZ),
-            glm::vec3(halfWidth, windowBottom, wallZ),
-            glm::vec3(windowRight, windowBottom, wallZ),
-            wallColor,
-            normal
-        );
+// Two windows either side of the doors
+std::vector<WallTessellator::Rect> Room::getFrontWindowRects() const {
+    const float windowCenters[4] = { -12.0f, -4.0f, 4.0f, 12.0f };
 
-        // Middle sections between windows
-        if (i > 0) {
-            float prevWindowRight = startX + (i - 1) * windowSpacing + windowWidth / 2.0f;
-            addQuad(
-                glm::vec3(prevWindowRight, windowTop, wallZ),
-                glm::vec3(windowLeft, windowTop, wallZ),
-                glm::vec3(windowLeft, windowBottom, wallZ),
-                glm::vec3(prevWindowRight, windowBottom, wallZ),
-                wallColor,
-                normal
-            );
-        }
+    std::vector<WallTessellator::Rect> windows;
+    for (float centerX : windowCenters) {
+        windows.push_back({ centerX - frontWindowWidth / 2.0f, frontWindowY,
+            centerX + frontWindowWidth / 2.0f, frontWindowY + frontWindowHeight });
     }
+    return windows;
 }
 
 // Create side windows (left and right walls)
 void Room::createSideWindows() {
+    float halfWidth = roomWidth / 2.0f;
     float halfDepth = roomDepth / 2.0f;
 
-    // LEFT WALL (x = -halfWidth) - with windows
-    float leftWallX = -roomWidth / 2.0f;
+    // Both walls have the same windows
+    std::vector<WallTessellator::Rect> windows = getSideWindowRects();
+    WallTessellator::Rect wall = { -halfDepth, 0.0f, halfDepth, roomHeight };
 
-    // Calculate how many windows fit on the side wall
-    int numWindows = static_cast<int>((roomDepth - windowSpacing) / windowSpacing);
-    if (numWindows < 1) numWindows = 1;
-
-    float startZ = -halfDepth + windowSpacing / 2.0f;
-
-    for (int i = 0; i < numWindows; i++) {
-        float windowCenterZ = startZ + i * windowSpacing;
-
-        // Window dimensions
-        float windowBottom = 2.0f;
-        float windowTop = windowBottom + windowHeight;
-        float windowBack = windowCenterZ - windowWidth / 2.0f;
-        float windowFront = windowCenterZ + windowWidth / 2.0f;
-
-        // Create left wall with windows
-        // Top section above window
-        addQuad(
-            glm::vec3(leftWallX, roomHeight, -halfDepth),
-            glm::vec3(leftWallX, roomHeight, halfDepth),
-            glm::vec3(leftWallX, windowTop, halfDepth),
-            glm::vec3(leftWallX, windowTop, -halfDepth),
-            wallColor,
-            glm::vec3(1.0f, 0.0f, 0.0f)
-        );
-
-        // Bottom section below window
-        addQuad(
-            glm::vec3(leftWallX, windowBottom, -halfDepth),
-            glm::vec3(leftWallX, windowBottom, halfDepth),
-            glm::vec3(leftWallX, 0.0f, halfDepth),
-            glm::vec3(leftWallX, 0.0f, -halfDepth),
-            wallColor,
-            glm::vec3(1.0f, 0.0f, 0.0f)
-        );
+    // LEFT WALL (x = -halfWidth)
+    addWall(glm::vec3(-halfWidth, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+        wall, windows, ROOM_WALL, glm::vec3(1.0f, 0.0f, 0.0f));
 
-        // Front section (front of window)
-        addQuad(
-            glm::vec3(leftWallX, windowTop, -halfDepth),
-            glm::vec3(leftWallX, windowTop, windowBack),
-            glm::vec3(leftWallX, windowBottom, windowBack),
-            glm::vec3(leftWallX, windowBottom, -halfDepth),
-            wallColor,
-            glm::vec3(1.0f, 0.0f, 0.0f)
-        );
+    // RIGHT WALL (x = halfWidth)
+    addWall(glm::vec3(halfWidth, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+        wall, windows, ROOM_WALL, glm::vec3(-1.0f, 0.0f, 0.0f));
+}
 
-        // Back section (back of window)
-        addQuad(
-            glm::vec3(leftWallX, windowTop, windowFront),
-            glm::vec3(leftWallX, windowTop, halfDepth),
-            glm::vec3(leftWallX, windowBottom, halfDepth),
-            glm::vec3(leftWallX, windowBottom, windowFront),
-            wallColor,
-            glm::vec3(1.0f, 0.0f, 0.0f)
-        );
+std::vector<Room::WindowOpening> Room::getWindowOpenings() const {
+    std::vector<WindowOpening> openings;
+    float halfDepth = roomDepth / 2.0f;
 
-        // Middle sections between windows
-        if (i > 0) {
-            float prevWindowFront = startZ + (i - 1) * windowSpacing + windowWidth / 2.0f;
-            addQuad(
-                glm::vec3(leftWallX, windowTop, prevWindowFront),
-                glm::vec3(leftWallX, windowTop, windowBack),
-                glm::vec3(leftWallX, windowBottom, windowBack),
-                glm::vec3(leftWallX, windowBottom, prevWindowFront),
-                wallColor,
-                glm::vec3(1.0f, 0.0f, 0.0f)
-            );
-        }
+    if (hasMainWindow) {
+        openings.push_back({ windowPos, glm::vec2(windowSize.x, windowSize.y), windowWallNormal, true });
     }
 
-    // RIGHT WALL (x = halfWidth) - with windows (similar to left wall but mirrored)
-    float rightWallX = roomWidth / 2.0f;
-
-    for (int i = 0; i < numWindows; i++) {
-        float windowCenterZ = startZ + i * windowSpacing;
-
-        // Window dimensions
-        float windowBottom = 2.0f;
-        float windowTop = windowBottom + windowHeight;
-        float windowBack = windowCenterZ - windowWidth / 2.0f;
-        float windowFront = windowCenterZ + windowWidth / 2.0f;
-
-        // Create right wall with windows
-        // Top section above window
-        addQuad(
-            glm::vec3(rightWallX, roomHeight, -halfDepth),
-            glm::vec3(rightWallX, roomHeight, halfDepth),
-            glm::vec3(rightWallX, windowTop, halfDepth),
-            glm::vec3(rightWallX, windowTop, -halfDepth),
-            wallColor,
-            glm::vec3(-1.0f, 0.0f, 0.0f)
-        );
+    for (const auto& window : getFrontWindowRects()) {
+        glm::vec2 size(window.maxX - window.minX, window.maxY - window.minY);
+        glm::vec3 center((window.minX + window.maxX) / 2.0f, (window.minY + window.maxY) / 2.0f, halfDepth);
+        openings.push_back({ center, size, glm::vec3(0.0f, 0.0f, -1.0f), false });
+    }
 
-        // Bottom section below window
-        addQuad(
-            glm::vec3(rightWallX, windowBottom, -halfDepth),
-            glm::vec3(rightWallX, windowBottom, halfDepth),
-            glm::vec3(rightWallX, 0.0f, halfDepth),
-            glm::vec3(rightWallX, 0.0f, -halfDepth),
-            wallColor,
-            glm::vec3(-1.0f, 0.0f, 0.0f)
-        );
+    // Last, so glass over the side walls can be replaced on its own
+    std::vector<WindowOpening> side = getSideWindowOpenings();
+    openings.insert(openings.end(), side.begin(), side.end());
 
-        // Front section (front of window)
-        addQuad(
-            glm::vec3(rightWallX, windowTop, -halfDepth),
-            glm::vec3(rightWallX, windowTop, windowBack),
-            glm::vec3(rightWallX, windowBottom, windowBack),
-            glm::vec3(rightWallX, windowBottom, -halfDepth),
-            wallColor,
-            glm::vec3(-1.0f, 0.0f, 0.0f)
-        );
+    return openings;
+}
 
-        // Back section (back of window)
-        addQuad(
-            glm::vec3(rightWallX, windowTop, windowFront),
-            glm::vec3(rightWallX, windowTop, halfDepth),
-            glm::vec3(rightWallX, windowBottom, halfDepth),
-            glm::vec3(rightWallX, windowBottom, windowFront),
-            wallColor,
-            glm::vec3(-1.0f, 0.0f, 0.0f)
-        );
+std::vector<Room::WindowOpening> Room::getSideWindowOpenings() const {
+    std::vector<WindowOpening> openings;
+    if (!hasSideWindows) {
+        return openings;
+    }
 
-        // Middle sections between windows
-        if (i > 0) {
-            float prevWindowFront = startZ + (i - 1) * windowSpacing + windowWidth / 2.0f;
-            addQuad(
-                glm::vec3(rightWallX, windowTop, prevWindowFront),
-                glm::vec3(rightWallX, windowTop, windowBack),
-                glm::vec3(rightWallX, windowBottom, windowBack),
-                glm::vec3(rightWallX, windowBottom, prevWindowFront),
-                wallColor,
-                glm::vec3(-1.0f, 0.0f, 0.0f)
-            );
-        }
+    float halfWidth = roomWidth / 2.0f;
+    for (const auto& window : getSideWindowRects()) {
+        glm::vec2 size(window.maxX - window.minX, window.maxY - window.minY);
+        float centerZ = (window.minX + window.maxX) / 2.0f;
+        float centerY = (window.minY + window.maxY) / 2.0f;
+        openings.push_back({ glm::vec3(-halfWidth, centerY, centerZ), size, glm::vec3(1.0f, 0.0f, 0.0f), false });
+        openings.push_back({ glm::vec3(halfWidth, centerY, centerZ), size, glm::vec3(-1.0f, 0.0f, 0.0f), false });
     }
+    return openings;
 }
 
 // Create front windows (around entrance)
@@ -414,7 +233,7 @@ void Room::createColumns() {
 
             glm::vec3 normal = glm::normalize(glm::vec3(cos(angle1), 0.0f, sin(angle1)));
 
-            addQuad(p1, p2, p3, p4, accentColor, normal);
+            addQuad(p1, p2, p3, p4, ROOM_ACCENT, normal);
         }
 
         // Column top cap
@@ -431,7 +250,7 @@ void Room::createColumns() {
                 center.z + columnRadius * sin(angle2));
 
             glm::vec3 normal(0.0f, 1.0f, 0.0f);
-            addTriangle(centerTop, p1, p2, accentColor, normal);
+            addTriangle(centerTop, p1, p2, ROOM_ACCENT, normal);
         }
     }
 }
@@ -460,7 +279,7 @@ void Room::createDisplayPlatforms() {
             glm::vec3(center.x + halfW, topY, center.z - halfD),
             glm::vec3(center.x + halfW, topY, center.z + halfD),
             glm::vec3(center.x - halfW, topY, center.z + halfD),
-            floorColor,
+            ROOM_FLOOR,
             glm::vec3(0.0f, 1.0f, 0.0f)
         );
 
@@ -471,7 +290,7 @@ void Room::createDisplayPlatforms() {
             glm::vec3(center.x + halfW, bottomY, center.z + halfD),
             glm::vec3(center.x + halfW, topY, center.z + halfD),
             glm::vec3(center.x - halfW, topY, center.z + halfD),
-            accentColor,
+            ROOM_ACCENT,
             glm::vec3(0.0f, 0.0f, -1.0f)
         );
 
@@ -481,7 +300,7 @@ void Room::createDisplayPlatforms() {
             glm::vec3(center.x + halfW, bottomY, center.z - halfD),
             glm::vec3(center.x + halfW, topY, center.z - halfD),
             glm::vec3(center.x - halfW, topY, center.z - halfD),
-            accentColor,
+            ROOM_ACCENT,
             glm::vec3(0.0f, 0.0f, 1.0f)
         );
 
@@ -491,7 +310,7 @@ void Room::createDisplayPlatforms() {
             glm::vec3(center.x - halfW, bottomY, center.z + halfD),
             glm::vec3(center.x - halfW, topY, center.z + halfD),
             glm::vec3(center.x - halfW, topY, center.z - halfD),
-            accentColor,
+            ROOM_ACCENT,
             glm::vec3(1.0f, 0.0f, 0.0f)
         );
 
@@ -501,53 +320,73 @@ void Room::createDisplayPlatforms() {
             glm::vec3(center.x + halfW, bottomY, center.z + halfD),
             glm::vec3(center.x + halfW, topY, center.z + halfD),
             glm::vec3(center.x + halfW, topY, center.z - halfD),
-            accentColor,
+            ROOM_ACCENT,
             glm::vec3(-1.0f, 0.0f, 0.0f)
         );
     }
 }
 
 
-void Room::updateBuffers() {
-    if (VAO == 0) {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+void Room::rebuild() {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string rebuilt;
+    bool full = dirtySections == (1u << SECTION_COUNT) - 1;
+    for (int section = 0; section < SECTION_COUNT; section++) {
+        if (dirtySections & (1u << section)) {
+            generateSection(static_cast<RoomSection>(section));
+            rebuilt += rebuilt.empty() ? SECTION_NAMES[section] : std::string(", ") + SECTION_NAMES[section];
+        }
+    }
+    dirtySections = 0;
+
+    size_t allocations = mesh.getAllocationCount();
+    size_t bytes = mesh.upload();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    rebuildCount++;
+    lastRebuildMicroseconds = std::chrono::duration<double, std::micro>(end - start).count();
+    lastRebuildBytes = bytes;
+    if (full) {
+        fullRebuildMicroseconds = lastRebuildMicroseconds;
+        fullRebuildBytes = mesh.getVertexCount() * sizeof(MaterialVertex) + mesh.getIndexCount() * sizeof(unsigned int);
     }
 
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    std::cout << "Room rebuild (" << rebuilt << "): " << lastRebuildMicroseconds << " us, "
+        << bytes / 1024.0 << " KB uploaded into " << mesh.getStorageBytes() / 1024.0 << " KB of storage"
+        << (mesh.getAllocationCount() != allocations ? " (new storage)" : "") << std::endl;
 
-    glBindVertexArray(0);
+    WallTessellator::Stats wallStats = getWallStats();
+    std::cout << "Room walls: " << wallStats.walls << " walls, " << wallStats.openings << " openings -> "
+        << wallStats.quads << " quads (" << wallStats.getVertices() << " vertices), overdraw "
+        << wallStats.getOverdraw() << "x; per-opening strips would be " << wallStats.stripQuads
+        << " quads (" << wallStats.getStripVertices() << " vertices), overdraw "
+        << wallStats.getStripOverdraw() << "x" << std::endl;
 }
 
 void Room::setup() {
-    generateVertices();
-    updateBuffers();
+    materials.setup();
+    rebuild();
 }
 
-void Room::draw() {
-    if (needsUpdate) {
-        generateVertices();
-        updateBuffers();
+void Room::draw(Shader& shader) {
+    if (dirtySections != 0) {
+        rebuild();
     }
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    shader.setBool("materialVertex", true);
+    materials.bind();
+    mesh.draw();
+    shader.setBool("materialVertex", false);
 }
+
+WallTessellator::Stats Room::getWallStats() const {
+    WallTessellator::Stats total;
+    for (const auto& stats : sectionWallStats) {
+        total.add(stats);
+    }
+    return total;
+}
+
 void Room::createEntranceArch() {
     float halfWidth = roomWidth / 2.0f;
     float halfDepth = roomDepth / 2.0f;
@@ -555,257 +394,78 @@ void Room::createEntranceArch() {
 
     float doorWidth = 4.0f;       // Individual door width
     float doorHeight = 7.0f;      // Door height
-    float windowWidth = 3.0f;     // Window width
-    float windowHeight = 4.0f;    // Window height
-    float windowY = 4.0f;         // Window base height
-
-    // Create the front wall structure with OPENINGS (no wall behind windows)
-
-    // Left section of wall (left of windows) - FILL THE GAP
-    addQuad(
-        glm::vec3(-halfWidth, 0.0f, wallZ),
-        glm::vec3(-halfWidth + 2.0f, 0.0f, wallZ),
-        glm::vec3(-halfWidth + 2.0f, roomHeight, wallZ),
-        glm::vec3(-halfWidth, roomHeight, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Right section of wall (right of windows) - FILL THE GAP
-    addQuad(
-        glm::vec3(halfWidth - 2.0f, 0.0f, wallZ),
-        glm::vec3(halfWidth, 0.0f, wallZ),
-        glm::vec3(halfWidth, roomHeight, wallZ),
-        glm::vec3(halfWidth - 2.0f, roomHeight, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Top section above everything
-    addQuad(
-        glm::vec3(-halfWidth, roomHeight, wallZ),
-        glm::vec3(halfWidth, roomHeight, wallZ),
-        glm::vec3(halfWidth, roomHeight - 2.0f, wallZ),
-        glm::vec3(-halfWidth, roomHeight - 2.0f, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill the space above windows and below ceiling - IMPORTANT!
-    // But ONLY above the wall sections, not above windows
-    addQuad(
-        glm::vec3(-halfWidth, roomHeight - 2.0f, wallZ),
-        glm::vec3(-halfWidth + 2.0f, roomHeight - 2.0f, wallZ),
-        glm::vec3(-halfWidth + 2.0f, windowY + windowHeight, wallZ),
-        glm::vec3(-halfWidth, windowY + windowHeight, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    addQuad(
-        glm::vec3(halfWidth - 2.0f, roomHeight - 2.0f, wallZ),
-        glm::vec3(halfWidth, roomHeight - 2.0f, wallZ),
-        glm::vec3(halfWidth, windowY + windowHeight, wallZ),
-        glm::vec3(halfWidth - 2.0f, windowY + windowHeight, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill area below doors (just the strip at the bottom)
-    addQuad(
-        glm::vec3(-doorWidth - 1.0f, 0.0f, wallZ),
-        glm::vec3(doorWidth + 1.0f, 0.0f, wallZ),
-        glm::vec3(doorWidth + 1.0f, 0.5f, wallZ), // Small strip at bottom
-        glm::vec3(-doorWidth - 1.0f, 0.5f, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill area below windows (left side - between wall and first window)
-    addQuad(
-        glm::vec3(-halfWidth + 2.0f, 0.0f, wallZ),
-        glm::vec3(-12.0f + 1.5f, 0.0f, wallZ),
-        glm::vec3(-12.0f + 1.5f, windowY, wallZ),
-        glm::vec3(-halfWidth + 2.0f, windowY, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill area below windows (right side - between wall and first window)
-    addQuad(
-        glm::vec3(12.0f - 1.5f, 0.0f, wallZ),
-        glm::vec3(halfWidth - 2.0f, 0.0f, wallZ),
-        glm::vec3(halfWidth - 2.0f, windowY, wallZ),
-        glm::vec3(12.0f - 1.5f, windowY, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill area between windows and doors (left side)
-    addQuad(
-        glm::vec3(-12.0f + 1.5f, 0.0f, wallZ),
-        glm::vec3(-doorWidth - 1.0f, 0.0f, wallZ),
-        glm::vec3(-doorWidth - 1.0f, windowY, wallZ),
-        glm::vec3(-12.0f + 1.5f, windowY, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill area between windows and doors (right side)
-    addQuad(
-        glm::vec3(doorWidth + 1.0f, 0.0f, wallZ),
-        glm::vec3(12.0f - 1.5f, 0.0f, wallZ),
-        glm::vec3(12.0f - 1.5f, windowY, wallZ),
-        glm::vec3(doorWidth + 1.0f, windowY, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill vertical strips BETWEEN windows (not behind them)
-    // Between left windows
-    addQuad(
-        glm::vec3(-8.0f, windowY, wallZ),
-        glm::vec3(-4.0f, windowY, wallZ),
-        glm::vec3(-4.0f, windowY + windowHeight, wallZ),
-        glm::vec3(-8.0f, windowY + windowHeight, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Between right windows
-    addQuad(
-        glm::vec3(4.0f, windowY, wallZ),
-        glm::vec3(8.0f, windowY, wallZ),
-        glm::vec3(8.0f, windowY + windowHeight, wallZ),
-        glm::vec3(4.0f, windowY + windowHeight, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Fill area above doors between windows (the horizontal strip)
-    addQuad(
-        glm::vec3(-doorWidth - 1.0f, doorHeight, wallZ),
-        glm::vec3(doorWidth + 1.0f, doorHeight, wallZ),
-        glm::vec3(doorWidth + 1.0f, windowY, wallZ),
-        glm::vec3(-doorWidth - 1.0f, windowY, wallZ),
-        wallColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // REMOVED: The wall sections behind the windows (NO MORE SOLID WALLS BEHIND WINDOWS!)
-    // The window areas should be completely open
-
-    // Create window frames ONLY (no background wall)
-    // Left side windows (2 windows)
-    for (int i = 0; i < 2; i++) {
-        float windowLeft = -12.0f + i * 8.0f - windowWidth / 2.0f;
-        float windowRight = windowLeft + windowWidth;
-
-        // Window frame top (thin strip)
-        addQuad(
-            glm::vec3(windowLeft - 0.1f, windowY + windowHeight, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY + windowHeight, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY + windowHeight + 0.2f, wallZ),
-            glm::vec3(windowLeft - 0.1f, windowY + windowHeight + 0.2f, wallZ),
-            accentColor,
-            glm::vec3(0.0f, 0.0f, -1.0f)
-        );
-
-        // Window frame bottom (thin strip)
-        addQuad(
-            glm::vec3(windowLeft - 0.1f, windowY - 0.2f, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY - 0.2f, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY, wallZ),
-            glm::vec3(windowLeft - 0.1f, windowY, wallZ),
-            accentColor,
-            glm::vec3(0.0f, 0.0f, -1.0f)
-        );
-
-        // Window frame left (thin strip)
-        addQuad(
-            glm::vec3(windowLeft - 0.2f, windowY, wallZ),
-            glm::vec3(windowLeft, windowY, wallZ),
-            glm::vec3(windowLeft, windowY + windowHeight, wallZ),
-            glm::vec3(windowLeft - 0.2f, windowY + windowHeight, wallZ),
-            accentColor,
-            glm::vec3(0.0f, 0.0f, -1.0f)
-        );
-
-        // Window frame right (thin strip)
-        addQuad(
-            glm::vec3(windowRight, windowY, wallZ),
-            glm::vec3(windowRight + 0.2f, windowY, wallZ),
-            glm::vec3(windowRight + 0.2f, windowY + windowHeight, wallZ),
-            glm::vec3(windowRight, windowY + windowHeight, wallZ),
-            accentColor,
-            glm::vec3(0.0f, 0.0f, -1.0f)
-        );
+    const float frameWidth = 0.2f;
+    std::vector<WallTessellator::Rect> windows = getFrontWindowRects();
+
+    // Front wall with the windows and the doorway cut out. Each window opening
+    // includes its frame; the doorway starts above the strip at the bottom.
+    std::vector<WallTessellator::Rect> openings;
+    for (const auto& window : windows) {
+        openings.push_back({ window.minX - frameWidth, window.minY - frameWidth,
+            window.maxX + frameWidth, window.maxY + frameWidth });
     }
+    openings.push_back({ -doorWidth - 1.0f, 0.5f, doorWidth + 1.0f, doorHeight + frameWidth });
+
+    addWall(glm::vec3(0.0f, 0.0f, wallZ), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+        { -halfWidth, 0.0f, halfWidth, roomHeight }, openings,
+        ROOM_WALL, glm::vec3(0.0f, 0.0f, -1.0f));
 
-    // Right side windows (2 windows)
-    for (int i = 0; i < 2; i++) {
-        float windowLeft = 12.0f - i * 8.0f - windowWidth / 2.0f;
-        float windowRight = windowLeft + windowWidth;
+    // Window frames, inside the openings
+    for (const auto& window : windows) {
+        float windowLeft = window.minX;
+        float windowRight = window.maxX;
+        float windowY = window.minY;
+        float windowHeight = window.maxY - window.minY;
 
         // Window frame top (thin strip)
         addQuad(
-            glm::vec3(windowLeft - 0.1f, windowY + windowHeight, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY + windowHeight, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY + windowHeight + 0.2f, wallZ),
-            glm::vec3(windowLeft - 0.1f, windowY + windowHeight + 0.2f, wallZ),
-            accentColor,
+            glm::vec3(windowLeft - frameWidth, windowY + windowHeight, wallZ),
+            glm::vec3(windowRight + frameWidth, windowY + windowHeight, wallZ),
+            glm::vec3(windowRight + frameWidth, windowY + windowHeight + frameWidth, wallZ),
+            glm::vec3(windowLeft - frameWidth, windowY + windowHeight + frameWidth, wallZ),
+            ROOM_ACCENT,
             glm::vec3(0.0f, 0.0f, -1.0f)
         );
 
         // Window frame bottom (thin strip)
         addQuad(
-            glm::vec3(windowLeft - 0.1f, windowY - 0.2f, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY - 0.2f, wallZ),
-            glm::vec3(windowRight + 0.1f, windowY, wallZ),
-            glm::vec3(windowLeft - 0.1f, windowY, wallZ),
-            accentColor,
+            glm::vec3(windowLeft - frameWidth, windowY - frameWidth, wallZ),
+            glm::vec3(windowRight + frameWidth, windowY - frameWidth, wallZ),
+            glm::vec3(windowRight + frameWidth, windowY, wallZ),
+            glm::vec3(windowLeft - frameWidth, windowY, wallZ),
+            ROOM_ACCENT,
             glm::vec3(0.0f, 0.0f, -1.0f)
         );
 
         // Window frame left (thin strip)
         addQuad(
-            glm::vec3(windowLeft - 0.2f, windowY, wallZ),
+            glm::vec3(windowLeft - frameWidth, windowY, wallZ),
             glm::vec3(windowLeft, windowY, wallZ),
             glm::vec3(windowLeft, windowY + windowHeight, wallZ),
-            glm::vec3(windowLeft - 0.2f, windowY + windowHeight, wallZ),
-            accentColor,
+            glm::vec3(windowLeft - frameWidth, windowY + windowHeight, wallZ),
+            ROOM_ACCENT,
             glm::vec3(0.0f, 0.0f, -1.0f)
         );
 
         // Window frame right (thin strip)
         addQuad(
             glm::vec3(windowRight, windowY, wallZ),
-            glm::vec3(windowRight + 0.2f, windowY, wallZ),
-            glm::vec3(windowRight + 0.2f, windowY + windowHeight, wallZ),
+            glm::vec3(windowRight + frameWidth, windowY, wallZ),
+            glm::vec3(windowRight + frameWidth, windowY + windowHeight, wallZ),
             glm::vec3(windowRight, windowY + windowHeight, wallZ),
-            accentColor,
+            ROOM_ACCENT,
             glm::vec3(0.0f, 0.0f, -1.0f)
         );
     }
 
-    // Create door frames (just frames, no solid wall)
-    // Left door frame top
+    // Door frames, inside the doorway
+    // Top frame across both doors
     addQuad(
         glm::vec3(-doorWidth - 1.0f, doorHeight, wallZ),
-        glm::vec3(-1.0f, doorHeight, wallZ),
-        glm::vec3(-1.0f, doorHeight + 0.2f, wallZ),
-        glm::vec3(-doorWidth - 1.0f, doorHeight + 0.2f, wallZ),
-        accentColor,
-        glm::vec3(0.0f, 0.0f, -1.0f)
-    );
-
-    // Right door frame top
-    addQuad(
-        glm::vec3(1.0f, doorHeight, wallZ),
         glm::vec3(doorWidth + 1.0f, doorHeight, wallZ),
-        glm::vec3(doorWidth + 1.0f, doorHeight + 0.2f, wallZ),
-        glm::vec3(1.0f, doorHeight + 0.2f, wallZ),
-        accentColor,
+        glm::vec3(doorWidth + 1.0f, doorHeight + frameWidth, wallZ),
+        glm::vec3(-doorWidth - 1.0f, doorHeight + frameWidth, wallZ),
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
@@ -813,142 +473,125 @@ void Room::createEntranceArch() {
     addQuad(
         glm::vec3(-1.0f, 0.5f, wallZ), // Start above the bottom strip
         glm::vec3(1.0f, 0.5f, wallZ),
-        glm::vec3(1.0f, doorHeight + 0.2f, wallZ),
-        glm::vec3(-1.0f, doorHeight + 0.2f, wallZ),
-        accentColor,
+        glm::vec3(1.0f, doorHeight, wallZ),
+        glm::vec3(-1.0f, doorHeight, wallZ),
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
     // Left door vertical frame
     addQuad(
-        glm::vec3(-doorWidth - 1.0f, 0.5f, wallZ), // Start above the bottom strip
-        glm::vec3(-doorWidth - 0.8f, 0.5f, wallZ),
-        glm::vec3(-doorWidth - 0.8f, doorHeight + 0.2f, wallZ),
-        glm::vec3(-doorWidth - 1.0f, doorHeight + 0.2f, wallZ),
-        accentColor,
+        glm::vec3(-doorWidth - 1.0f, 0.5f, wallZ),
+        glm::vec3(-doorWidth - 1.0f + frameWidth, 0.5f, wallZ),
+        glm::vec3(-doorWidth - 1.0f + frameWidth, doorHeight, wallZ),
+        glm::vec3(-doorWidth - 1.0f, doorHeight, wallZ),
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
     // Right door vertical frame
     addQuad(
-        glm::vec3(doorWidth + 0.8f, 0.5f, wallZ), // Start above the bottom strip
+        glm::vec3(doorWidth + 1.0f - frameWidth, 0.5f, wallZ),
         glm::vec3(doorWidth + 1.0f, 0.5f, wallZ),
-        glm::vec3(doorWidth + 1.0f, doorHeight + 0.2f, wallZ),
-        glm::vec3(doorWidth + 0.8f, doorHeight + 0.2f, wallZ),
-        accentColor,
+        glm::vec3(doorWidth + 1.0f, doorHeight, wallZ),
+        glm::vec3(doorWidth + 1.0f - frameWidth, doorHeight, wallZ),
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 }
 
-// Generate all vertices for the exhibition hall - FIXED
-void Room::generateVertices() {
-    vertices.clear();
-    indices.clear();
+// Generate the vertices of one part of the exhibition hall
+void Room::generateSection(RoomSection section) {
+    mesh.clear(section);
+    sectionWallStats[section] = WallTessellator::Stats();
+    building = section;
 
     float halfWidth = roomWidth / 2.0f;
     float halfDepth = roomDepth / 2.0f;
 
-    // 1. FLOOR
-    addQuad(
-        glm::vec3(-halfWidth, 0.0f, -halfDepth),
-        glm::vec3(halfWidth, 0.0f, -halfDepth),
-        glm::vec3(halfWidth, 0.0f, halfDepth),
-        glm::vec3(-halfWidth, 0.0f, halfDepth),
-        floorColor,
-        glm::vec3(0.0f, 1.0f, 0.0f)
-    );
-
-    // 2. CEILING
-    addQuad(
-        glm::vec3(-halfWidth, roomHeight, -halfDepth),
-        glm::vec3(halfWidth, roomHeight, -halfDepth),
-        glm::vec3(halfWidth, roomHeight, halfDepth),
-        glm::vec3(-halfWidth, roomHeight, halfDepth),
-        ceilingColor,
-        glm::vec3(0.0f, -1.0f, 0.0f)
-    );
-
-    // 3. LEFT WALL - with windows if enabled
-    if (hasSideWindows) {
-        createSideWindows();
-    }
-    else {
-        // Solid left wall if no windows
+    switch (section) {
+    case SECTION_SHELL:
+        // 1. FLOOR
         addQuad(
             glm::vec3(-halfWidth, 0.0f, -halfDepth),
-            glm::vec3(-halfWidth, 0.0f, halfDepth),
-            glm::vec3(-halfWidth, roomHeight, halfDepth),
-            glm::vec3(-halfWidth, roomHeight, -halfDepth),
-            wallColor,
-            glm::vec3(1.0f, 0.0f, 0.0f)
-        );
-    }
-
-    // 4. RIGHT WALL - with windows if enabled
-    if (hasSideWindows) {
-        // Already created in createSideWindows()
-    }
-    else {
-        // Solid right wall if no windows
-        addQuad(
             glm::vec3(halfWidth, 0.0f, -halfDepth),
             glm::vec3(halfWidth, 0.0f, halfDepth),
-            glm::vec3(halfWidth, roomHeight, halfDepth),
-            glm::vec3(halfWidth, roomHeight, -halfDepth),
-            wallColor,
-            glm::vec3(-1.0f, 0.0f, 0.0f)
+            glm::vec3(-halfWidth, 0.0f, halfDepth),
+            ROOM_FLOOR,
+            glm::vec3(0.0f, 1.0f, 0.0f)
         );
-    }
 
-    // 5. BACK WALL WITH LARGE WINDOW
-    if (hasMainWindow) {
-        createMainWallWithLargeWindow();
-    }
-    else {
-        // Solid back wall if no window
+        // 2. CEILING
         addQuad(
-            glm::vec3(-halfWidth, 0.0f, -halfDepth),
-            glm::vec3(halfWidth, 0.0f, -halfDepth),
-            glm::vec3(halfWidth, roomHeight, -halfDepth),
             glm::vec3(-halfWidth, roomHeight, -halfDepth),
-            wallColor,
-            glm::vec3(0.0f, 0.0f, 1.0f)
+            glm::vec3(halfWidth, roomHeight, -halfDepth),
+            glm::vec3(halfWidth, roomHeight, halfDepth),
+            glm::vec3(-halfWidth, roomHeight, halfDepth),
+            ROOM_CEILING,
+            glm::vec3(0.0f, -1.0f, 0.0f)
         );
-    }
+        break;
+
+    case SECTION_SIDE_WALLS:
+        // 3./4. LEFT AND RIGHT WALLS - with windows if enabled
+        if (hasSideWindows) {
+            createSideWindows();
+        }
+        else {
+            // Solid side walls if no windows
+            addWall(glm::vec3(-halfWidth, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+                { -halfDepth, 0.0f, halfDepth, roomHeight }, {}, ROOM_WALL, glm::vec3(1.0f, 0.0f, 0.0f));
+            addWall(glm::vec3(halfWidth, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+                { -halfDepth, 0.0f, halfDepth, roomHeight }, {}, ROOM_WALL, glm::vec3(-1.0f, 0.0f, 0.0f));
+        }
+        sideWindowVersion++;
+        break;
 
-    // 6. FRONT WALL WITH ENTRANCE AND WINDOWS
-    createEntranceArch();
+    case SECTION_BACK_WALL:
+        // 5. BACK WALL WITH LARGE WINDOW
+        if (hasMainWindow) {
+            createMainWallWithLargeWindow();
+        }
+        else {
+            // Solid back wall if no window
+            addWall(glm::vec3(0.0f, 0.0f, -halfDepth), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+                { -halfWidth, 0.0f, halfWidth, roomHeight }, {}, ROOM_WALL, glm::vec3(0.0f, 0.0f, 1.0f));
+        }
+        break;
 
-    // Add front windows if enabled
-    std::cout << "DEBUG: hasFrontWindows = " << hasFrontWindows << std::endl;  // Add this!
+    case SECTION_FRONT_WALL:
+        // 6. FRONT WALL WITH ENTRANCE AND WINDOWS
+        createEntranceArch();
 
-    // Add front windows if enabled
-    if (hasFrontWindows) {
-        std::cout << "DEBUG: Calling createFrontWindows()" << std::endl;  // Add this!
-        createFrontWindows();
-    }
+        // Add front windows if enabled
+        if (hasFrontWindows) {
+            createFrontWindows();
+        }
+        break;
 
-    // 7. ARCHITECTURAL COLUMNS
-    if (hasColumns) {
-        createColumns();
-    }
+    case SECTION_COLUMNS:
+        // 7. ARCHITECTURAL COLUMNS
+        if (hasColumns) {
+            createColumns();
+        }
+        break;
 
-    // 8. DISPLAY PLATFORMS
-    if (hasDisplayPlatforms) {
-        createDisplayPlatforms();
-    }
+    case SECTION_PLATFORMS:
+        // 8. DISPLAY PLATFORMS
+        if (hasDisplayPlatforms) {
+            createDisplayPlatforms();
+        }
+        break;
 
-    needsUpdate = false;
+    default:
+        break;
+    }
 }
 
 
 void Room::cleanup() {
-    if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
-        VAO = VBO = EBO = 0;
-    }
+    mesh.cleanup();
+    materials.cleanup();
 }
 
 
@@ -964,7 +607,7 @@ void Room::createDoorFrames() {
         glm::vec3(-0.5f, doorHeight, wallZ),
         glm::vec3(-0.5f, 0.0f, wallZ),
         glm::vec3(-doorWidth - 1.5f, 0.0f, wallZ),
-        accentColor,
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
@@ -974,7 +617,7 @@ void Room::createDoorFrames() {
         glm::vec3(doorWidth + 1.5f, doorHeight, wallZ),
         glm::vec3(doorWidth + 1.5f, 0.0f, wallZ),
         glm::vec3(0.5f, 0.0f, wallZ),
-        accentColor,
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
@@ -984,92 +627,18 @@ void Room::createDoorFrames() {
         glm::vec3(doorWidth + 1.5f, doorHeight, wallZ),
         glm::vec3(doorWidth + 1.5f, doorHeight - 0.2f, wallZ),
         glm::vec3(-doorWidth - 1.5f, doorHeight - 0.2f, wallZ),
-        accentColor,
+        ROOM_ACCENT,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
-    // Create the doors themselves
-    createDoors();
-}
-
-// Create the actual doors
-void Room::createDoors() {
-    float wallZ = roomDepth / 2.0f - 0.01f; // Slightly in front of the wall
-    float doorWidth = 4.0f;
-    float doorHeight = 7.0f;
-
-    // Apply door rotation for animation
-    float leftDoorAngle = glm::radians(doorAngle);
-    float rightDoorAngle = glm::radians(-doorAngle); // Opposite direction
-
-    // Left door
-    glm::vec3 leftDoorHinge(-doorWidth / 2 - 0.75f, 0.0f, wallZ);
-
-    // Calculate left door corners based on rotation
-    //glm::mat4 leftRotation = glm::rotate(glm::mat4(1.0f), leftDoorAngle, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glm::vec3 leftBottomLeft = leftDoorHinge;
-    glm::vec3 leftBottomRight = leftDoorHinge + glm::vec3(doorWidth, 0.0f, 0.0f);
-    glm::vec3 leftTopRight = leftDoorHinge + glm::vec3(doorWidth, doorHeight, 0.0f);
-    glm::vec3 leftTopLeft = leftDoorHinge + glm::vec3(0.0f, doorHeight, 0.0f);
-
-    // Apply rotation around hinge point
-    //leftBottomRight = glm::vec3(leftRotation * glm::vec4(leftBottomRight - leftDoorHinge, 1.0f)) + leftDoorHinge;
-    //leftTopRight = glm::vec3(leftRotation * glm::vec4(leftTopRight - leftDoorHinge, 1.0f)) + leftDoorHinge;
-    //leftTopLeft = glm::vec3(leftRotation * glm::vec4(leftTopLeft - leftDoorHinge, 1.0f)) + leftDoorHinge;
-
-    // Draw left door (dark wood color)
-    glm::vec3 doorColor = glm::vec3(0.5f, 0.35f, 0.25f); // Dark wood
-    addQuad(leftBottomLeft, leftBottomRight, leftTopRight, leftTopLeft,
-        doorColor, glm::vec3(0.0f, 0.0f, -1.0f));
-
-    // Right door
-    glm::vec3 rightDoorHinge(doorWidth / 2 + 0.75f, 0.0f, wallZ);
-
-    // Calculate right door corners based on rotation
-    //glm::mat4 rightRotation = glm::rotate(glm::mat4(1.0f), rightDoorAngle, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glm::vec3 rightBottomLeft = rightDoorHinge + glm::vec3(-doorWidth, 0.0f, 0.0f);
-    glm::vec3 rightBottomRight = rightDoorHinge;
-    glm::vec3 rightTopRight = rightDoorHinge + glm::vec3(0.0f, doorHeight, 0.0f);
-    glm::vec3 rightTopLeft = rightDoorHinge + glm::vec3(-doorWidth, doorHeight, 0.0f);
-
-    // Apply rotation around hinge point
-    //rightBottomLeft = glm::vec3(rightRotation * glm::vec4(rightBottomLeft - rightDoorHinge, 1.0f)) + rightDoorHinge;
-    //rightTopLeft = glm::vec3(rightRotation * glm::vec4(rightTopLeft - rightDoorHinge, 1.0f)) + rightDoorHinge;
-    //rightTopRight = glm::vec3(rightRotation * glm::vec4(rightTopRight - rightDoorHinge, 1.0f)) + rightDoorHinge;
-
-    // Draw right door
-    addQuad(rightBottomLeft, rightBottomRight, rightTopRight, rightTopLeft,
-        doorColor, glm::vec3(0.0f, 0.0f, -1.0f));
+    // The doors themselves are Door objects, see Door::draw
 }
 
-
-
 // Door controls
 void Room::toggleDoors() {
     doorsOpen = !doorsOpen;
 }
 
-void Room::updateDoors(float deltaTime) {
-    float targetAngle = doorsOpen ? 90.0f : 0.0f;
-    float speed = 60.0f; // degrees per second
-
-    if (doorAngle < targetAngle) {
-        doorAngle += speed * deltaTime;
-        if (doorAngle > targetAngle) doorAngle = targetAngle;
-    }
-    else if (doorAngle > targetAngle) {
-        doorAngle -= speed * deltaTime;
-        if (doorAngle < targetAngle) doorAngle = targetAngle;
-    }
-
-    // Regenerate vertices if door angle changed
-    if (fabs(doorAngle - targetAngle) > 0.1f) {
-        needsUpdate = true;
-    }
-}
-
 void Room::setDoorsOpen(bool open) {
     doorsOpen = open;
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "material_table.h"
+#include "sectioned_mesh.h"
+#include "shader.h"
+#include "wall_tessellator.h"
 
 class Room {
 private:
@@ -12,11 +16,15 @@ private:
     float roomHeight;
     float roomDepth;
 
-    // Modern showroom color scheme
-    glm::vec3 wallColor;           // Single color for all walls
-    glm::vec3 floorColor;
-    glm::vec3 ceilingColor;
-    glm::vec3 accentColor;         // For architectural details
+    // Modern showroom color scheme, one material per surface kind. Vertices
+    // only store the index, so recolouring never rebuilds the mesh.
+    enum RoomMaterial {
+        ROOM_WALL,                 // Single color for all walls
+        ROOM_FLOOR,                // Floor and platform tops
+        ROOM_CEILING,
+        ROOM_ACCENT                // For architectural details
+    };
+    MaterialTable materials;
 
     // Exhibition features
     bool hasMainWindow = false;
@@ -31,29 +39,67 @@ private:
     float windowHeight = 4.0f;
     float windowWidth = 3.0f;
 
-    // Door properties
+    // The four windows either side of the entrance
+    float frontWindowWidth = 3.0f;
+    float frontWindowHeight = 4.0f;
+    float frontWindowY = 4.0f;     // Bottom edge
+
+    // Door properties. The leaves are separate Door objects drawn with their
+    // own model matrix, so opening them never touches this mesh.
     bool hasDoors = true;
-    float doorAngle = 0.0f;        // For animation
     bool doorsOpen = false;
 
     // Exhibition details
     bool hasColumns = true;
     bool hasDisplayPlatforms = true;
 
+    // Parts of the mesh that are rebuilt on their own: a setting only
+    // re-tessellates and re-uploads the sections it changes
+    enum RoomSection {
+        SECTION_SHELL,             // Floor and ceiling
+        SECTION_SIDE_WALLS,
+        SECTION_BACK_WALL,
+        SECTION_FRONT_WALL,        // Entrance arch, doorway and front windows
+        SECTION_COLUMNS,
+        SECTION_PLATFORMS,
+        SECTION_COUNT
+    };
+
     // OpenGL objects
-    unsigned int VAO, VBO, EBO;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    bool needsUpdate;
+    SectionedMesh mesh;
+    RoomSection building;          // Section addQuad/addTriangle write to
+    unsigned int dirtySections;    // Bit per RoomSection
+    unsigned int sideWindowVersion = 0;
+
+    // Cost of the last (partial) rebuild: only its dirty sections are
+    // regenerated and uploaded. The last time every section was rebuilt is
+    // kept apart, as the cost of a full rebuild.
+    unsigned int rebuildCount = 0;
+    double lastRebuildMicroseconds = 0.0;
+    size_t lastRebuildBytes = 0;
+    double fullRebuildMicroseconds = 0.0;
+    size_t fullRebuildBytes = 0;
+    WallTessellator::Stats sectionWallStats[SECTION_COUNT];
 
     // Helper methods
-    void generateVertices();
-    void updateBuffers();
+    void markDirty(RoomSection section) { dirtySections |= 1u << section; }
+    void rebuild();
+    void generateSection(RoomSection section);
     void addQuad(const glm::vec3& p1, const glm::vec3& p2,
         const glm::vec3& p3, const glm::vec3& p4,
-        const glm::vec3& color, const glm::vec3& normal);
+        int material, const glm::vec3& normal);
     void addTriangle(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
-        const glm::vec3& color, const glm::vec3& normal);
+        int material, const glm::vec3& normal);
+    // Solid part of a wall with openings cut out; (u, v) in wall and openings
+    // is the point origin + u * uAxis + v * vAxis
+    void addWall(const glm::vec3& origin, const glm::vec3& uAxis, const glm::vec3& vAxis,
+        const WallTessellator::Rect& wall, const std::vector<WallTessellator::Rect>& openings,
+        int material, const glm::vec3& normal);
+    // Window openings in wall (u, v) coordinates, the one layout both the
+    // wall builders and getWindowOpenings() use. Side walls run along z, so
+    // (u, v) is (z, y); the front wall's is (x, y). Glass only, no frames.
+    std::vector<WallTessellator::Rect> getSideWindowRects() const;
+    std::vector<WallTessellator::Rect> getFrontWindowRects() const;
     void createMainWallWithLargeWindow();
     void createSideWindows();
     void createFrontWindows();
@@ -61,18 +107,13 @@ private:
     void createDisplayPlatforms();
     void createEntranceArch();
     void createDoorFrames();  // New method
-    void createDoors();       // New method
-
-    // Helper for creating windows in walls
-    void addWindowToWall(float wallZ, bool isFrontWall = false);
-    void createWallWithWindows(float wallZ, const glm::vec3& normal, bool isFrontWall = false);
 
 public:
     // Constructor for large exhibition hall
     Room(float width = 40.0f, float height = 15.0f, float depth = 30.0f);
 
     void setup();
-    void draw();
+    void draw(Shader& shader);
     void cleanup();
 
     // Getters
@@ -84,19 +125,35 @@ public:
     glm::vec3 getWindowPosition() const { return windowPos; }
     glm::vec3 getWindowSize() const { return windowSize; }
 
+    // Every window opening the current settings cut into the walls, for
+    // glazing them: centre, width x height, and the wall normal (into the hall)
+    struct WindowOpening {
+        glm::vec3 center;
+        glm::vec2 size;
+        glm::vec3 normal;
+        bool isMainWindow;
+    };
+    std::vector<WindowOpening> getWindowOpenings() const;
+    // Just the side walls' openings (the tail of getWindowOpenings), and a
+    // count of side wall rebuilds: when it moves, glass over them is stale
+    std::vector<WindowOpening> getSideWindowOpenings() const;
+    unsigned int getSideWindowVersion() const { return sideWindowVersion; }
+
     // Color settings
-    void setWallColor(const glm::vec3& color) { wallColor = color; needsUpdate = true; }
-    void setFloorColor(const glm::vec3& color) { floorColor = color; needsUpdate = true; }
-    void setCeilingColor(const glm::vec3& color) { ceilingColor = color; needsUpdate = true; }
+    // One MaterialTable write each, no rebuild
+    void setWallColor(const glm::vec3& color) { materials.setColor(ROOM_WALL, color); }
+    void setFloorColor(const glm::vec3& color) { materials.setColor(ROOM_FLOOR, color); }
+    void setCeilingColor(const glm::vec3& color) { materials.setColor(ROOM_CEILING, color); }
+    const MaterialTable& getMaterials() const { return materials; }
 
     // Window settings
-    void enableSideWindows(bool enable) { hasSideWindows = enable; needsUpdate = true; }
-    void enableFrontWindows(bool enable) { hasFrontWindows = enable; needsUpdate = true; }
-    void setWindowSpacing(float spacing) { windowSpacing = spacing; needsUpdate = true; }
+    void enableSideWindows(bool enable) { hasSideWindows = enable; markDirty(SECTION_SIDE_WALLS); }
+    void enableFrontWindows(bool enable) { hasFrontWindows = enable; markDirty(SECTION_FRONT_WALL); }
+    void setWindowSpacing(float spacing) { windowSpacing = spacing; markDirty(SECTION_SIDE_WALLS); }
     void setWindowSize(float width, float height) { 
         windowWidth = width; 
         windowHeight = height; 
-        needsUpdate = true; 
+        markDirty(SECTION_SIDE_WALLS);
     }
 
     // Exhibition features
@@ -104,9 +161,16 @@ public:
 
     // Door controls
     void toggleDoors();
-    void updateDoors(float deltaTime);
     void setDoorsOpen(bool open);
     bool areDoorsOpen() const { return doorsOpen; }
+
+    // Mesh rebuild statistics
+    unsigned int getRebuildCount() const { return rebuildCount; }
+    double getLastRebuildMicroseconds() const { return lastRebuildMicroseconds; }
+    size_t getLastRebuildBytes() const { return lastRebuildBytes; }
+    double getFullRebuildMicroseconds() const { return fullRebuildMicroseconds; }
+    size_t getFullRebuildBytes() const { return fullRebuildBytes; }
+    WallTessellator::Stats getWallStats() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "scene.h"
+#include "frustum_culler.h"
+
+Bvh Scene::bvh;
+
+int Scene::add(const BoundingBox& box, SceneObjectType type, void* object) {
+    int proxy = bvh.insert(box, object, type);
+    FrustumCuller::refresh(proxy);
+    return proxy;
+}
+
+void Scene::move(int proxy, const BoundingBox& box) {
+    bvh.update(proxy, box);
+    FrustumCuller::refresh(proxy);
+}
+
+void Scene::remove(int proxy) {
+    bvh.remove(proxy);
+}
+
+const char* Scene::getTypeName(SceneObjectType type) {
+    switch (type) {
+    case SCENE_CAR: return "car";
+    case SCENE_TREE: return "tree";
+    case SCENE_STREET_LIGHT: return "street light";
+    case SCENE_DOOR: return "door";
+    case SCENE_ROOM: return "room";
+    case SCENE_PLATFORM: return "platform";
+    case SCENE_GLASS: return "glass";
+    }
+    return "unknown";
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include "bvh.h"
+
+// What a Scene proxy stands for; getObject() is a pointer to that class
+enum SceneObjectType {
+    SCENE_CAR,
+    SCENE_TREE,
+    SCENE_STREET_LIGHT,
+    SCENE_DOOR,
+    SCENE_ROOM,
+    SCENE_PLATFORM,
+    SCENE_GLASS
+};
+
+// Every object placed in the world, in one BVH. Objects add their world box
+// once it is known, move() it whenever their transform changes and remove()
+// it when they go away. Frustum culling and spatial queries then search the
+// tree instead of walking each list of objects.
+class Scene {
+public:
+    static int add(const BoundingBox& box, SceneObjectType type, void* object);
+    static void move(int proxy, const BoundingBox& box);
+    static void remove(int proxy);
+
+    static const Bvh& getBvh() { return bvh; }
+    static SceneObjectType getType(int proxy) { return static_cast<SceneObjectType>(bvh.getCategory(proxy)); }
+    static void* getObject(int proxy) { return bvh.getUserData(proxy); }
+    static const char* getTypeName(SceneObjectType type);
+
+private:
+    static Bvh bvh;
+};
\ No newline at end of file
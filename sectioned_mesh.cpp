@@ -0,0 +1,144 @@
+#include "sectioned_mesh.h"
+#include <algorithm>
+
+namespace {
+    // Slots are this much bigger than their section, so a few more windows
+    // or a finer spacing still fit without new storage
+    const float SECTION_HEADROOM = 0.5f;
+    const size_t SECTION_MIN_VERTICES = 64;
+    const size_t SECTION_MIN_INDICES = 96;
+
+    size_t withHeadroom(size_t count, size_t minimum) {
+        return count + std::max(static_cast<size_t>(count * SECTION_HEADROOM), minimum);
+    }
+}
+
+SectionedMesh::SectionedMesh(int sectionCount)
+    : sections(sectionCount), VAO(0), VBO(0), EBO(0), vertexCapacity(0), indexCapacity(0), allocations(0),
+    counts(sectionCount, 0), offsets(sectionCount, nullptr), baseVertices(sectionCount, 0) {
+}
+
+void SectionedMesh::cleanup() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+    vertexCapacity = indexCapacity = 0;
+    for (auto& section : sections) {
+        section.dirty = true;
+    }
+}
+
+void SectionedMesh::clear(int index) {
+    Section& section = sections[index];
+    section.vertices.clear();
+    section.indices.clear();
+    section.dirty = true;
+}
+
+size_t SectionedMesh::upload() {
+    bool fits = VAO != 0;
+    for (const auto& section : sections) {
+        if (section.vertices.size() > section.vertexCapacity || section.indices.size() > section.indexCapacity) {
+            fits = false;
+        }
+    }
+    if (!fits) {
+        return allocate();
+    }
+
+    size_t bytes = 0;
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (sections[i].dirty) {
+            bytes += uploadSection(sections[i]);
+            counts[i] = static_cast<GLsizei>(sections[i].indices.size());
+        }
+    }
+    glBindVertexArray(0);
+    return bytes;
+}
+
+size_t SectionedMesh::allocate() {
+    // Immutable storage can't grow, so a bigger mesh gets new buffers
+    cleanup();
+    allocations++;
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        Section& section = sections[i];
+        section.vertexOffset = vertexCapacity;
+        section.vertexCapacity = withHeadroom(section.vertices.size(), SECTION_MIN_VERTICES);
+        section.indexOffset = indexCapacity;
+        section.indexCapacity = withHeadroom(section.indices.size(), SECTION_MIN_INDICES);
+        vertexCapacity += section.vertexCapacity;
+        indexCapacity += section.indexCapacity;
+
+        counts[i] = static_cast<GLsizei>(section.indices.size());
+        offsets[i] = (const void*)(section.indexOffset * sizeof(unsigned int));
+        baseVertices[i] = static_cast<GLint>(section.vertexOffset);
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferStorage(GL_ARRAY_BUFFER, vertexCapacity * sizeof(MaterialVertex), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * sizeof(unsigned int), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    MaterialVertex::bindAttributes();
+
+    size_t bytes = 0;
+    for (auto& section : sections) {
+        bytes += uploadSection(section);
+    }
+    glBindVertexArray(0);
+    return bytes;
+}
+
+// Expects the VAO (and so the EBO) and the VBO bound
+size_t SectionedMesh::uploadSection(Section& section) {
+    size_t vertexBytes = section.vertices.size() * sizeof(MaterialVertex);
+    size_t indexBytes = section.indices.size() * sizeof(unsigned int);
+    if (vertexBytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, section.vertexOffset * sizeof(MaterialVertex), vertexBytes,
+            section.vertices.data());
+    }
+    if (indexBytes > 0) {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, section.indexOffset * sizeof(unsigned int), indexBytes,
+            section.indices.data());
+    }
+    section.dirty = false;
+    return vertexBytes + indexBytes;
+}
+
+void SectionedMesh::draw() const {
+    if (VAO == 0) {
+        return;
+    }
+    glBindVertexArray(VAO);
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(),
+        static_cast<GLsizei>(counts.size()), baseVertices.data());
+    glBindVertexArray(0);
+}
+
+size_t SectionedMesh::getVertexCount() const {
+    size_t count = 0;
+    for (const auto& section : sections) {
+        count += section.vertices.size();
+    }
+    return count;
+}
+
+size_t SectionedMesh::getIndexCount() const {
+    size_t count = 0;
+    for (const auto& section : sections) {
+        count += section.indices.size();
+    }
+    return count;
+}
\ No newline at end of file
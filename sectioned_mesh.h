@@ -0,0 +1,61 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+#include "material_table.h"
+
+// GPU storage for procedural MaterialVertex geometry built in independent
+// sections (walls, columns, ...). Every section owns a slot with some
+// headroom in one pair of immutable buffers; after a change only the dirty
+// sections are re-uploaded with glBufferSubData. A section that outgrows
+// its slot makes the next upload() allocate new storage for all of them.
+// Everything is drawn with one glMultiDrawElementsBaseVertex.
+class SectionedMesh {
+public:
+    explicit SectionedMesh(int sectionCount);
+    void cleanup();
+
+    // Empties a section for rebuilding and marks it dirty. Indices are
+    // relative to the section's first vertex.
+    void clear(int section);
+    std::vector<MaterialVertex>& getVertices(int section) { return sections[section].vertices; }
+    std::vector<unsigned int>& getIndices(int section) { return sections[section].indices; }
+    bool isDirty(int section) const { return sections[section].dirty; }
+
+    // GL thread: writes the dirty sections, returns the bytes uploaded
+    size_t upload();
+    void draw() const;
+
+    size_t getVertexCount() const;
+    size_t getIndexCount() const;
+    // Bytes of buffer storage, headroom included
+    size_t getStorageBytes() const {
+        return vertexCapacity * sizeof(MaterialVertex) + indexCapacity * sizeof(unsigned int);
+    }
+    size_t getAllocationCount() const { return allocations; }
+
+private:
+    struct Section {
+        std::vector<MaterialVertex> vertices;
+        std::vector<unsigned int> indices;
+        size_t vertexOffset = 0;    // Slot in the buffers, in elements
+        size_t vertexCapacity = 0;
+        size_t indexOffset = 0;
+        size_t indexCapacity = 0;
+        bool dirty = true;
+    };
+
+    std::vector<Section> sections;
+    GLuint VAO, VBO, EBO;
+    size_t vertexCapacity;
+    size_t indexCapacity;
+    size_t allocations;
+
+    // Draw lists for glMultiDrawElementsBaseVertex, one entry per section
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    std::vector<GLint> baseVertices;
+
+    size_t allocate();
+    size_t uploadSection(Section& section);
+};
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 // Constructor definition
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
@@ -65,6 +67,8 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     // Delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    buildUniformTable();
 }
 
 // Method definitions
@@ -72,28 +76,116 @@ void Shader::use() {
     glUseProgram(ID);
 }
 
-void Shader::setBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+void Shader::setBool(Uniform uniform, bool value) const {
+    glUniform1i(uniform.location, (int)value);
+}
+
+void Shader::setInt(Uniform uniform, int value) const {
+    glUniform1i(uniform.location, value);
 }
 
-void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+void Shader::setFloat(Uniform uniform, float value) const {
+    glUniform1f(uniform.location, value);
 }
 
-void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+void Shader::setVec3(Uniform uniform, const glm::vec3& value) const {
+    glUniform3fv(uniform.location, 1, &value[0]);
 }
 
-void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+void Shader::setMat4(Uniform uniform, const glm::mat4& mat) const {
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
 }
 
-void Shader::setVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+namespace {
+    // FNV-1a
+    uint64_t hashName(const char* name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (; *name; name++) {
+            hash ^= static_cast<unsigned char>(*name);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
 }
 
-void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::buildUniformTable() {
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    struct Active {
+        std::string name;
+        GLint location;
+        GLint size;
+    };
+    std::vector<Active> active;
+    std::vector<char> buffer(std::max(maxLength, 1));
+    size_t entries = 0;
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0) {
+            continue;   // Uniform block member
+        }
+        active.push_back({ name, location, size });
+        entries += size + 1;
+    }
+
+    size_t capacity = 16;
+    while (capacity < entries * 2) {
+        capacity *= 2;
+    }
+    uniformTable.assign(capacity, UniformSlot());
+
+    // Arrays of plain types are reported once as "name[0]"; make "name" and
+    // every "name[i]" resolvable too. Their locations are consecutive.
+    for (const auto& uniform : active) {
+        addUniform(uniform.name, uniform.location);
+        size_t bracket = uniform.name.size() >= 3 ? uniform.name.rfind("[0]") : std::string::npos;
+        if (bracket != std::string::npos && bracket + 3 == uniform.name.size()) {
+            std::string base = uniform.name.substr(0, bracket);
+            addUniform(base, uniform.location);
+            for (GLint element = 1; element < uniform.size; element++) {
+                addUniform(base + "[" + std::to_string(element) + "]", uniform.location + element);
+            }
+        }
+    }
+}
+
+void Shader::addUniform(const std::string& name, GLint location) {
+    uint64_t hash = hashName(name.c_str());
+    size_t mask = uniformTable.size() - 1;
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        UniformSlot& entry = uniformTable[slot];
+        if (entry.name.empty() || (entry.hash == hash && entry.name == name)) {
+            entry.hash = hash;
+            entry.name = name;
+            entry.location = location;
+            return;
+        }
+    }
+}
+
+GLint Shader::findLocation(const char* name) const {
+    if (uniformTable.empty()) {
+        return -1;
+    }
+    uint64_t hash = hashName(name);
+    size_t mask = uniformTable.size() - 1;
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        const UniformSlot& entry = uniformTable[slot];
+        if (entry.name.empty()) {
+            return -1;
+        }
+        if (entry.hash == hash && std::strcmp(entry.name.c_str(), name) == 0) {
+            return entry.location;
+        }
+    }
 }
 
 // Private helper function definition
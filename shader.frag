@@ -4,28 +4,43 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Color;
 in vec3 Normal;
+flat in vec4 ColorOverride;
+in float ViewDepth;
 
+// Same layout as GpuLight in light_buffer.h
 struct Light {
     vec3 position;
-    vec3 color;
     float ambient;
+    vec3 color;
     float diffuse;
     float specular;
     float constant;
     float linear;
     float quadratic;
+    float radius;       // Attenuation is faded out to 0 here
 };
 
-#define MAX_LIGHTS 10
-uniform Light lights[MAX_LIGHTS];
-uniform int numLights;
+layout(std430, binding = 0) readonly buffer LightBlock {
+    int numLights;
+    Light lights[];
+};
+
+// Clustered lighting, see LightClusters: the lights touching each view-space
+// cluster, as a range of clusterLights
+layout(std430, binding = 1) readonly buffer ClusterBlock {
+    uvec4 clusterGrid;      // Clusters along x, y and depth
+    vec4 clusterParams;     // Tile size in pixels (xy), depth slice scale and bias (zw)
+    uvec2 clusterRanges[];  // Offset into clusterLights, light count
+};
+layout(std430, binding = 2) readonly buffer ClusterLightBlock {
+    uint clusterLights[];
+};
+
+// Off: every light is evaluated for every fragment (impostor baking)
+uniform bool clusteredLighting;
 uniform vec3 viewPos;
 uniform float shininess = 32.0;
 
-// ADD THESE UNIFORMS
-uniform bool useColorOverride;
-uniform vec3 colorOverride;
-
 vec3 calculateLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 objectColor) {
     // Ambient
     vec3 ambient = light.ambient * light.color * objectColor;
@@ -43,6 +58,8 @@ vec3 calculateLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 o
     // Attenuation
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    float fade = clamp(1.0 - pow(distance / light.radius, 4.0), 0.0, 1.0);
+    attenuation *= fade * fade;
     
     return (ambient + diffuse + specular) * attenuation;
 }
@@ -54,14 +71,26 @@ void main()
     vec3 viewDir = normalize(viewPos - FragPos);
     
     // Use color override if enabled, otherwise use original Color
-    vec3 objectColor = useColorOverride ? colorOverride : Color;
+    vec3 objectColor = ColorOverride.a > 0.5 ? ColorOverride.rgb : Color;
     
     // Start with a base ambient (dark scene)
     vec3 result = vec3(0.1, 0.1, 0.15) * objectColor;
     
-    // Calculate all lights
-    for(int i = 0; i < numLights; i++) {
-        result += calculateLight(lights[i], norm, FragPos, viewDir, objectColor);
+    if (clusteredLighting) {
+        // Only the lights binned into this fragment's cluster
+        uvec3 cluster;
+        cluster.xy = min(uvec2(gl_FragCoord.xy / clusterParams.xy), clusterGrid.xy - 1u);
+        cluster.z = uint(clamp(log(ViewDepth) * clusterParams.z + clusterParams.w, 0.0, float(clusterGrid.z - 1u)));
+        uvec2 range = clusterRanges[cluster.x + clusterGrid.x * (cluster.y + clusterGrid.y * cluster.z)];
+        for (uint i = 0u; i < range.y; i++) {
+            result += calculateLight(lights[clusterLights[range.x + i]], norm, FragPos, viewDir, objectColor);
+        }
+    }
+    else {
+        // Calculate all lights
+        for(int i = 0; i < numLights; i++) {
+            result += calculateLight(lights[i], norm, FragPos, viewDir, objectColor);
+        }
     }
     
     // Gamma correction
@@ -3,10 +3,20 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 class Shader {
 public:
+    // Location of one active uniform, resolved once. Call sites that set the
+    // same uniform every frame keep one instead of passing the name each time.
+    // A name the program doesn't use gives a handle that sets nothing.
+    struct Uniform {
+        GLint location = -1;
+        bool isValid() const { return location >= 0; }
+    };
+
     unsigned int ID;
 
     // Constructor declaration
@@ -15,16 +25,45 @@ public:
     // Method declarations
     void use();
 
-    void setBool(const std::string& name, bool value) const;
-    void setInt(const std::string& name, int value) const;
-    void setFloat(const std::string& name, float value) const;
-    void setVec3(const std::string& name, const glm::vec3& value) const;
-    void setVec3(const std::string& name, float x, float y, float z) const;
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
+    // Looked up in the table of active uniforms built after linking
+    Uniform uniform(const char* name) const { return Uniform{ findLocation(name) }; }
+    Uniform uniform(const std::string& name) const { return uniform(name.c_str()); }
+
+    void setBool(Uniform uniform, bool value) const;
+    void setInt(Uniform uniform, int value) const;
+    void setFloat(Uniform uniform, float value) const;
+    void setVec3(Uniform uniform, const glm::vec3& value) const;
+    void setMat4(Uniform uniform, const glm::mat4& mat) const;
+
+    // By name: a hash lookup, no GL query. Literals don't build a std::string.
+    void setBool(const char* name, bool value) const { setBool(uniform(name), value); }
+    void setInt(const char* name, int value) const { setInt(uniform(name), value); }
+    void setFloat(const char* name, float value) const { setFloat(uniform(name), value); }
+    void setVec3(const char* name, const glm::vec3& value) const { setVec3(uniform(name), value); }
+    void setVec3(const char* name, float x, float y, float z) const { setVec3(uniform(name), glm::vec3(x, y, z)); }
+    void setMat4(const char* name, const glm::mat4& mat) const { setMat4(uniform(name), mat); }
+
+    void setBool(const std::string& name, bool value) const { setBool(name.c_str(), value); }
+    void setInt(const std::string& name, int value) const { setInt(name.c_str(), value); }
+    void setFloat(const std::string& name, float value) const { setFloat(name.c_str(), value); }
+    void setVec3(const std::string& name, const glm::vec3& value) const { setVec3(name.c_str(), value); }
+    void setVec3(const std::string& name, float x, float y, float z) const { setVec3(name.c_str(), x, y, z); }
+    void setMat4(const std::string& name, const glm::mat4& mat) const { setMat4(name.c_str(), mat); }
 
 private:
+    // Open-addressed, power-of-two sized; empty slots have an empty name
+    struct UniformSlot {
+        uint64_t hash = 0;
+        std::string name;
+        GLint location = -1;
+    };
+    std::vector<UniformSlot> uniformTable;
+
     // Helper function declaration
     void checkCompileErrors(unsigned int shader, std::string type);
+    void buildUniformTable();
+    void addUniform(const std::string& name, GLint location);
+    GLint findLocation(const char* name) const;
 };
 
 #endif
\ No newline at end of file
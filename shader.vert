@@ -2,19 +2,67 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec3 aNormal;
+layout (location = 3) in mat4 aInstanceModel;   // Locations 3-6, see InstanceBatch
+layout (location = 7) in vec4 aInstanceTint;
+layout (location = 8) in uint aMaterial;        // MaterialVertex only
 
 out vec3 FragPos;
 out vec3 Color;
 out vec3 Normal;
+flat out vec4 ColorOverride;    // a = 1: use rgb instead of Color
+out float ViewDepth;            // Distance along the view direction, for light clusters
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+uniform bool useColorOverride;
+uniform vec3 colorOverride;
+
+// Instanced draws take the model matrix and tint per instance instead
+uniform bool instanced;
+
+// Model meshes uploaded as PackedVertex: unorm16 position within the model
+// bounds, and location 1 holds an octahedral-encoded normal
+uniform bool packedVertex;
+uniform vec3 packedPositionMin;
+uniform vec3 packedPositionExtent;
+
+// Room, street and street light meshes uploaded as MaterialVertex: no
+// colour attribute, it comes from the bound MaterialTable instead
+uniform bool materialVertex;
+layout (std140, binding = 0) uniform MaterialBlock {
+    vec4 materialColors[64];
+};
+
+vec3 octahedralDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Color = aColor;
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    vec3 position = aPos;
+    vec3 color = aColor;
+    if (packedVertex) {
+        position = packedPositionMin + aPos * packedPositionExtent;
+        color = octahedralDecode(aColor.xy);
+    }
+    if (materialVertex) {
+        color = materialColors[aMaterial].rgb;
+    }
+
+    mat4 modelMatrix = instanced ? aInstanceModel : model;
+    ColorOverride = instanced ? aInstanceTint : vec4(colorOverride, useColorOverride ? 1.0 : 0.0);
+
+    FragPos = vec3(modelMatrix * vec4(position, 1.0));
+    Color = color;
+    Normal = mat3(transpose(inverse(modelMatrix))) * aNormal;
+    vec4 viewPosition = view * vec4(FragPos, 1.0);
+    ViewDepth = -viewPosition.z;
+    gl_Position = projection * viewPosition;
 }
\ No newline at end of file
@@ -1,8 +1,8 @@
 #include "skybox.h"
 #include <iostream>
 #include <vector>
-
-#include "stb_image.h" 
+#include <filesystem>
+#include <chrono>
 
 Skybox::Skybox() : skyboxVAO(0), skyboxVBO(0), cubemapTexture(0) {
 }
@@ -30,27 +30,30 @@ void Skybox::setup() {
 }
 
 bool Skybox::loadCubemap(const std::vector<std::string>& faces) {
+    // Decode all faces side by side on the pool, then upload in order
+    std::vector<DecodeFuture> decoded;
+    for (const auto& face : faces) {
+        decoded.push_back(TextureLoader::decode(face, false, false));
+    }
+
     glGenTextures(1, &cubemapTexture);
     glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
 
-    int width, height, nrChannels;
     for (unsigned int i = 0; i < faces.size(); i++) {
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
+        std::shared_ptr<const DecodedImage> data = decoded[i].get();
         if (data) {
             GLenum format = GL_RGB;
-            if (nrChannels == 4)
+            if (data->components == 4)
                 format = GL_RGBA;
-            else if (nrChannels == 1)
+            else if (data->components == 1)
                 format = GL_RED;
 
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
+                0, format, data->width, data->height, 0, format, GL_UNSIGNED_BYTE, data->getLevel(0));
             std::cout << "Loaded skybox face: " << faces[i] << std::endl;
         }
         else {
             std::cout << "Failed to load skybox face: " << faces[i] << std::endl;
-            stbi_image_free(data);
             return false;
         }
     }
@@ -104,6 +107,18 @@ bool Skybox::loadDefaultCubemap() {
 }
 
 void Skybox::draw(unsigned int shaderProgram, const glm::mat4& view, const glm::mat4& projection) {
+    // Swap in the cross-format image once the decode pool has it
+    if (pendingCross.valid() && pendingCross.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        std::shared_ptr<const DecodedImage> image = pendingCross.get();
+        pendingCross = DecodeFuture();
+        if (image) {
+            createCrossFormatCubemap(*image);
+        }
+        else {
+            std::cout << "Failed to decode cross-format skybox, keeping default gradient" << std::endl;
+        }
+    }
+
     // Draw skybox last (with depth test trick)
     glDepthFunc(GL_LEQUAL);  // Change depth function so depth test passes when values are equal
 
@@ -127,7 +142,7 @@ void Skybox::draw(unsigned int shaderProgram, const glm::mat4& view, const glm::
     glDepthFunc(GL_LESS);
 }
 
-bool Skybox::loadCrossFormat3x4(unsigned char* data, int width, int height, int nrChannels) {
+bool Skybox::loadCrossFormat3x4(const unsigned char* data, int width, int height, int nrChannels) {
     // 3x4 layout
     // +---+---+---+
     // |   | +Y |   |  row 0
@@ -143,7 +158,6 @@ bool Skybox::loadCrossFormat3x4(unsigned char* data, int width, int height, int
 
     if (faceSize * 4 != height) {
         std::cout << "Invalid 3x4 layout dimensions" << std::endl;
-        stbi_image_free(data);
         return false;
     }
 
@@ -174,8 +188,6 @@ bool Skybox::loadCrossFormat3x4(unsigned char* data, int width, int height, int
         delete[] faces[i];
     }
 
-    stbi_image_free(data);
-
     // Set texture parameters
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -192,7 +204,7 @@ bool Skybox::loadCrossFormat3x4(unsigned char* data, int width, int height, int
     return true;
 }
 
-bool Skybox::loadCrossFormat4x3(unsigned char* data, int width, int height, int nrChannels) {
+bool Skybox::loadCrossFormat4x3(const unsigned char* data, int width, int height, int nrChannels) {
     // 4x3 layout (horizontal cross)
     // +---+---+---+---+
     // |   | +Y |   |   |  row 0
@@ -206,7 +218,6 @@ bool Skybox::loadCrossFormat4x3(unsigned char* data, int width, int height, int
 
     if (faceSize * 4 != width) {
         std::cout << "Invalid 4x3 layout dimensions" << std::endl;
-        stbi_image_free(data);
         return false;
     }
 
@@ -237,8 +248,6 @@ bool Skybox::loadCrossFormat4x3(unsigned char* data, int width, int height, int
         delete[] faces[i];
     }
 
-    stbi_image_free(data);
-
     // Set texture parameters
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -255,7 +264,7 @@ bool Skybox::loadCrossFormat4x3(unsigned char* data, int width, int height, int
     return true;
 }
 
-unsigned char* Skybox::extractFace(unsigned char* data, int width, int height, int channels,
+unsigned char* Skybox::extractFace(const unsigned char* data, int width, int height, int channels,
     int faceSize, int gridX, int gridY) {
     unsigned char* faceData = new unsigned char[faceSize * faceSize * channels];
 
@@ -276,15 +285,24 @@ unsigned char* Skybox::extractFace(unsigned char* data, int width, int height, i
 }
 
 bool Skybox::loadCrossFormatCubemap(const std::string& imagePath) {
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(imagePath.c_str(), &width, &height, &nrChannels, 0);
-
-    if (!data) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(imagePath, ec)) {
         std::cout << "Failed to load cross-format skybox: " << imagePath << std::endl;
         return false;
     }
 
-    std::cout << "Loaded cross-format skybox: " << imagePath
+    // The face split needs the whole image, so no mips here - the cubemap makes its own
+    pendingCross = TextureLoader::decode(imagePath, false, false);
+    std::cout << "Decoding cross-format skybox: " << imagePath << std::endl;
+    return true;
+}
+
+bool Skybox::createCrossFormatCubemap(const DecodedImage& image) {
+    int width = image.width;
+    int height = image.height;
+    int nrChannels = image.components;
+
+    std::cout << "Loaded cross-format skybox: " << image.path
         << " (" << width << "x" << height << ", " << nrChannels << " channels)" << std::endl;
 
     // Cross format layout: (assuming 3x2 layout)
@@ -301,22 +319,29 @@ bool Skybox::loadCrossFormatCubemap(const std::string& imagePath) {
     // Each face should be (width/3) x (height/4) in 3x4 layout
     // OR (width/4) x (height/3) in 4x3 layout
 
+    // The gradient cubemap stays bound until the new one exists
+    unsigned int previous = cubemapTexture;
+    bool loaded = false;
+
     // Determine layout based on aspect ratio
     float aspect = (float)width / height;
 
     if (fabs(aspect - (3.0f / 4.0f)) < 0.1f) {
         // 3x4 layout (common for cross format)
-        return loadCrossFormat3x4(data, width, height, nrChannels);
+        loaded = loadCrossFormat3x4(image.getLevel(0), width, height, nrChannels);
     }
     else if (fabs(aspect - (4.0f / 3.0f)) < 0.1f) {
         // 4x3 layout
-        return loadCrossFormat4x3(data, width, height, nrChannels);
+        loaded = loadCrossFormat4x3(image.getLevel(0), width, height, nrChannels);
     }
     else {
         std::cout << "Unknown cubemap layout. Using default skybox." << std::endl;
-        stbi_image_free(data);
-        return loadDefaultCubemap();
     }
+
+    if (loaded && previous != 0) {
+        glDeleteTextures(1, &previous);
+    }
+    return loaded;
 }
 
 void Skybox::cleanup() {
@@ -7,14 +7,17 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <string>
+#include "texture_loader.h"
 
 class Skybox {
 private:
     unsigned int skyboxVAO, skyboxVBO;
     unsigned int cubemapTexture;
-    bool loadCrossFormat3x4(unsigned char* data, int width, int height, int nrChannels);
-    bool loadCrossFormat4x3(unsigned char* data, int width, int height, int nrChannels);
-    unsigned char* extractFace(unsigned char* data, int width, int height, int channels,
+    DecodeFuture pendingCross;  // Cross image still decoding; the gradient is shown until then
+    bool createCrossFormatCubemap(const DecodedImage& image);
+    bool loadCrossFormat3x4(const unsigned char* data, int width, int height, int nrChannels);
+    bool loadCrossFormat4x3(const unsigned char* data, int width, int height, int nrChannels);
+    unsigned char* extractFace(const unsigned char* data, int width, int height, int channels,
         int faceSize, int gridX, int gridY);
 
     // Skybox vertices
@@ -70,6 +73,8 @@ public:
     // Load cubemap texture
     bool loadCubemap(const std::vector<std::string>& faces);
     bool loadDefaultCubemap(); // Load a simple gradient skybox
+    // Decodes on the TextureLoader pool and swaps the cubemap in from draw().
+    // Returns false if the file does not exist.
     bool loadCrossFormatCubemap(const std::string& imagePath);
 
     // Setup and rendering
@@ -1,11 +1,18 @@
 // street.cpp
 #include "street.h"
+#include "frustum_culler.h"
+#include "scene.h"
 #include <iostream>
 #include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
 
 // Street class implementation
 Street::Street(const glm::vec3& pos, const glm::vec3& dim, const glm::vec3& col)
-    : position(pos), size(dim), color(col), VAO(0), VBO(0), EBO(0) {
+    : position(pos), size(dim), color(col), mesh(1) {
+    materials.setColor(STREET_ASPHALT, col);
+    materials.setColor(STREET_CURB, glm::vec3(0.7f, 0.7f, 0.7f));
+    materials.setColor(STREET_LINE, glm::vec3(1.0f, 1.0f, 1.0f));
+    materials.setColor(STREET_SIDEWALK, glm::vec3(0.8f, 0.8f, 0.8f));
     generateVertices();
     setup();
 }
@@ -15,28 +22,24 @@ Street::~Street() {
 }
 
 void Street::generateVertices() {
-    vertices.clear();
-    indices.clear();
+    mesh.clear(0);
 
     float halfWidth = size.x / 2.0f;
     float halfLength = size.z / 2.0f;
     float thickness = size.y;
 
     // Street main surface (asphalt)
-    glm::vec3 asphaltColor = color;
-
     // Top surface
     addQuad(
         glm::vec3(-halfWidth, thickness, -halfLength),
         glm::vec3(halfWidth, thickness, -halfLength),
         glm::vec3(halfWidth, thickness, halfLength),
         glm::vec3(-halfWidth, thickness, halfLength),
-        asphaltColor,
+        STREET_ASPHALT,
         glm::vec3(0.0f, 1.0f, 0.0f)
     );
 
     // Side edges (curbs)
-    glm::vec3 curbColor = glm::vec3(0.7f, 0.7f, 0.7f);
     float curbHeight = thickness + 0.1f;
     float curbWidth = 0.3f;
 
@@ -46,7 +49,7 @@ void Street::generateVertices() {
         glm::vec3(-halfWidth, thickness, -halfLength),
         glm::vec3(-halfWidth, curbHeight, -halfLength),
         glm::vec3(-halfWidth - curbWidth, curbHeight, -halfLength),
-        curbColor,
+        STREET_CURB,
         glm::vec3(0.0f, 0.0f, 1.0f)
     );
 
@@ -55,7 +58,7 @@ void Street::generateVertices() {
         glm::vec3(-halfWidth, thickness, halfLength),
         glm::vec3(-halfWidth, curbHeight, halfLength),
         glm::vec3(-halfWidth - curbWidth, curbHeight, halfLength),
-        curbColor,
+        STREET_CURB,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
@@ -64,7 +67,7 @@ void Street::generateVertices() {
         glm::vec3(-halfWidth - curbWidth, thickness, halfLength),
         glm::vec3(-halfWidth - curbWidth, curbHeight, halfLength),
         glm::vec3(-halfWidth - curbWidth, curbHeight, -halfLength),
-        curbColor,
+        STREET_CURB,
         glm::vec3(1.0f, 0.0f, 0.0f)
     );
 
@@ -74,7 +77,7 @@ void Street::generateVertices() {
         glm::vec3(halfWidth + curbWidth, thickness, -halfLength),
         glm::vec3(halfWidth + curbWidth, curbHeight, -halfLength),
         glm::vec3(halfWidth, curbHeight, -halfLength),
-        curbColor,
+        STREET_CURB,
         glm::vec3(0.0f, 0.0f, 1.0f)
     );
 
@@ -83,7 +86,7 @@ void Street::generateVertices() {
         glm::vec3(halfWidth + curbWidth, thickness, halfLength),
         glm::vec3(halfWidth + curbWidth, curbHeight, halfLength),
         glm::vec3(halfWidth, curbHeight, halfLength),
-        curbColor,
+        STREET_CURB,
         glm::vec3(0.0f, 0.0f, -1.0f)
     );
 
@@ -92,12 +95,11 @@ void Street::generateVertices() {
         glm::vec3(halfWidth + curbWidth, thickness, halfLength),
         glm::vec3(halfWidth + curbWidth, curbHeight, halfLength),
         glm::vec3(halfWidth + curbWidth, curbHeight, -halfLength),
-        curbColor,
+        STREET_CURB,
         glm::vec3(-1.0f, 0.0f, 0.0f)
     );
 
     // Road markings (lane dividers)
-    glm::vec3 lineColor = glm::vec3(1.0f, 1.0f, 1.0f);
     float lineThickness = 0.02f;
     float lineLength = 2.0f;
     float lineGap = 3.0f;
@@ -113,13 +115,12 @@ void Street::generateVertices() {
             glm::vec3(0.05f, lineHeight, zPos),
             glm::vec3(0.05f, lineHeight, zPos + lineLength),
             glm::vec3(-0.05f, lineHeight, zPos + lineLength),
-            lineColor,
+            STREET_LINE,
             glm::vec3(0.0f, 1.0f, 0.0f)
         );
     }
 
     // Sidewalk
-    glm::vec3 sidewalkColor = glm::vec3(0.8f, 0.8f, 0.8f);
     float sidewalkWidth = 2.0f;
     float sidewalkHeight = curbHeight + 0.05f;
 
@@ -129,7 +130,7 @@ void Street::generateVertices() {
         glm::vec3(-halfWidth - curbWidth, sidewalkHeight, -halfLength),
         glm::vec3(-halfWidth - curbWidth, sidewalkHeight, halfLength),
         glm::vec3(-halfWidth - curbWidth - sidewalkWidth, sidewalkHeight, halfLength),
-        sidewalkColor,
+        STREET_SIDEWALK,
         glm::vec3(0.0f, 1.0f, 0.0f)
     );
 
@@ -139,41 +140,23 @@ void Street::generateVertices() {
         glm::vec3(halfWidth + curbWidth + sidewalkWidth, sidewalkHeight, -halfLength),
         glm::vec3(halfWidth + curbWidth + sidewalkWidth, sidewalkHeight, halfLength),
         glm::vec3(halfWidth + curbWidth, sidewalkHeight, halfLength),
-        sidewalkColor,
+        STREET_SIDEWALK,
         glm::vec3(0.0f, 1.0f, 0.0f)
     );
 }
 
 void Street::addQuad(const glm::vec3& p1, const glm::vec3& p2,
     const glm::vec3& p3, const glm::vec3& p4,
-    const glm::vec3& color, const glm::vec3& normal) {
-    size_t baseIndex = vertices.size() / 9;
+    int material, const glm::vec3& normal) {
+    std::vector<MaterialVertex>& vertices = mesh.getVertices(0);
+    std::vector<unsigned int>& indices = mesh.getIndices(0);
+    size_t baseIndex = vertices.size();
 
     // Apply position offset
-    glm::vec3 pos1 = position + p1;
-    glm::vec3 pos2 = position + p2;
-    glm::vec3 pos3 = position + p3;
-    glm::vec3 pos4 = position + p4;
-
-    // Vertex 1
-    vertices.push_back(pos1.x); vertices.push_back(pos1.y); vertices.push_back(pos1.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
-
-    // Vertex 2
-    vertices.push_back(pos2.x); vertices.push_back(pos2.y); vertices.push_back(pos2.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
-
-    // Vertex 3
-    vertices.push_back(pos3.x); vertices.push_back(pos3.y); vertices.push_back(pos3.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
-
-    // Vertex 4
-    vertices.push_back(pos4.x); vertices.push_back(pos4.y); vertices.push_back(pos4.z);
-    vertices.push_back(color.r); vertices.push_back(color.g); vertices.push_back(color.b);
-    vertices.push_back(normal.x); vertices.push_back(normal.y); vertices.push_back(normal.z);
+    vertices.emplace_back(position + p1, normal, material);
+    vertices.emplace_back(position + p2, normal, material);
+    vertices.emplace_back(position + p3, normal, material);
+    vertices.emplace_back(position + p4, normal, material);
 
     // Add indices for two triangles
     indices.push_back(static_cast<unsigned int>(baseIndex));
@@ -185,69 +168,53 @@ void Street::addQuad(const glm::vec3& p1, const glm::vec3& p2,
 }
 
 void Street::setup() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
+    materials.setup();
     updateBuffers();
 }
 
+// Only what generateVertices() rebuilt since the last call is uploaded
 void Street::updateBuffers() {
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
+    mesh.upload();
 }
 
-void Street::draw() {
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+void Street::draw(Shader& shader) {
+    shader.setBool("materialVertex", true);
+    materials.bind();
+    mesh.draw();
+    shader.setBool("materialVertex", false);
 }
 
 void Street::cleanup() {
-    if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
-        VAO = VBO = EBO = 0;
-    }
+    mesh.cleanup();
+    materials.cleanup();
 }
 
 // StreetLight class implementation
 StreetLight::StreetLight(const glm::vec3& pos, float h)
-    : position(pos), height(h), VAO(0), VBO(0), EBO(0) {
+    : position(pos), height(h) {
+}
+
+glm::mat4 StreetLight::getModelMatrix(float meshHeight) const {
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    return glm::scale(model, glm::vec3(1.0f, height / meshHeight, 1.0f));
+}
+
+StreetLightMesh::StreetLightMesh(float h)
+    : VAO(0), VBO(0), EBO(0), height(h) {
+    materials.setColor(LIGHT_POLE, glm::vec3(0.4f, 0.4f, 0.45f));
+    materials.setColor(LIGHT_LAMP, glm::vec3(0.9f, 0.9f, 0.7f));
     createModel();
     setup();
 }
 
-StreetLight::~StreetLight() {
-    if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
-    }
+StreetLightMesh::~StreetLightMesh() {
+    cleanup();
 }
 
-void StreetLight::createModel() {
+void StreetLightMesh::createModel() {
     vertices.clear();
     indices.clear();
 
-    glm::vec3 poleColor = glm::vec3(0.4f, 0.4f, 0.45f);
-    glm::vec3 lightColor = glm::vec3(0.9f, 0.9f, 0.7f);
-
     // Create pole (cylinder)
     float poleRadius = 0.1f;
     int segments = 8;
@@ -264,12 +231,12 @@ void StreetLight::createModel() {
         glm::vec3 normal = glm::normalize(glm::vec3(cos(angle1), 0.0f, sin(angle1)));
 
         // Add quad for pole segment
-        size_t base = vertices.size() / 9;
+        size_t base = vertices.size();
         vertices.insert(vertices.end(), {
-            p1.x, p1.y, p1.z, poleColor.r, poleColor.g, poleColor.b, normal.x, normal.y, normal.z,
-            p2.x, p2.y, p2.z, poleColor.r, poleColor.g, poleColor.b, normal.x, normal.y, normal.z,
-            p3.x, p3.y, p3.z, poleColor.r, poleColor.g, poleColor.b, normal.x, normal.y, normal.z,
-            p4.x, p4.y, p4.z, poleColor.r, poleColor.g, poleColor.b, normal.x, normal.y, normal.z
+            MaterialVertex(p1, normal, LIGHT_POLE),
+            MaterialVertex(p2, normal, LIGHT_POLE),
+            MaterialVertex(p3, normal, LIGHT_POLE),
+            MaterialVertex(p4, normal, LIGHT_POLE)
             });
 
         indices.push_back(static_cast<unsigned int>(base));
@@ -285,12 +252,13 @@ void StreetLight::createModel() {
     float lightY = height * 0.7f;
 
     // Light housing bottom
-    size_t base = vertices.size() / 9;
+    size_t base = vertices.size();
+    glm::vec3 down(0.0f, -1.0f, 0.0f);
     vertices.insert(vertices.end(), {
-        -lightSize, lightY, -lightSize, poleColor.r, poleColor.g, poleColor.b, 0.0f, -1.0f, 0.0f,
-         lightSize, lightY, -lightSize, poleColor.r, poleColor.g, poleColor.b, 0.0f, -1.0f, 0.0f,
-         lightSize, lightY,  lightSize, poleColor.r, poleColor.g, poleColor.b, 0.0f, -1.0f, 0.0f,
-        -lightSize, lightY,  lightSize, poleColor.r, poleColor.g, poleColor.b, 0.0f, -1.0f, 0.0f
+        MaterialVertex(glm::vec3(-lightSize, lightY, -lightSize), down, LIGHT_POLE),
+        MaterialVertex(glm::vec3(lightSize, lightY, -lightSize), down, LIGHT_POLE),
+        MaterialVertex(glm::vec3(lightSize, lightY, lightSize), down, LIGHT_POLE),
+        MaterialVertex(glm::vec3(-lightSize, lightY, lightSize), down, LIGHT_POLE)
         });
 
     indices.push_back(static_cast<unsigned int>(base));
@@ -300,13 +268,14 @@ void StreetLight::createModel() {
     indices.push_back(static_cast<unsigned int>(base + 2));
     indices.push_back(static_cast<unsigned int>(base + 3));
 
-    // Light housing sides
-    base = vertices.size() / 9;
+    // Light housing sides: pole colour at the bottom, lamp colour at the top
+    base = vertices.size();
+    glm::vec3 front(0.0f, 0.0f, -1.0f);
     vertices.insert(vertices.end(), {
-        -lightSize, lightY, -lightSize, poleColor.r, poleColor.g, poleColor.b, 0.0f, 0.0f, -1.0f,
-         lightSize, lightY, -lightSize, poleColor.r, poleColor.g, poleColor.b, 0.0f, 0.0f, -1.0f,
-         lightSize, lightY + lightSize * 0.5f, -lightSize, lightColor.r, lightColor.g, lightColor.b, 0.0f, 0.0f, -1.0f,
-        -lightSize, lightY + lightSize * 0.5f, -lightSize, lightColor.r, lightColor.g, lightColor.b, 0.0f, 0.0f, -1.0f
+        MaterialVertex(glm::vec3(-lightSize, lightY, -lightSize), front, LIGHT_POLE),
+        MaterialVertex(glm::vec3(lightSize, lightY, -lightSize), front, LIGHT_POLE),
+        MaterialVertex(glm::vec3(lightSize, lightY + lightSize * 0.5f, -lightSize), front, LIGHT_LAMP),
+        MaterialVertex(glm::vec3(-lightSize, lightY + lightSize * 0.5f, -lightSize), front, LIGHT_LAMP)
         });
 
     indices.push_back(static_cast<unsigned int>(base));
@@ -315,31 +284,96 @@ void StreetLight::createModel() {
     indices.push_back(static_cast<unsigned int>(base));
     indices.push_back(static_cast<unsigned int>(base + 2));
     indices.push_back(static_cast<unsigned int>(base + 3));
+
+    glm::vec3 boundsMin(FLT_MAX);
+    glm::vec3 boundsMax(-FLT_MAX);
+    for (const auto& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    localBounds = BoundingBox(boundsMin, boundsMax);
 }
 
-void StreetLight::setup() {
+void StreetLightMesh::setup() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(MaterialVertex), vertices.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    MaterialVertex::bindAttributes();
 
     glBindVertexArray(0);
+
+    materials.setup();
+}
+
+void StreetLightMesh::cleanup() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+    instances.cleanup();
+    materials.cleanup();
+
+    for (int proxy : proxies) {
+        Scene::remove(proxy);
+    }
+    proxies.clear();
+    placed.clear();
+}
+
+void StreetLightMesh::update(const std::vector<StreetLight*>& lights) {
+    // Scene boxes only need redoing for lights that moved
+    for (size_t i = lights.size(); i < proxies.size(); i++) {
+        Scene::remove(proxies[i]);
+    }
+    placed.resize(lights.size(), glm::mat4(0.0f));
+    proxies.resize(lights.size(), -1);
+    for (size_t i = 0; i < lights.size(); i++) {
+        glm::mat4 transform = lights[i]->getModelMatrix(height);
+        if (proxies[i] < 0) {
+            proxies[i] = Scene::add(localBounds.transformed(transform), SCENE_STREET_LIGHT, lights[i]);
+            placed[i] = transform;
+        }
+        else if (transform != placed[i]) {
+            Scene::move(proxies[i], localBounds.transformed(transform));
+            placed[i] = transform;
+        }
+    }
+
+    std::vector<InstanceData> data;
+    data.reserve(lights.size());
+    for (size_t i = 0; i < lights.size(); i++) {
+        if (FrustumCuller::isVisible(proxies[i])) {
+            // Tint alpha 0: keep the pole and lamp vertex colours
+            data.push_back({ placed[i], glm::vec4(0.0f) });
+        }
+    }
+
+    unsigned int previous = instances.getBuffer();
+    if (instances.update(data) && instances.getBuffer() != previous) {
+        glBindVertexArray(VAO);
+        InstanceBatch::bindAttributes(instances.getBuffer());
+        glBindVertexArray(0);
+    }
 }
 
-void StreetLight::draw() {
+void StreetLightMesh::draw(Shader& shader) {
+    if (instances.getCount() == 0) {
+        return;
+    }
+    shader.setBool("materialVertex", true);
+    materials.bind();
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0,
+        static_cast<GLsizei>(instances.getCount()));
     glBindVertexArray(0);
+    shader.setBool("materialVertex", false);
 }
\ No newline at end of file
@@ -5,16 +5,22 @@
 #include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "instance_batch.h"
+#include "bounding_box.h"
+#include "material_table.h"
+#include "sectioned_mesh.h"
+#include "shader.h"
 
 class Street {
 private:
-    GLuint VAO, VBO, EBO;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
     glm::vec3 position;
     glm::vec3 size;
     glm::vec3 color;
 
+    enum StreetMaterial { STREET_ASPHALT, STREET_CURB, STREET_LINE, STREET_SIDEWALK };
+    MaterialTable materials;
+    SectionedMesh mesh;            // A single section: the street is built in one go
+
 public:
     Street(const glm::vec3& pos, const glm::vec3& dim, const glm::vec3& col = glm::vec3(0.3f, 0.3f, 0.35f));
     ~Street();
@@ -22,10 +28,10 @@ public:
     void generateVertices();
     void addQuad(const glm::vec3& p1, const glm::vec3& p2,
         const glm::vec3& p3, const glm::vec3& p4,
-        const glm::vec3& color, const glm::vec3& normal);
+        int material, const glm::vec3& normal);
     void setup();
     void updateBuffers();
-    void draw();
+    void draw(Shader& shader);
     void cleanup();
 
     glm::vec3 getPosition() const { return position; }
@@ -34,21 +40,48 @@ public:
 
 class StreetLight {
 private:
-    GLuint VAO, VBO, EBO;
     glm::vec3 position;
     float height;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
 
 public:
     StreetLight(const glm::vec3& pos, float h = 6.0f);
-    ~StreetLight();
+
+    glm::vec3 getPosition() const { return position; }
+    float getHeight() const { return height; }
+    glm::mat4 getModelMatrix(float meshHeight) const;
+};
+
+// Lamp post geometry shared by every StreetLight, drawn for all of them with
+// one glDrawElementsInstanced. Posts of another height are stretched to it.
+class StreetLightMesh {
+private:
+    GLuint VAO, VBO, EBO;
+    float height;
+    std::vector<MaterialVertex> vertices;
+    std::vector<unsigned int> indices;
+    InstanceBatch instances;
+
+    enum StreetLightMaterial { LIGHT_POLE, LIGHT_LAMP };
+    MaterialTable materials;
+    BoundingBox localBounds;
+
+    // Per light: the transform its Scene proxy was placed with
+    std::vector<glm::mat4> placed;
+    std::vector<int> proxies;
+
+public:
+    StreetLightMesh(float h = 6.0f);
+    ~StreetLightMesh();
 
     void createModel();
     void setup();
-    void draw();
+    void cleanup();
 
-    glm::vec3 getPosition() const { return position; }
+    // Keeps the lights inside the view frustum. Re-uploads the instance buffer
+    // only if that set changed or one of them moved.
+    void update(const std::vector<StreetLight*>& lights);
+    // Every light in one call; set the shader's "instanced" uniform first
+    void draw(Shader& shader);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "texture_cache.h"
+#include "model.h"
+#include "texture_loader.h"
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+    const char* DEFAULT_TEXTURE_KEY = "<default>";
+
+    std::mutex cacheMutex;
+    std::mutex releaseMutex;    // Separate, so a handle can die while cacheMutex is held
+    std::unordered_map<std::string, std::weak_ptr<TextureHandle>> byPath;
+    std::unordered_map<uint64_t, std::weak_ptr<TextureHandle>> byContent;
+    std::vector<unsigned int> releasedIds;
+
+    unsigned int requests = 0;
+    unsigned int uploads = 0;
+    unsigned int pathHits = 0;
+    unsigned int contentHits = 0;
+    size_t bytesUploaded = 0;
+    size_t bytesSaved = 0;
+
+    // Base level plus a full mip chain is 4/3 of the base level
+    size_t textureBytes(int width, int height, int components) {
+        return size_t(width) * size_t(height) * size_t(components) * 4 / 3;
+    }
+}
+
+TextureHandle::TextureHandle(unsigned int id, size_t bytes) : id(id), bytes(bytes) {
+}
+
+TextureHandle::~TextureHandle() {
+    // May run on a loader thread, so only queue the id for the GL thread
+    TextureCache::release(id);
+}
+
+void TextureCache::release(unsigned int id) {
+    std::lock_guard<std::mutex> lock(releaseMutex);
+    releasedIds.push_back(id);
+}
+
+void TextureCache::deleteReleased() {
+    std::vector<unsigned int> ids;
+    {
+        std::lock_guard<std::mutex> lock(releaseMutex);
+        ids.swap(releasedIds);
+    }
+    if (!ids.empty()) {
+        glDeleteTextures(static_cast<GLsizei>(ids.size()), ids.data());
+    }
+}
+
+uint64_t TextureCache::hashPixels(const unsigned char* data, size_t size, int width, int height, unsigned int format) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const unsigned char* bytes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    unsigned int dimensions[3] = { static_cast<unsigned int>(width), static_cast<unsigned int>(height), format };
+    mix(reinterpret_cast<const unsigned char*>(dimensions), sizeof(dimensions));
+    mix(data, size);
+    return hash;
+}
+
+std::shared_ptr<TextureHandle> TextureCache::findByPath(const std::string& resolvedPath) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = byPath.find(resolvedPath);
+    return (it != byPath.end()) ? it->second.lock() : nullptr;
+}
+
+std::shared_ptr<TextureHandle> TextureCache::acquire(const TextureImage& image) {
+    std::string pathKey = (image.pixels || image.cached) ? image.resolvedPath : DEFAULT_TEXTURE_KEY;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    requests++;
+
+    // 1. Same file already on the GPU (possibly found by the loader thread)
+    std::shared_ptr<TextureHandle> existing = image.cached;
+    if (!existing) {
+        auto it = byPath.find(pathKey);
+        if (it != byPath.end()) {
+            existing = it->second.lock();
+        }
+    }
+    if (existing) {
+        pathHits++;
+        bytesSaved += existing->getBytes();
+        return existing;
+    }
+
+    // 2. Different file, identical pixels
+    if (image.pixels) {
+        auto it = byContent.find(image.pixels->contentHash);
+        if (it != byContent.end()) {
+            existing = it->second.lock();
+        }
+        if (existing) {
+            contentHits++;
+            bytesSaved += existing->getBytes();
+            byPath[pathKey] = existing;
+            return existing;
+        }
+    }
+
+    // 3. New texture
+    uploads++;
+    size_t bytes = image.pixels ? image.pixels->data.size() : textureBytes(2, 2, 4);
+    bytesUploaded += bytes;
+
+    std::shared_ptr<TextureHandle> handle = std::make_shared<TextureHandle>(upload(image), bytes);
+    byPath[pathKey] = handle;
+    if (image.pixels) {
+        byContent[image.pixels->contentHash] = handle;
+    }
+    return handle;
+}
+
+unsigned int TextureCache::upload(const TextureImage& image) {
+    if (!image.pixels) {
+        // Create a default checkerboard texture
+        return createDefaultTexture();
+    }
+
+    // Mips were built by the decode pool; this only stages and issues the copies
+    return TextureLoader::upload(*image.pixels);
+}
+
+// Create a default texture if none found
+unsigned int TextureCache::createDefaultTexture() {
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    // Create 2x2 checkerboard pattern
+    unsigned char data[] = {
+        255, 0, 0, 255,     0, 255, 0, 255,
+        0, 255, 0, 255,     255, 0, 0, 255
+    };
+
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    return textureID;
+}
+
+void TextureCache::printStats() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    // Several paths can share one handle, so count distinct textures
+    std::unordered_set<const TextureHandle*> live;
+    for (const auto& entry : byPath) {
+        if (std::shared_ptr<TextureHandle> handle = entry.second.lock()) {
+            live.insert(handle.get());
+        }
+    }
+
+    std::cout << "\n=== TEXTURE CACHE ===" << std::endl;
+    std::cout << "Texture requests: " << requests << ", uploaded: " << uploads
+        << " (" << bytesUploaded / 1024 << " KB)" << std::endl;
+    std::cout << "Reused by path: " << pathHits << ", by content: " << contentHits << std::endl;
+    std::cout << "Bytes saved: " << bytesSaved / 1024 << " KB" << std::endl;
+    std::cout << "Textures alive: " << live.size() << std::endl;
+}
\ No newline at end of file
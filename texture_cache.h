@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct TextureImage;
+
+// One GL texture, shared by every mesh (in any model) that uses the same image.
+// The GL texture is released when the last handle goes away.
+class TextureHandle {
+public:
+    TextureHandle(unsigned int id, size_t bytes);
+    ~TextureHandle();
+
+    TextureHandle(const TextureHandle&) = delete;
+    TextureHandle& operator=(const TextureHandle&) = delete;
+
+    unsigned int getId() const { return id; }
+    size_t getBytes() const { return bytes; }
+
+private:
+    unsigned int id;
+    size_t bytes;  // Estimated VRAM including mipmaps
+};
+
+// Process-wide texture registry.
+// Textures are looked up first by resolved file path, then by a hash of the
+// decoded pixels, so the same image is only uploaded once even when it is
+// referenced through different paths or copied into several skin folders.
+class TextureCache {
+public:
+    // Any thread: live texture for this resolved path, so the caller can skip decoding
+    static std::shared_ptr<TextureHandle> findByPath(const std::string& resolvedPath);
+
+    // GL thread: shared texture for a decoded image, uploading it only if no
+    // identical texture exists yet. Images without pixels get the default texture.
+    static std::shared_ptr<TextureHandle> acquire(const TextureImage& image);
+
+    // GL thread: deletes textures whose last handle was dropped (possibly on a loader thread)
+    static void deleteReleased();
+
+    // FNV-1a over the pixel data (size bytes) and its dimensions. format is the
+    // component count for raw images or the GL format for compressed ones.
+    static uint64_t hashPixels(const unsigned char* data, size_t size, int width, int height, unsigned int format);
+
+    static void printStats();
+
+private:
+    friend class TextureHandle;
+    static void release(unsigned int id);
+    static unsigned int upload(const TextureImage& image);
+    static unsigned int createDefaultTexture();
+};
\ No newline at end of file
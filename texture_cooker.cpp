@@ -0,0 +1,506 @@
+#include "texture_cooker.h"
+#include "texture_cache.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include "stb_image.h"
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace {
+    const unsigned char KTX2_IDENTIFIER[12] = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+
+    // VkFormat values stored in the KTX2 header
+    const uint32_t VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131;
+    const uint32_t VK_FORMAT_BC3_UNORM_BLOCK = 137;
+
+    const size_t KTX2_HEADER_SIZE = 80;
+    const size_t KTX2_LEVEL_ENTRY_SIZE = 24;
+
+    size_t blockBytesFor(unsigned int format) {
+        return format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ? 16 : 8;
+    }
+
+    size_t levelBytes(int width, int height, size_t blockBytes) {
+        return size_t((width + 3) / 4) * size_t((height + 3) / 4) * blockBytes;
+    }
+
+    void put32(std::vector<unsigned char>& out, size_t offset, uint32_t value) {
+        std::memcpy(out.data() + offset, &value, sizeof(value));
+    }
+
+    void put64(std::vector<unsigned char>& out, size_t offset, uint64_t value) {
+        std::memcpy(out.data() + offset, &value, sizeof(value));
+    }
+
+    uint32_t get32(const std::vector<unsigned char>& in, size_t offset) {
+        uint32_t value;
+        std::memcpy(&value, in.data() + offset, sizeof(value));
+        return value;
+    }
+
+    uint64_t get64(const std::vector<unsigned char>& in, size_t offset) {
+        uint64_t value;
+        std::memcpy(&value, in.data() + offset, sizeof(value));
+        return value;
+    }
+
+    uint16_t packColor565(const float* rgb) {
+        int r = static_cast<int>(std::lround(std::min(std::max(rgb[0], 0.0f), 255.0f) * 31.0f / 255.0f));
+        int g = static_cast<int>(std::lround(std::min(std::max(rgb[1], 0.0f), 255.0f) * 63.0f / 255.0f));
+        int b = static_cast<int>(std::lround(std::min(std::max(rgb[2], 0.0f), 255.0f) * 31.0f / 255.0f));
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void unpackColor565(uint16_t color, int* rgb) {
+        int r = (color >> 11) & 31;
+        int g = (color >> 5) & 63;
+        int b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    bool isFresh(const std::string& cachePath, const std::string& sourcePath, const std::string& maskPath) {
+        std::error_code ec;
+        auto cacheTime = std::filesystem::last_write_time(cachePath, ec);
+        if (ec) return false;
+
+        auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+        if (ec || sourceTime > cacheTime) return false;
+
+        if (!maskPath.empty()) {
+            auto maskTime = std::filesystem::last_write_time(maskPath, ec);
+            if (ec || maskTime > cacheTime) return false;
+        }
+        return true;
+    }
+}
+
+std::string TextureCooker::cachePathFor(const std::string& sourcePath) {
+    return sourcePath + ".ktx2";
+}
+
+std::string TextureCooker::alphaMaskPathFor(const std::string& sourcePath) {
+    std::filesystem::path source(sourcePath);
+    std::string stem = source.stem().string();
+
+    // The mask itself has no mask
+    if (stem.size() >= 2 && stem[stem.size() - 2] == '-' && (stem.back() == 'a' || stem.back() == 'A')) {
+        return std::string();
+    }
+
+    for (const char* suffix : { "-a", "-A" }) {
+        std::filesystem::path mask = source.parent_path() / (stem + suffix + source.extension().string());
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(mask, ec)) {
+            return mask.generic_string();
+        }
+    }
+    return std::string();
+}
+
+std::shared_ptr<const DecodedImage> TextureCooker::loadOrCook(const std::string& sourcePath) {
+    std::string cachePath = cachePathFor(sourcePath);
+    std::string maskPath = alphaMaskPathFor(sourcePath);
+
+    if (isFresh(cachePath, sourcePath, maskPath)) {
+        std::shared_ptr<DecodedImage> cached = readKtx2(cachePath);
+        if (cached) {
+            cached->path = sourcePath;
+            return cached;
+        }
+        std::cout << "Ignoring unreadable texture cache: " << cachePath << std::endl;
+    }
+
+    std::shared_ptr<DecodedImage> cooked = cook(sourcePath, maskPath);
+    if (!cooked) {
+        return nullptr;
+    }
+
+    if (writeKtx2(cachePath, *cooked)) {
+        std::cout << "Cooked texture: " << cachePath
+            << (maskPath.empty() ? "" : " (with alpha mask)")
+            << " - " << cooked->data.size() / 1024 << " KB with mips" << std::endl;
+    }
+    return cooked;
+}
+
+std::shared_ptr<DecodedImage> TextureCooker::cook(const std::string& sourcePath, const std::string& maskPath) {
+    stbi_set_flip_vertically_on_load_thread(0);
+
+    int width, height, components;
+    unsigned char* pixels = stbi_load(sourcePath.c_str(), &width, &height, &components, 4);
+    if (!pixels) {
+        return nullptr;
+    }
+
+    DecodedImage rgba;
+    rgba.width = width;
+    rgba.height = height;
+    rgba.components = 4;
+    rgba.levelOffsets.push_back(0);
+    rgba.data.assign(pixels, pixels + size_t(width) * size_t(height) * 4);
+    stbi_image_free(pixels);
+
+    // Blocks must tile level 0 exactly for glCompressedTexSubImage2D
+    if (width % 4 != 0 || height % 4 != 0) {
+        return nullptr;
+    }
+
+    bool hasAlpha = false;
+    if (components == 2 || components == 4) {
+        for (size_t i = 3; i < rgba.data.size(); i += 4) {
+            if (rgba.data[i] != 255) {
+                hasAlpha = true;
+                break;
+            }
+        }
+    }
+
+    if (!maskPath.empty()) {
+        int maskWidth, maskHeight, maskComponents;
+        unsigned char* mask = stbi_load(maskPath.c_str(), &maskWidth, &maskHeight, &maskComponents, 1);
+        if (mask && maskWidth == width && maskHeight == height) {
+            for (size_t i = 0; i < size_t(width) * size_t(height); i++) {
+                rgba.data[i * 4 + 3] = mask[i];
+            }
+            hasAlpha = true;
+        }
+        else {
+            std::cout << "Alpha mask does not match its image, ignoring: " << maskPath << std::endl;
+        }
+        if (mask) stbi_image_free(mask);
+    }
+
+    TextureLoader::buildMipChain(rgba);
+
+    std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+    image->path = sourcePath;
+    image->width = width;
+    image->height = height;
+    image->components = hasAlpha ? 4 : 3;
+    image->compressedFormat = hasAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    size_t blockBytes = blockBytesFor(image->compressedFormat);
+    size_t total = 0;
+    for (int level = 0; level < rgba.getLevelCount(); level++) {
+        image->levelOffsets.push_back(total);
+        total += levelBytes(rgba.getLevelWidth(level), rgba.getLevelHeight(level), blockBytes);
+    }
+    image->data.resize(total);
+
+    for (int level = 0; level < rgba.getLevelCount(); level++) {
+        const unsigned char* src = rgba.getLevel(level);
+        unsigned char* dst = image->data.data() + image->levelOffsets[level];
+        int levelWidth = rgba.getLevelWidth(level);
+        int levelHeight = rgba.getLevelHeight(level);
+
+        for (int by = 0; by < (levelHeight + 3) / 4; by++) {
+            for (int bx = 0; bx < (levelWidth + 3) / 4; bx++) {
+                // Gather the block, repeating the edge texels of levels smaller than 4x4
+                unsigned char texels[64];
+                for (int y = 0; y < 4; y++) {
+                    int sy = std::min(by * 4 + y, levelHeight - 1);
+                    for (int x = 0; x < 4; x++) {
+                        int sx = std::min(bx * 4 + x, levelWidth - 1);
+                        std::memcpy(texels + (y * 4 + x) * 4, src + (size_t(sy) * levelWidth + sx) * 4, 4);
+                    }
+                }
+
+                if (hasAlpha) {
+                    encodeAlphaBlock(texels, dst);
+                    encodeColorBlock(texels, dst + 8);
+                    dst += 16;
+                }
+                else {
+                    encodeColorBlock(texels, dst);
+                    dst += 8;
+                }
+            }
+        }
+    }
+
+    image->contentHash = TextureCache::hashPixels(image->getLevel(0), image->getLevelSize(0),
+        width, height, image->compressedFormat);
+    return image;
+}
+
+void TextureCooker::encodeColorBlock(const unsigned char* texels, unsigned char* out) {
+    // Endpoints from the extent of the block along its principal axis
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            mean[c] += texels[i * 4 + c] / 16.0f;
+        }
+    }
+
+    float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; i++) {
+        float r = texels[i * 4 + 0] - mean[0];
+        float g = texels[i * 4 + 1] - mean[1];
+        float b = texels[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::sqrt(x * x + y * y + z * z);
+        if (length < 1e-6f) break;
+        axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+    }
+
+    float minT = 0.0f, maxT = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float t = (texels[i * 4 + 0] - mean[0]) * axis[0] +
+            (texels[i * 4 + 1] - mean[1]) * axis[1] +
+            (texels[i * 4 + 2] - mean[2]) * axis[2];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    float high[3], low[3];
+    for (int c = 0; c < 3; c++) {
+        high[c] = mean[c] + axis[c] * maxT;
+        low[c] = mean[c] + axis[c] * minT;
+    }
+
+    uint16_t color0 = packColor565(high);
+    uint16_t color1 = packColor565(low);
+    // color0 > color1 selects the opaque four-colour mode
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        int palette[4][3];
+        unpackColor565(color0, palette[0]);
+        unpackColor565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestError = INT_MAX;
+            for (int p = 0; p < 4; p++) {
+                int error = 0;
+                for (int c = 0; c < 3; c++) {
+                    int d = texels[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= uint32_t(best) << (i * 2);
+        }
+    }
+
+    std::memcpy(out, &color0, 2);
+    std::memcpy(out + 2, &color1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+void TextureCooker::encodeAlphaBlock(const unsigned char* texels, unsigned char* out) {
+    int alpha0 = 0, alpha1 = 255;
+    for (int i = 0; i < 16; i++) {
+        alpha0 = std::max(alpha0, int(texels[i * 4 + 3]));
+        alpha1 = std::min(alpha1, int(texels[i * 4 + 3]));
+    }
+
+    // alpha0 > alpha1 selects eight interpolated values
+    uint64_t indices = 0;
+    if (alpha0 != alpha1) {
+        int palette[8];
+        palette[0] = alpha0;
+        palette[1] = alpha1;
+        for (int p = 2; p < 8; p++) {
+            palette[p] = ((8 - p) * alpha0 + (p - 1) * alpha1) / 7;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestError = 256;
+            for (int p = 0; p < 8; p++) {
+                int error = std::abs(texels[i * 4 + 3] - palette[p]);
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= uint64_t(best) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(alpha0);
+    out[1] = static_cast<unsigned char>(alpha1);
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+    }
+}
+
+bool TextureCooker::writeKtx2(const std::string& path, const DecodedImage& image) {
+    bool bc3 = image.compressedFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    uint32_t levelCount = static_cast<uint32_t>(image.getLevelCount());
+    size_t blockBytes = blockBytesFor(image.compressedFormat);
+
+    // Data format descriptor: one block-compressed sample (BC1) or alpha + colour (BC3)
+    uint32_t sampleCount = bc3 ? 2 : 1;
+    uint32_t blockSize = 24 + 16 * sampleCount;
+    size_t dfdOffset = KTX2_HEADER_SIZE + KTX2_LEVEL_ENTRY_SIZE * levelCount;
+    size_t dfdSize = 4 + blockSize;
+
+    // Levels are stored smallest first, each aligned to the block size
+    size_t dataOffset = (dfdOffset + dfdSize + blockBytes - 1) / blockBytes * blockBytes;
+    std::vector<size_t> levelFileOffsets(levelCount);
+    size_t fileSize = dataOffset;
+    for (int level = static_cast<int>(levelCount) - 1; level >= 0; level--) {
+        fileSize = (fileSize + blockBytes - 1) / blockBytes * blockBytes;
+        levelFileOffsets[level] = fileSize;
+        fileSize += image.getLevelSize(level);
+    }
+
+    std::vector<unsigned char> file(fileSize, 0);
+    std::memcpy(file.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    put32(file, 12, bc3 ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK);
+    put32(file, 16, 1);                     // typeSize
+    put32(file, 20, image.width);
+    put32(file, 24, image.height);
+    put32(file, 28, 0);                     // pixelDepth
+    put32(file, 32, 0);                     // layerCount
+    put32(file, 36, 1);                     // faceCount
+    put32(file, 40, levelCount);
+    put32(file, 44, 0);                     // supercompressionScheme
+    put32(file, 48, static_cast<uint32_t>(dfdOffset));
+    put32(file, 52, static_cast<uint32_t>(dfdSize));
+    // No key/value data or supercompression global data (offsets 56 - 79 stay 0)
+
+    for (uint32_t level = 0; level < levelCount; level++) {
+        size_t entry = KTX2_HEADER_SIZE + KTX2_LEVEL_ENTRY_SIZE * level;
+        put64(file, entry, levelFileOffsets[level]);
+        put64(file, entry + 8, image.getLevelSize(level));
+        put64(file, entry + 16, image.getLevelSize(level));
+        std::memcpy(file.data() + levelFileOffsets[level], image.getLevel(level), image.getLevelSize(level));
+    }
+
+    size_t dfd = dfdOffset;
+    put32(file, dfd, static_cast<uint32_t>(dfdSize));
+    put32(file, dfd + 4, 0);                            // Khronos vendor, basic descriptor
+    put32(file, dfd + 8, 2 | (blockSize << 16));        // version 2
+    put32(file, dfd + 12, (bc3 ? 130 : 128) | (1 << 8) | (1 << 16));  // BC3/BC1 model, BT.709, linear
+    put32(file, dfd + 16, 3 | (3 << 8));                // 4x4 texel blocks
+    put32(file, dfd + 20, static_cast<uint32_t>(blockBytes));
+    put32(file, dfd + 24, 0);
+
+    size_t sample = dfd + 28;
+    if (bc3) {
+        put32(file, sample, 0 | (63 << 16) | (15u << 24));     // alpha, bits 0-63
+        put32(file, sample + 12, 0xFFFFFFFFu);
+        sample += 16;
+    }
+    put32(file, sample, (bc3 ? 64 : 0) | (63 << 16));          // colour
+    put32(file, sample + 12, 0xFFFFFFFFu);
+
+    // Unique per thread, since two models may cook the same texture at once
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cout << "Could not write texture cache: " << path << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(file.data()), file.size());
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<DecodedImage> TextureCooker::readKtx2(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return nullptr;
+    }
+    std::streamsize size = in.tellg();
+    if (size < static_cast<std::streamsize>(KTX2_HEADER_SIZE)) {
+        return nullptr;
+    }
+    std::vector<unsigned char> file(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(file.data()), size)) {
+        return nullptr;
+    }
+
+    if (std::memcmp(file.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        return nullptr;
+    }
+
+    uint32_t vkFormat = get32(file, 12);
+    uint32_t width = get32(file, 20);
+    uint32_t height = get32(file, 24);
+    uint32_t levelCount = get32(file, 40);
+    bool supported = (vkFormat == VK_FORMAT_BC1_RGB_UNORM_BLOCK || vkFormat == VK_FORMAT_BC3_UNORM_BLOCK) &&
+        get32(file, 28) == 0 && get32(file, 32) == 0 && get32(file, 36) == 1 && get32(file, 44) == 0;
+    if (!supported || width == 0 || height == 0 || levelCount == 0 || levelCount > 32 ||
+        KTX2_HEADER_SIZE + KTX2_LEVEL_ENTRY_SIZE * levelCount > file.size()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+    image->width = static_cast<int>(width);
+    image->height = static_cast<int>(height);
+    image->components = (vkFormat == VK_FORMAT_BC3_UNORM_BLOCK) ? 4 : 3;
+    image->compressedFormat = (vkFormat == VK_FORMAT_BC3_UNORM_BLOCK)
+        ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    size_t blockBytes = blockBytesFor(image->compressedFormat);
+
+    for (uint32_t level = 0; level < levelCount; level++) {
+        size_t entry = KTX2_HEADER_SIZE + KTX2_LEVEL_ENTRY_SIZE * level;
+        uint64_t offset = get64(file, entry);
+        uint64_t length = get64(file, entry + 8);
+        if (length != levelBytes(image->getLevelWidth(level), image->getLevelHeight(level), blockBytes) ||
+            offset > file.size() || length > file.size() - offset) {
+            return nullptr;
+        }
+
+        image->levelOffsets.push_back(image->data.size());
+        image->data.insert(image->data.end(), file.begin() + offset, file.begin() + offset + length);
+    }
+
+    image->contentHash = TextureCache::hashPixels(image->getLevel(0), image->getLevelSize(0),
+        image->width, image->height, image->compressedFormat);
+    return image;
+}
\ No newline at end of file
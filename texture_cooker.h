@@ -0,0 +1,34 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "texture_loader.h"
+
+// Block-compressed texture cache written next to the source image
+// ("car/0000.BMP" -> "car/0000.BMP.ktx2").
+//
+// A colour image with a matching "-a" mask beside it ("0000.BMP" +
+// "0000-a.BMP") is merged into one RGBA image first. Images with alpha are
+// encoded as BC3 (DXT5), opaque ones as BC1 (DXT1), each with a full
+// box-filtered mip chain, so at runtime the blocks only have to be copied to
+// the GPU. The .ktx2 is rebuilt whenever it is older than either source file.
+class TextureCooker {
+public:
+    // Any thread. Cooked image for this source, cooking and caching it first if
+    // needed. Returns null if the image can't be read or block-compressed
+    // (dimensions not a multiple of 4); the caller then decodes it raw.
+    static std::shared_ptr<const DecodedImage> loadOrCook(const std::string& sourcePath);
+
+    static std::string cachePathFor(const std::string& sourcePath);
+
+    // "dir/0000.BMP" -> "dir/0000-a.BMP" if that file exists, otherwise empty
+    static std::string alphaMaskPathFor(const std::string& sourcePath);
+
+private:
+    static std::shared_ptr<DecodedImage> cook(const std::string& sourcePath, const std::string& maskPath);
+    static std::shared_ptr<DecodedImage> readKtx2(const std::string& path);
+    static bool writeKtx2(const std::string& path, const DecodedImage& image);
+
+    // One 4x4 block of RGBA8 texels in, 8 bytes of BC1 colour / BC3 alpha out
+    static void encodeColorBlock(const unsigned char* texels, unsigned char* out);
+    static void encodeAlphaBlock(const unsigned char* texels, unsigned char* out);
+};
\ No newline at end of file
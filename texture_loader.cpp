@@ -0,0 +1,391 @@
+#include "texture_loader.h"
+#include "texture_cache.h"
+#include "texture_cooker.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "stb_image.h"
+
+namespace {
+    std::mutex jobMutex;
+    std::condition_variable jobCondition;
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    // Render thread only
+    std::vector<std::shared_ptr<TextureRequest>> requests;
+
+    // Persistently mapped ring of pixel-unpack memory. Each upload takes the
+    // next free range and fences it; a range is reused once its fence signals.
+    const GLsizeiptr STAGING_SIZE = 32 * 1024 * 1024;
+
+    struct StagingRange {
+        GLsizeiptr begin;
+        GLsync fence;
+    };
+
+    GLuint stagingBuffer = 0;
+    unsigned char* stagingMemory = nullptr;
+    GLsizeiptr stagingHead = 0;
+    std::deque<StagingRange> stagingRanges;
+
+    bool createStaging() {
+        glGenBuffers(1, &stagingBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, STAGING_SIZE, nullptr, flags);
+        stagingMemory = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, STAGING_SIZE, flags));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (!stagingMemory) {
+            std::cout << "Texture staging buffer unavailable, uploading directly" << std::endl;
+            glDeleteBuffers(1, &stagingBuffer);
+            stagingBuffer = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void retireStaging(bool wait) {
+        while (!stagingRanges.empty()) {
+            GLenum result = glClientWaitSync(stagingRanges.front().fence,
+                wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return;
+            }
+            glDeleteSync(stagingRanges.front().fence);
+            stagingRanges.pop_front();
+            if (wait) {
+                return;
+            }
+        }
+    }
+
+    // Offset of a free range of this size, or -1 if the image has to go up directly
+    GLsizeiptr allocateStaging(size_t bytes) {
+        GLsizeiptr size = (static_cast<GLsizeiptr>(bytes) + 15) & ~GLsizeiptr(15);
+        if (size > STAGING_SIZE || (!stagingMemory && !createStaging())) {
+            return -1;
+        }
+
+        while (true) {
+            retireStaging(false);
+            if (stagingRanges.empty()) {
+                stagingHead = 0;
+            }
+
+            GLsizeiptr offset = -1;
+            if (stagingRanges.empty()) {
+                offset = 0;
+            }
+            else {
+                GLsizeiptr tail = stagingRanges.front().begin;
+                if (stagingHead > tail) {
+                    if (stagingHead + size <= STAGING_SIZE) offset = stagingHead;
+                    else if (size <= tail) offset = 0;
+                }
+                else if (stagingHead < tail && stagingHead + size <= tail) {
+                    offset = stagingHead;
+                }
+            }
+
+            if (offset >= 0) {
+                stagingHead = offset + size;
+                return offset;
+            }
+
+            // Ring is full: the oldest upload has to finish first
+            retireStaging(true);
+        }
+    }
+
+    void destroyStaging() {
+        for (auto& range : stagingRanges) {
+            glDeleteSync(range.fence);
+        }
+        stagingRanges.clear();
+
+        if (stagingBuffer) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &stagingBuffer);
+        }
+        stagingBuffer = 0;
+        stagingMemory = nullptr;
+        stagingHead = 0;
+    }
+}
+
+void TextureLoader::start() {
+    // Leave one core for the render thread
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int count = std::max(1u, cores - 1);
+
+    stopping = false;
+    for (unsigned int i = 0; i < count; i++) {
+        workers.emplace_back(workerLoop);
+    }
+    std::cout << "Texture decode pool: " << count << " threads" << std::endl;
+}
+
+void TextureLoader::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCondition.wait(lock, [] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+DecodeFuture TextureLoader::decode(const std::string& path, bool flip, bool generateMips) {
+    return submit([path, flip, generateMips] { return decodeNow(path, flip, generateMips); });
+}
+
+DecodeFuture TextureLoader::decodeCooked(const std::string& path) {
+    return submit([path] {
+        std::shared_ptr<const DecodedImage> image = TextureCooker::loadOrCook(path);
+        return image ? image : decodeNow(path, false, true);
+    });
+}
+
+DecodeFuture TextureLoader::submit(std::function<std::shared_ptr<const DecodedImage>()> job) {
+    auto task = std::make_shared<std::packaged_task<std::shared_ptr<const DecodedImage>()>>(std::move(job));
+    DecodeFuture future = task->get_future().share();
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if (workers.empty()) {
+            start();
+        }
+        jobs.push_back([task] { (*task)(); });
+    }
+    jobCondition.notify_one();
+    return future;
+}
+
+std::shared_ptr<TextureRequest> TextureLoader::load(const std::string& path, bool flip) {
+    std::shared_ptr<TextureRequest> request = std::make_shared<TextureRequest>();
+    request->path = path;
+    request->image = decode(path, flip, true);
+    requests.push_back(request);
+    return request;
+}
+
+std::shared_ptr<const DecodedImage> TextureLoader::decodeNow(const std::string& path, bool flip, bool generateMips) {
+    // The flag is per thread, so loads with and without flipping can run side by side
+    stbi_set_flip_vertically_on_load_thread(flip ? 1 : 0);
+
+    int width, height, components;
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &components, 0);
+    if (!pixels) {
+        return nullptr;
+    }
+    if (components == 2) {
+        // Grey + alpha has no matching upload format here
+        stbi_image_free(pixels);
+        return nullptr;
+    }
+
+    std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+    image->path = path;
+    image->width = width;
+    image->height = height;
+    image->components = components;
+    image->levelOffsets.push_back(0);
+    image->data.assign(pixels, pixels + size_t(width) * size_t(height) * size_t(components));
+    stbi_image_free(pixels);
+
+    image->contentHash = TextureCache::hashPixels(image->data.data(), image->data.size(), width, height, components);
+
+    if (generateMips) {
+        buildMipChain(*image);
+    }
+    return image;
+}
+
+void TextureLoader::buildMipChain(DecodedImage& image) {
+    int levels = 1;
+    while ((image.width >> levels) > 0 || (image.height >> levels) > 0) {
+        levels++;
+    }
+
+    size_t total = image.data.size();
+    for (int level = 1; level < levels; level++) {
+        image.levelOffsets.push_back(total);
+        total += size_t(image.getLevelWidth(level)) * size_t(image.getLevelHeight(level)) * size_t(image.components);
+    }
+    image.data.resize(total);
+
+    // 2x2 box filter, clamping at the edge of odd-sized levels
+    const int c = image.components;
+    for (int level = 1; level < levels; level++) {
+        const unsigned char* src = image.data.data() + image.levelOffsets[level - 1];
+        unsigned char* dst = image.data.data() + image.levelOffsets[level];
+        int srcWidth = image.getLevelWidth(level - 1);
+        int srcHeight = image.getLevelHeight(level - 1);
+        int dstWidth = image.getLevelWidth(level);
+        int dstHeight = image.getLevelHeight(level);
+
+        for (int y = 0; y < dstHeight; y++) {
+            int y0 = std::min(y * 2, srcHeight - 1);
+            int y1 = std::min(y * 2 + 1, srcHeight - 1);
+            for (int x = 0; x < dstWidth; x++) {
+                int x0 = std::min(x * 2, srcWidth - 1);
+                int x1 = std::min(x * 2 + 1, srcWidth - 1);
+                for (int k = 0; k < c; k++) {
+                    unsigned int sum = src[(y0 * srcWidth + x0) * c + k] + src[(y0 * srcWidth + x1) * c + k] +
+                        src[(y1 * srcWidth + x0) * c + k] + src[(y1 * srcWidth + x1) * c + k];
+                    dst[(y * dstWidth + x) * c + k] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+unsigned int TextureLoader::upload(const DecodedImage& image) {
+    GLenum format = GL_RGBA;
+    GLenum internalFormat = GL_RGBA8;
+    if (image.compressedFormat != 0) {
+        internalFormat = image.compressedFormat;
+    }
+    else if (image.components == 1) {
+        format = GL_RED;
+        internalFormat = GL_R8;
+    }
+    else if (image.components == 3) {
+        format = GL_RGB;
+        internalFormat = GL_RGB8;
+    }
+
+    // Reserve the full chain even if only level 0 was decoded
+    int levels = 1;
+    while ((image.width >> levels) > 0 || (image.height >> levels) > 0) {
+        levels++;
+    }
+
+    unsigned int textureID = 0;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, image.width, image.height);
+
+    // Levels are tightly packed, which breaks the default 4-byte row alignment for RGB
+    GLint alignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    GLsizeiptr offset = allocateStaging(image.data.size());
+    if (offset >= 0) {
+        std::memcpy(stagingMemory + offset, image.data.data(), image.data.size());
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+    }
+
+    for (int level = 0; level < image.getLevelCount(); level++) {
+        const void* source = (offset >= 0)
+            ? reinterpret_cast<const void*>(offset + image.levelOffsets[level])
+            : image.getLevel(level);
+        if (image.compressedFormat != 0) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, image.getLevelWidth(level), image.getLevelHeight(level),
+                internalFormat, static_cast<GLsizei>(image.getLevelSize(level)), source);
+        }
+        else {
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, image.getLevelWidth(level), image.getLevelHeight(level),
+                format, GL_UNSIGNED_BYTE, source);
+        }
+    }
+
+    if (offset >= 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        StagingRange range;
+        range.begin = offset;
+        range.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        stagingRanges.push_back(range);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    if (image.getLevelCount() < levels) {
+        if (image.compressedFormat != 0) {
+            // Compressed levels can't be generated on the GPU; sample only what was cooked
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.getLevelCount() - 1);
+        }
+        else {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return textureID;
+}
+
+void TextureLoader::update(double budgetMs) {
+    retireStaging(false);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool first = true;
+
+    for (size_t i = 0; i < requests.size();) {
+        std::shared_ptr<TextureRequest> request = requests[i];
+        if (request.use_count() == 2) {
+            // Nobody else holds the request any more, so don't upload it
+            requests.erase(requests.begin() + i);
+            continue;
+        }
+        if (request->image.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            i++;
+            continue;
+        }
+
+        if (!first && std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count() >= budgetMs) {
+            return;
+        }
+        first = false;
+
+        std::shared_ptr<const DecodedImage> image = request->image.get();
+        if (image) {
+            request->texture = upload(*image);
+        }
+        else {
+            std::cout << "Failed to decode texture: " << request->path << std::endl;
+        }
+        request->done = true;
+        requests.erase(requests.begin() + i);
+    }
+}
+
+void TextureLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    jobs.clear();
+
+    requests.clear();
+    destroyStaging();
+}
\ No newline at end of file
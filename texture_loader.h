@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Image decoded on a TextureLoader worker, optionally with its whole mip chain
+// built on the CPU. Levels are tightly packed one after another, level 0 first.
+// compressedFormat is 0 for raw 8-bit pixels, otherwise the GL format of the
+// block-compressed levels (see TextureCooker).
+struct DecodedImage {
+    std::string path;
+    int width = 0;
+    int height = 0;
+    int components = 0;
+    unsigned int compressedFormat = 0;
+    std::vector<unsigned char> data;
+    std::vector<size_t> levelOffsets;
+    uint64_t contentHash = 0;   // Of level 0, see TextureCache::hashPixels
+
+    int getLevelCount() const { return static_cast<int>(levelOffsets.size()); }
+    int getLevelWidth(int level) const { return (width >> level) > 0 ? (width >> level) : 1; }
+    int getLevelHeight(int level) const { return (height >> level) > 0 ? (height >> level) : 1; }
+    const unsigned char* getLevel(int level) const { return data.data() + levelOffsets[level]; }
+    size_t getLevelSize(int level) const {
+        return (level + 1 < getLevelCount() ? levelOffsets[level + 1] : data.size()) - levelOffsets[level];
+    }
+};
+
+typedef std::shared_future<std::shared_ptr<const DecodedImage>> DecodeFuture;
+
+// A 2D texture being decoded by the pool and then uploaded by TextureLoader::update().
+// Poll isDone() on the GL thread; from then on texture belongs to the caller.
+struct TextureRequest {
+    std::string path;
+    DecodeFuture image;
+    unsigned int texture = 0;
+    bool done = false;
+
+    bool isDone() const { return done; }
+    bool hasFailed() const { return done && texture == 0; }
+};
+
+// Texture decode pool and staged uploader.
+// stbi_load, the mip chain and the content hash run on one worker per spare
+// core. Uploads copy the finished image into a persistently mapped
+// pixel-unpack ring buffer and source glTexSubImage2D from it, so the GL
+// thread never waits on file IO, decoding or glGenerateMipmap.
+class TextureLoader {
+public:
+    // Any thread: queues a decode. A null image means the file could not be read.
+    static DecodeFuture decode(const std::string& path, bool flip, bool generateMips);
+
+    // Any thread: queues TextureCooker::loadOrCook, i.e. the block-compressed
+    // .ktx2 next to the file, cooking it first if it is missing or stale.
+    // Images that can't be compressed decode as decode(path, false, true).
+    static DecodeFuture decodeCooked(const std::string& path);
+
+    // GL thread: decode plus GL_TEXTURE_2D upload (repeat, trilinear) during update()
+    static std::shared_ptr<TextureRequest> load(const std::string& path, bool flip);
+
+    // GL thread: creates an immutable texture with every level in the image
+    // (or glGenerateMipmap if it has only one) and the same sampling as load()
+    static unsigned int upload(const DecodedImage& image);
+
+    // GL thread: uploads finished load() requests until budgetMs is spent
+    static void update(double budgetMs = 2.0);
+
+    // GL thread: stops the workers and frees the staging buffer
+    static void shutdown();
+
+    // Appends levels 1..n to a raw image with a 2x2 box filter
+    static void buildMipChain(DecodedImage& image);
+
+private:
+    static void start();
+    static void workerLoop();
+    static DecodeFuture submit(std::function<std::shared_ptr<const DecodedImage>()> job);
+    static std::shared_ptr<const DecodedImage> decodeNow(const std::string& path, bool flip, bool generateMips);
+};
\ No newline at end of file
@@ -1,24 +1,27 @@
 #include "tree.h"
 #include "shader.h"
+#include "model.h"
+#include "model_cache.h"
+#include "scene.h"
+#include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 
 Tree::Tree(glm::vec3 pos, float s, glm::vec3 col)
-    : position(pos), scale(s), color(col), treeModel(nullptr) {
+    : treeModel(nullptr), position(pos), scale(s), color(col), worldBounds(pos, pos), boundsDirty(true), sceneProxy(-1) {
 }
 
 Tree::~Tree() {
-    if (treeModel) {
-        delete treeModel;
+    // treeModel is shared; the cache frees it when the last tree goes away
+    if (sceneProxy >= 0) {
+        Scene::remove(sceneProxy);
     }
 }
 
 bool Tree::loadModel(const std::string& filename) {
     try {
-        // Use Car class to load the model
-        treeModel = new Car(filename, position);
-        treeModel->SetScale(glm::vec3(scale));
-        treeModel->SetColor(color);
-        std::cout << "Tree model loaded via Car class from: " << filename << std::endl;
+        // Every tree on the street shares the same Tree.obj, streamed in the background
+        treeModel = ModelCache::acquireAsync(filename);
+        std::cout << "Tree model queued from: " << filename << std::endl;
         return true;
     }
     catch (const std::exception& e) {
@@ -29,29 +32,57 @@ bool Tree::loadModel(const std::string& filename) {
     }
 }
 
+glm::mat4 Tree::getModelMatrix() const {
+    glm::mat4 modelMat = glm::mat4(1.0f);
+    modelMat = glm::translate(modelMat, position);
+    modelMat = glm::scale(modelMat, glm::vec3(scale));
+    return modelMat;
+}
+
+int Tree::updateSceneProxy() {
+    if (boundsDirty && isReady()) {
+        worldBounds = BoundingBox(treeModel->getBoundsMin(), treeModel->getBoundsMax());
+        worldBounds.update(getModelMatrix());
+        boundsDirty = false;
+
+        if (sceneProxy < 0) {
+            sceneProxy = Scene::add(worldBounds, SCENE_TREE, this);
+        }
+        else {
+            Scene::move(sceneProxy, worldBounds);
+        }
+    }
+    return sceneProxy;
+}
+
+bool Tree::isReady() const {
+    return treeModel && treeModel->isReady();
+}
+
 void Tree::draw(Shader& shader) {
-    if (treeModel) {
-        treeModel->Draw(shader);
+    if (isReady()) {
+        glm::mat4 modelMatrix = getModelMatrix();
+        shader.setMat4("model", modelMatrix);
+        shader.setBool("useColorOverride", true);
+        shader.setVec3("colorOverride", color);
+        treeModel->Draw(shader, lod.select(*treeModel, modelMatrix));
     }
 }
 
+unsigned int Tree::selectLod() {
+    return isReady() ? lod.select(*treeModel, getModelMatrix()) : 0;
+}
+
 void Tree::setPosition(glm::vec3 pos) {
     position = pos;
-    if (treeModel) {
-        treeModel->SetPosition(pos);
-    }
+    boundsDirty = true;
 }
 
 void Tree::setScale(float s) {
     scale = s;
-    if (treeModel) {
-        treeModel->SetScale(glm::vec3(s));
-    }
+    boundsDirty = true;
 }
 
 void Tree::setColor(glm::vec3 col) {
     color = col;
-    if (treeModel) {
-        treeModel->SetColor(col);
-    }
 }
\ No newline at end of file
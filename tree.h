@@ -2,17 +2,25 @@
 #define TREE_H
 
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
-#include "car.h"  // Include car.h directly instead of forward declaration
+#include "lod_selector.h"
+#include "bounding_box.h"
 
+class Model;
 class Shader;
 
 class Tree {
 private:
-    Car* treeModel;
+    // Geometry is shared through ModelCache; everything below is per-tree
+    std::shared_ptr<Model> treeModel;
     glm::vec3 position;
     float scale;
     glm::vec3 color;
+    LodSelector lod;
+    BoundingBox worldBounds;
+    bool boundsDirty;
+    int sceneProxy;
 
 public:
     Tree(glm::vec3 pos = glm::vec3(0.0f), float s = 1.0f, glm::vec3 col = glm::vec3(0.0f, 0.5f, 0.0f));
@@ -21,18 +29,31 @@ public:
     // Load the tree model
     bool loadModel(const std::string& filename);
 
-    // Draw the tree
+    // Draw the tree (no culling here; TreeImpostors culls before drawing)
     void draw(Shader& shader);
 
+    // LOD to draw this frame at, for drawing it as part of an instanced batch
+    unsigned int selectLod();
+
     // Setters
     void setPosition(glm::vec3 pos);
     void setScale(float s);
     void setColor(glm::vec3 col);
 
     // Getters
+    const std::shared_ptr<Model>& getModel() const { return treeModel; }
+    bool isReady() const;
     glm::vec3 getPosition() const { return position; }
     float getScale() const { return scale; }
     glm::vec3 getColor() const { return color; }
+    glm::mat4 getModelMatrix() const;
+
+    // World-space box of the model
+    const BoundingBox& getWorldBounds() const { return worldBounds; }
+
+    // Recomputes the box after a move or rescale and adds or moves the tree
+    // in the Scene. Returns the Scene proxy, -1 while the model is loading.
+    int updateSceneProxy();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "tree_impostors.h"
+#include "model.h"
+#include "tree.h"
+#include "frustum_culler.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    const int IMPOSTOR_VIEWS = 8;           // Around the vertical axis
+    const int IMPOSTOR_CELL_SIZE = 256;     // Pixels per view, square
+    const float DEFAULT_IMPOSTOR_DISTANCE = 35.0f;
+}
+
+TreeImpostors::TreeImpostors()
+    : quadVAO(0), quadVBO(0), instanceVBO(0), instanceCapacity(0),
+    distance(DEFAULT_IMPOSTOR_DISTANCE), enabled(true), impostorCount(0), meshCount(0) {
+}
+
+void TreeImpostors::setup() {
+    // Unit quad around the origin, drawn as a strip
+    float corners[] = {
+        -0.5f, -0.5f,
+         0.5f, -0.5f,
+        -0.5f,  0.5f,
+         0.5f,  0.5f
+    };
+
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    // Per-tree attributes, refilled every frame
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, center));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, size));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, tint));
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TreeImpostors::cleanup() {
+    for (auto& variant : variants) {
+        if (variant.atlas) {
+            glDeleteTextures(1, &variant.atlas);
+        }
+        variant.meshBatch.cleanup();
+    }
+    variants.clear();
+    bakeLight.cleanup();
+
+    if (quadVAO) {
+        glDeleteVertexArrays(1, &quadVAO);
+        glDeleteBuffers(1, &quadVBO);
+        glDeleteBuffers(1, &instanceVBO);
+        quadVAO = quadVBO = instanceVBO = 0;
+    }
+    instanceCapacity = 0;
+}
+
+void TreeImpostors::setDistance(float newDistance) {
+    distance = std::max(newDistance, 0.0f);
+}
+
+TreeImpostors::Variant* TreeImpostors::findVariant(const Model* model) {
+    for (auto& variant : variants) {
+        if (variant.model.get() == model) {
+            return &variant;
+        }
+    }
+    return nullptr;
+}
+
+void TreeImpostors::bake(const std::vector<Tree*>& trees, Shader& lightingShader) {
+    for (const Tree* tree : trees) {
+        if (!tree->isReady() || findVariant(tree->getModel().get())) {
+            continue;
+        }
+
+        // A failed bake still gets an entry (without an atlas) so it isn't
+        // retried every frame; those trees just stay meshes
+        Variant variant;
+        variant.model = tree->getModel();
+        bakeVariant(variant, lightingShader);
+        variants.push_back(variant);
+    }
+}
+
+bool TreeImpostors::bakeVariant(Variant& variant, Shader& lightingShader) {
+    Model& model = *variant.model;
+    glm::vec3 boundsMin = model.getBoundsMin();
+    glm::vec3 boundsMax = model.getBoundsMax();
+    glm::vec3 extent = boundsMax - boundsMin;
+
+    // Square quad that covers the tree from every horizontal direction
+    variant.center = (boundsMin + boundsMax) * 0.5f;
+    float horizontalDiameter = std::sqrt(extent.x * extent.x + extent.z * extent.z);
+    variant.size = std::max(horizontalDiameter, extent.y);
+    if (variant.size <= 0.0f) {
+        return false;
+    }
+
+    int atlasWidth = IMPOSTOR_CELL_SIZE * IMPOSTOR_VIEWS;
+    int levels = 1 + static_cast<int>(std::floor(std::log2(static_cast<float>(IMPOSTOR_CELL_SIZE))));
+
+    glGenTextures(1, &variant.atlas);
+    glBindTexture(GL_TEXTURE_2D, variant.atlas);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, atlasWidth, IMPOSTOR_CELL_SIZE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    unsigned int depthBuffer, framebuffer;
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, atlasWidth, IMPOSTOR_CELL_SIZE);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, variant.atlas, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (complete) {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        // Alpha 0 marks the background; the tree writes alpha 1
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Baked white under one light straight above, so the instances can be
+        // tinted with their own colour and every view is lit the same way
+        float half = variant.size * 0.5f;
+        float cameraDistance = variant.size * 2.0f;
+        glm::vec3 lightPosition = variant.center + glm::vec3(0.0f, variant.size * 100.0f, 0.0f);
+
+        lightingShader.use();
+        lightingShader.setMat4("projection", glm::ortho(-half, half, -half, half,
+            cameraDistance - variant.size, cameraDistance + variant.size));
+        lightingShader.setMat4("model", glm::mat4(1.0f));
+        lightingShader.setBool("useColorOverride", true);
+        lightingShader.setVec3("colorOverride", glm::vec3(1.0f));
+        GpuLight light = LightBuffer::pointLight(lightPosition, glm::vec3(1.0f));
+        light.specular = 0.0f;
+        light.linear = 0.0f;
+        light.quadratic = 0.0f;
+        bakeLight.setCount(1);
+        bakeLight.setLight(0, light);
+        bakeLight.upload();
+        bakeLight.bind();
+        lightingShader.setBool("clusteredLighting", false);
+
+        for (int v = 0; v < IMPOSTOR_VIEWS; v++) {
+            // View v looks at the tree from angle v * 360 / IMPOSTOR_VIEWS about +Y, starting at +Z
+            float angle = glm::radians(360.0f * v / IMPOSTOR_VIEWS);
+            glm::vec3 direction(std::sin(angle), 0.0f, std::cos(angle));
+            glm::vec3 eye = variant.center + direction * cameraDistance;
+
+            glViewport(v * IMPOSTOR_CELL_SIZE, 0, IMPOSTOR_CELL_SIZE, IMPOSTOR_CELL_SIZE);
+            lightingShader.setMat4("view", glm::lookAt(eye, variant.center, glm::vec3(0.0f, 1.0f, 0.0f)));
+            lightingShader.setVec3("viewPos", eye);
+            model.Draw(lightingShader, 0);
+        }
+
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+
+    if (!complete) {
+        std::cout << "Impostor framebuffer incomplete, drawing " << model.getPath() << " as meshes" << std::endl;
+        glDeleteTextures(1, &variant.atlas);
+        variant.atlas = 0;
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, variant.atlas);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::cout << "Tree impostor baked: " << model.getPath() << " (" << IMPOSTOR_VIEWS << " views, "
+        << atlasWidth << "x" << IMPOSTOR_CELL_SIZE << ")" << std::endl;
+    return true;
+}
+
+void TreeImpostors::draw(const std::vector<Tree*>& trees, Shader& lightingShader, Shader& impostorShader,
+    const glm::vec3& cameraPos, const glm::mat4& view, const glm::mat4& projection) {
+    impostorCount = 0;
+    meshCount = 0;
+    for (auto& variant : variants) {
+        variant.instances.clear();
+        for (auto& lodInstances : variant.meshInstances) {
+            lodInstances.clear();
+        }
+    }
+
+    for (Tree* tree : trees) {
+        if (!tree->isReady() || !FrustumCuller::isVisible(tree->updateSceneProxy())) {
+            continue;
+        }
+
+        Variant* variant = findVariant(tree->getModel().get());
+        if (enabled && variant && variant->atlas) {
+            glm::vec3 center = tree->getPosition() + variant->center * tree->getScale();
+            if (glm::length(center - cameraPos) > distance) {
+                variant->instances.push_back({ center, variant->size * tree->getScale(), tree->getColor() });
+                impostorCount++;
+                continue;
+            }
+        }
+
+        meshCount++;
+        if (!variant) {
+            // Not baked yet (bake() runs before draw, so only for a tree that
+            // finished loading in between)
+            tree->draw(lightingShader);
+            continue;
+        }
+        unsigned int lod = std::min(tree->selectLod(), MAX_LOD_LEVELS - 1);
+        variant->meshInstances[lod].push_back({ tree->getModelMatrix(), glm::vec4(tree->getColor(), 1.0f) });
+    }
+
+    for (auto& variant : variants) {
+        unsigned int lodInstanceCounts[MAX_LOD_LEVELS];
+        variant.meshInstanceData.clear();
+        for (unsigned int l = 0; l < MAX_LOD_LEVELS; l++) {
+            lodInstanceCounts[l] = static_cast<unsigned int>(variant.meshInstances[l].size());
+            variant.meshInstanceData.insert(variant.meshInstanceData.end(),
+                variant.meshInstances[l].begin(), variant.meshInstances[l].end());
+        }
+        if (variant.meshInstanceData.empty()) {
+            continue;
+        }
+        variant.meshBatch.update(variant.meshInstanceData);
+        variant.model->DrawInstanced(lightingShader, variant.meshBatch.getBuffer(), lodInstanceCounts);
+    }
+
+    if (impostorCount == 0) {
+        return;
+    }
+
+    impostorShader.use();
+    impostorShader.setMat4("projection", projection);
+    impostorShader.setMat4("view", view);
+    impostorShader.setVec3("cameraPos", cameraPos);
+    impostorShader.setInt("viewCount", IMPOSTOR_VIEWS);
+    impostorShader.setInt("atlas", 0);
+
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glActiveTexture(GL_TEXTURE0);
+
+    for (const auto& variant : variants) {
+        if (variant.instances.empty()) {
+            continue;
+        }
+
+        // Orphan and refill; the buffer only grows
+        size_t bytes = variant.instances.size() * sizeof(Instance);
+        if (bytes > instanceCapacity) {
+            instanceCapacity = bytes * 2;
+        }
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, variant.instances.data());
+
+        glBindTexture(GL_TEXTURE_2D, variant.atlas);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(variant.instances.size()));
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
\ No newline at end of file
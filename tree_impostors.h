@@ -0,0 +1,78 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "shader.h"
+#include "instance_batch.h"
+#include "light_buffer.h"
+#include "model.h"
+
+class Tree;
+
+// Far-away trees as camera-facing quads.
+// Each tree model is rendered once from IMPOSTOR_VIEWS directions around its
+// vertical axis into an atlas. Trees beyond the impostor distance then become
+// instanced quads that turn about Y towards the camera and show the atlas
+// view baked closest to the camera direction, so the whole far vegetation is
+// one draw per tree model however long the street gets. The near trees of a
+// model are one instanced mesh draw as well.
+class TreeImpostors {
+public:
+    TreeImpostors();
+    void setup();
+    void cleanup();
+
+    // Bakes the atlas for every tree model that has finished loading and has
+    // none yet. Draws with lightingShader and overwrites its camera uniforms and
+    // the LightBlock binding, so call it before they are set for the frame.
+    void bake(const std::vector<Tree*>& trees, Shader& lightingShader);
+
+    // Near trees draw their mesh through lightingShader, the rest are impostors;
+    // either way it's one draw per tree model and texture set
+    void draw(const std::vector<Tree*>& trees, Shader& lightingShader, Shader& impostorShader,
+        const glm::vec3& cameraPos, const glm::mat4& view, const glm::mat4& projection);
+
+    void setDistance(float distance);
+    float getDistance() const { return distance; }
+    void setEnabled(bool enable) { enabled = enable; }
+    bool isEnabled() const { return enabled; }
+
+    // Of the trees drawn last frame
+    size_t getImpostorCount() const { return impostorCount; }
+    size_t getMeshCount() const { return meshCount; }
+
+private:
+    struct Instance {
+        glm::vec3 center;
+        float size;
+        glm::vec3 tint;
+    };
+
+    // One per tree model
+    struct Variant {
+        std::shared_ptr<Model> model;
+        unsigned int atlas = 0;
+        glm::vec3 center = glm::vec3(0.0f);    // Of the quad, object space
+        float size = 0.0f;                      // Quad side, object space
+        std::vector<Instance> instances;
+
+        // Near trees, sorted by LOD. The buffer only changes when one of them
+        // moves, changes LOD or crosses the impostor distance.
+        std::vector<InstanceData> meshInstances[MAX_LOD_LEVELS];
+        std::vector<InstanceData> meshInstanceData;
+        InstanceBatch meshBatch;
+    };
+
+    std::vector<Variant> variants;
+    LightBuffer bakeLight;      // One white light straight above the tree
+    unsigned int quadVAO, quadVBO, instanceVBO;
+    size_t instanceCapacity;
+    float distance;
+    bool enabled;
+    size_t impostorCount;
+    size_t meshCount;
+
+    Variant* findVariant(const Model* model);
+    bool bakeVariant(Variant& variant, Shader& lightingShader);
+};
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "wall_tessellator.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // Slabs and gaps thinner than this are dropped
+    const float WALL_EPSILON = 1e-4f;
+
+    WallTessellator::Rect transpose(const WallTessellator::Rect& rect) {
+        return { rect.minY, rect.minX, rect.maxY, rect.maxX };
+    }
+}
+
+void WallTessellator::Stats::add(const Stats& other) {
+    walls += other.walls;
+    openings += other.openings;
+    quads += other.quads;
+    solidArea += other.solidArea;
+    drawnArea += other.drawnArea;
+    stripQuads += other.stripQuads;
+    stripArea += other.stripArea;
+}
+
+std::vector<WallTessellator::Rect> WallTessellator::tessellate(const Rect& wall,
+    const std::vector<Rect>& openings, Stats* stats) {
+    std::vector<Rect> clipped;
+    for (const auto& opening : openings) {
+        Rect rect = {
+            std::max(opening.minX, wall.minX), std::max(opening.minY, wall.minY),
+            std::min(opening.maxX, wall.maxX), std::min(opening.maxY, wall.maxY)
+        };
+        if (rect.maxX - rect.minX > WALL_EPSILON && rect.maxY - rect.minY > WALL_EPSILON) {
+            clipped.push_back(rect);
+        }
+    }
+
+    float openArea = 0.0f;
+    std::vector<Rect> columns = tessellateColumns(wall, clipped, &openArea);
+
+    std::vector<Rect> transposed;
+    for (const auto& rect : clipped) {
+        transposed.push_back(transpose(rect));
+    }
+    std::vector<Rect> rows = tessellateColumns(transpose(wall), transposed, nullptr);
+    for (auto& rect : rows) {
+        rect = transpose(rect);
+    }
+
+    std::vector<Rect>& result = rows.size() < columns.size() ? rows : columns;
+
+    if (stats) {
+        Stats wallStats;
+        wallStats.walls = 1;
+        wallStats.openings = clipped.size();
+        wallStats.quads = result.size();
+        wallStats.solidArea = wall.getArea() - openArea;
+        for (const auto& rect : result) {
+            wallStats.drawnArea += rect.getArea();
+        }
+
+        float width = wall.maxX - wall.minX;
+        if (clipped.empty()) {
+            wallStats.stripQuads = 1;
+            wallStats.stripArea = wall.getArea();
+        }
+        for (const auto& rect : clipped) {
+            float height = rect.maxY - rect.minY;
+            float pieces[4] = {
+                width * (wall.maxY - rect.maxY), width * (rect.minY - wall.minY),
+                (rect.minX - wall.minX) * height, (wall.maxX - rect.maxX) * height
+            };
+            for (float area : pieces) {
+                if (area > WALL_EPSILON) {
+                    wallStats.stripQuads++;
+                    wallStats.stripArea += area;
+                }
+            }
+        }
+        stats->add(wallStats);
+    }
+
+    return std::move(result);
+}
+
+std::vector<WallTessellator::Rect> WallTessellator::tessellateColumns(const Rect& wall,
+    const std::vector<Rect>& openings, float* openArea) {
+    std::vector<float> cuts = { wall.minX, wall.maxX };
+    for (const auto& opening : openings) {
+        cuts.push_back(opening.minX);
+        cuts.push_back(opening.maxX);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    std::vector<Rect> result;
+    std::vector<size_t> open;       // Quads that reach the current slab's left edge
+    std::vector<size_t> nextOpen;
+    std::vector<std::pair<float, float>> holes;
+
+    for (size_t c = 0; c + 1 < cuts.size(); c++) {
+        float x0 = cuts[c];
+        float x1 = cuts[c + 1];
+        if (x1 - x0 <= WALL_EPSILON) {
+            continue;
+        }
+
+        // Openings spanning this slab, as sorted y intervals
+        holes.clear();
+        for (const auto& opening : openings) {
+            if (opening.minX <= x0 && opening.maxX >= x1) {
+                holes.push_back({ opening.minY, opening.maxY });
+            }
+        }
+        std::sort(holes.begin(), holes.end());
+
+        // Walk up the slab; every gap between holes is solid wall
+        nextOpen.clear();
+        float y = wall.minY;
+        for (size_t h = 0; h <= holes.size(); h++) {
+            float top = h < holes.size() ? holes[h].first : wall.maxY;
+            if (top - y > WALL_EPSILON) {
+                // Extend the quad from the previous slab if it has the same extent
+                bool merged = false;
+                for (size_t index : open) {
+                    if (result[index].minY == y && result[index].maxY == top) {
+                        result[index].maxX = x1;
+                        nextOpen.push_back(index);
+                        merged = true;
+                        break;
+                    }
+                }
+                if (!merged) {
+                    result.push_back({ x0, y, x1, top });
+                    nextOpen.push_back(result.size() - 1);
+                }
+            }
+            if (h < holes.size()) {
+                if (openArea) {
+                    float holeBottom = std::max(holes[h].first, y);
+                    if (holes[h].second > holeBottom) {
+                        *openArea += (x1 - x0) * (holes[h].second - holeBottom);
+                    }
+                }
+                y = std::max(y, holes[h].second);
+            }
+        }
+        open.swap(nextOpen);
+    }
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Splits a flat wall with rectangular openings (windows, doors, arches) into
+// non-overlapping quads, in the wall's own 2D coordinates. The solid area is
+// cut into slabs at every opening edge and neighbouring slabs with the same
+// extent are merged; columns and rows are both tried and the one needing
+// fewer quads wins.
+class WallTessellator {
+public:
+    struct Rect {
+        float minX, minY, maxX, maxY;
+
+        float getArea() const { return (maxX - minX) * (maxY - minY); }
+    };
+
+    struct Stats {
+        size_t walls = 0;
+        size_t openings = 0;
+        size_t quads = 0;
+        float solidArea = 0.0f;     // Wall minus the union of its openings
+        float drawnArea = 0.0f;     // Summed quad area
+        // The old per-opening layout: full-width strips above and below plus
+        // the pieces left and right of every opening
+        size_t stripQuads = 0;
+        float stripArea = 0.0f;
+
+        size_t getVertices() const { return quads * 4; }
+        size_t getStripVertices() const { return stripQuads * 4; }
+        float getOverdraw() const { return solidArea > 0.0f ? drawnArea / solidArea : 0.0f; }
+        float getStripOverdraw() const { return solidArea > 0.0f ? stripArea / solidArea : 0.0f; }
+
+        void add(const Stats& other);
+    };
+
+    // Openings are clipped to the wall and may overlap each other
+    static std::vector<Rect> tessellate(const Rect& wall, const std::vector<Rect>& openings,
+        Stats* stats = nullptr);
+
+private:
+    // Vertical slabs; rows are columns of the transposed wall
+    static std::vector<Rect> tessellateColumns(const Rect& wall, const std::vector<Rect>& openings,
+        float* openArea);
+};
\ No newline at end of file